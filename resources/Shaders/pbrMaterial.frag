@@ -40,20 +40,33 @@ const int roughnessTexture = 2;
 const int transmissionColorTexture = 3;
 const int emissionColorTexture = 4;
 
-const int pointLightCount = 1;
-
 // == UNIFORMS ==
 
 uniform sampler2D uTextures[5];
 
 struct PointLight
 {
-    vec3 position;
-    vec3 color;
+    vec3  position;
     float decay;
+    vec3  color;
+    float radius;
+};
+
+layout(std430, binding = 1) readonly buffer PointLights
+{
+    PointLight uPointLights[];
 };
 
-uniform PointLight uPointLights[pointLightCount];
+// Lights binned in a grid of clusters on the XZ plane, uClusterData holds an (offset, count)
+// pair per cluster, pointing to the light indices stored at the end of the same array
+layout(std430, binding = 2) readonly buffer LightClusters
+{
+    vec2  uClusterOrigin;
+    float uClusterSize;
+    uint  uLightCount;
+    uvec2 uClusterCount;
+    uint  uClusterData[];
+};
 
 
 // == OUTPUTS ==
@@ -117,6 +130,28 @@ MaterialSample SampleMaterial()
     );
 }
 
+// == LIGHTING FUNCTIONS ==
+
+// Returns the range of uClusterData holding the indices of the lights reaching the given position
+uvec2 LightClusterRange(vec3 pos)
+{
+    ivec2 cluster = ivec2(floor((pos.xz - uClusterOrigin) / uClusterSize));
+    if (any(lessThan(cluster, ivec2(0))) || any(greaterThanEqual(cluster, ivec2(uClusterCount)))) {
+        return uvec2(0);
+    }
+
+    uint index = (uint(cluster.y) * uClusterCount.x + uint(cluster.x)) * 2;
+    return uvec2(uClusterData[index], uClusterData[index] + uClusterData[index + 1]);
+}
+
+// Smoothly brings the light contribution to zero at its radius to avoid seams between clusters
+float LightWindow(float lightDistance, float radius)
+{
+    float ratio = lightDistance / max(radius, 0.0001);
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window;
+}
+
 // == BRDF UTILS FUNCTIONS ==
 
 // Trowbridge-Reitz (GGX) normal distribution function - 1975/2007
@@ -197,14 +232,16 @@ void main()
     MaterialSample matSample = SampleMaterial();
 
     vec3 Lo = vec3(0.0);
-    for (int i=0 ; i < pointLightCount ; i++) {
-        PointLight light = uPointLights[i];
+    uvec2 lightRange = LightClusterRange(vWorldPos);
+    for (uint i=lightRange.x ; i < lightRange.y ; i++) {
+        PointLight light = uPointLights[uClusterData[i]];
 
         // Sampling the point light
         vec3 vertexToLight = light.position - vWorldPos;
         float lightDistance = length(vertexToLight);
         vertexToLight /= lightDistance;
         vec3 lightRadiance = light.color / pow(lightDistance + 1.0, light.decay);
+        lightRadiance *= LightWindow(lightDistance, light.radius);
 
         // Computing the BRDF and adding its result to the illumination
         Lo += BRDF_CookTorrance_Microfacet(vertexToLight, vVertexToCam, normal, matSample, lightRadiance);
@@ -27,13 +27,27 @@ uniform float uTime = 0.0;
 
 struct PointLight
 {
-    vec3 position;
-    vec3 color;
+    vec3  position;
     float decay;
+    vec3  color;
+    float radius;
 };
 
-const int pointLightCount = 1;
-uniform PointLight uPointLights[pointLightCount];
+layout(std430, binding = 1) readonly buffer PointLights
+{
+    PointLight uPointLights[];
+};
+
+// Lights binned in a grid of clusters on the XZ plane, uClusterData holds an (offset, count)
+// pair per cluster, pointing to the light indices stored at the end of the same array
+layout(std430, binding = 2) readonly buffer LightClusters
+{
+    vec2  uClusterOrigin;
+    float uClusterSize;
+    uint  uLightCount;
+    uvec2 uClusterCount;
+    uint  uClusterData[];
+};
 
 // == OUTPUTS ==
 
@@ -46,6 +60,28 @@ const int surfaceColorTexture = 0;
 const int deepColorTexture = 1;
 
 
+// == LIGHTING FUNCTIONS ==
+
+// Returns the range of uClusterData holding the indices of the lights reaching the given position
+uvec2 LightClusterRange(vec3 pos)
+{
+    ivec2 cluster = ivec2(floor((pos.xz - uClusterOrigin) / uClusterSize));
+    if (any(lessThan(cluster, ivec2(0))) || any(greaterThanEqual(cluster, ivec2(uClusterCount)))) {
+        return uvec2(0);
+    }
+
+    uint index = (uint(cluster.y) * uClusterCount.x + uint(cluster.x)) * 2;
+    return uvec2(uClusterData[index], uClusterData[index] + uClusterData[index + 1]);
+}
+
+// Smoothly brings the light contribution to zero at its radius to avoid seams between clusters
+float LightWindow(float lightDistance, float radius)
+{
+    float ratio = lightDistance / max(radius, 0.0001);
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    return window * window;
+}
+
 // == HELPER FUNCTIONS ==
 
 vec2 RandomVec2(vec2 uv){
@@ -115,15 +151,17 @@ vec3 SampleMaterial(vec3 pos, vec3 normal)
 
     // Compute light power
     vec3 Lo = vec3(0.0);
-    for (int i=0 ; i < pointLightCount ; i++) {
-        PointLight light = uPointLights[i];
+    uvec2 lightRange = LightClusterRange(pos);
+    for (uint i=lightRange.x ; i < lightRange.y ; i++) {
+        PointLight light = uPointLights[uClusterData[i]];
 
         vec3 lightDir = light.position - pos;
         float lightDistance = length(lightDir);
         lightDir /= lightDistance;
+        float lightWindow = LightWindow(lightDistance, light.radius);
         lightDistance += 1.0; // Using (distance - 1.0) to compute the attenuation over the distance to avoid having a singularity when distance < 1.0 or clamping 
         float lightAttenuation = LightAttenuation(lightDistance, light.decay);
-        vec3 incomingLight = light.color * lightAttenuation;
+        vec3 incomingLight = light.color * lightAttenuation * lightWindow;
 
         // Compute diffuse brdf
         float absCosTheta = max(dot(lightDir, normal), 0.0);
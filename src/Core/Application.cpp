@@ -4,6 +4,8 @@
 
 #include "Scene/Entity.h"
 #include "Scene/Components/Basics.h"
+#include "Scene/ChangeJournal.h"
+#include "Scene/SceneSerializer.h"
 
 #include "Navigation/Engine.h"
 #include "Navigation/Agent.h"
@@ -13,11 +15,19 @@
 #include "Scripting/Trigger.h"
 
 #include "Renderer/Renderer.h"
+#include "Renderer/ShaderLibrary.h"
 
 #include "Resources/Model.h"
 #include "Resources/Manager.h"
+#include "Resources/Streamer.h"
+#include "Resources/Watcher.h"
 
+#include "FramePipeline.h"
+#include "InputRecording.h"
+#include "Inputs.h"
+#include "Memory.h"
 #include "Resolver.h"
+#include "JobSystem.h"
 #include "Window.h"
 #include "Event.h"
 #include "Time.h"
@@ -29,6 +39,8 @@
 #include <glm/gtx/euler_angles.hpp>
 #include <glad/glad.h>
 
+#include <cmath>
+#include <cstdlib>
 #include <sstream>
 
 
@@ -36,6 +48,8 @@ Application* Application::s_instance = nullptr;
 
 double Time::s_time = 0.0f;
 double Time::s_deltaTime = 0.0f;
+double Time::s_frameDeltaTime = 0.0f;
+float Time::s_interpolationFactor = 1.0f;
 
 Application& Application::Init(int argc, char* argv[])
 {
@@ -52,28 +66,91 @@ Application& Application::Init(int argc, char* argv[])
 
 Application::Application(int argc, char* argv[])
 {
-    if (argc != 2)
+    if (argc < 2)
     {
         LOG_ERROR("Invalid arg count, you have to pass an identifier to a json file describing a level.");
         m_exitCode = 1;
         return;
     }
 
+    // Options come before the level
+    for (int i = 1 ; i < argc - 1 ; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "--pipelined")
+        {
+            m_isPipelined = true;
+        }
+        else if (option == "--journal")
+        {
+            m_journalCapacity = s_journalCapacity;
+        }
+        else if ((option == "--record" || option == "--replay" || option == "--seed") && i + 1 < argc - 1)
+        {
+            std::string value = argv[++i];
+            if (option == "--record")
+            {
+                m_recordingPath = value;
+            }
+            else if (option == "--replay")
+            {
+                m_replay = InputRecording::Load(value);
+                if (!m_replay)
+                {
+                    m_exitCode = 1;
+                    return;
+                }
+            }
+            else
+            {
+                EntityIndex::SetUuidSeed((uint32_t)std::strtoul(value.c_str(), nullptr, 10));
+            }
+        }
+        else
+        {
+            LOG_WARNING("Unknown option %s", option.c_str());
+        }
+    }
+
+    // Replays run with the entity ids of the recording, the scripts are updated in the same order
+    if (m_replay)
+    {
+        EntityIndex::SetUuidSeed(m_replay->GetSeed());
+        LOG_INFO("Replaying %zu frames", m_replay->GetFrameCount());
+    }
+    else if (!m_recordingPath.empty())
+    {
+        m_recording = InputRecording::Create(EntityIndex::GetUuidSeed());
+    }
+
     std::string appPath = argv[0];
     Resolver& resolver = Resolver::Init(std::filesystem::canonical(appPath).remove_filename().parent_path().parent_path());
 
+    ShaderLibrary::SetCacheDirectory(resolver.GetCachePath());
+
+    JobSystem::Init();
+    ResourceStreamer::Init();
+    // Unreferenced resources are kept in cache until these are reached
+    ResourceManager::SetBudget<Texture>({ 0, 512 * 1024 * 1024 });
+    ResourceManager::SetBudget<Mesh>({ 64 * 1024 * 1024, 256 * 1024 * 1024 });
     Scripting::Engine::Init();
     Navigation::Engine::Init();
+    SceneSerializer::Init();
     
     GameManager& gameManager = GameManager::Init();
-    gameManager.SetNextLevel(argv[1]);
+    gameManager.SetNextLevel(argv[argc - 1]);
+
+#ifdef ENABLE_HOT_RELOAD
+    ResourceWatcher& watcher = ResourceWatcher::Init(resolver.GetResourcesPath());
+    watcher.AddCallback([](const std::string& identifier) { GameManager::Get().OnResourceReloaded(identifier); });
+#endif
 
     m_window = std::make_unique<Window>(WindowSettings{1280, 720, "Dungeon Master"});
 
     Renderer& renderer = Renderer::Init();
     renderer.SetClearColor(glm::vec3(0.0f, 0.0f, 0.0f));
     renderer.SetRenderBuffer(FrameBuffer::Create({ 1280, 720, 8, {GL_RGBA32F} }));
-    renderer.SetPostProcessShader(Shader::Open(resolver.Resolve("Shaders/fullScreen.vert"), 
+    renderer.SetPostProcessShader(ShaderLibrary::Open(resolver.Resolve("Shaders/fullScreen.vert"), 
                                                resolver.Resolve("Shaders/postProcess.frag")));
 
     m_scene = Scene::Create();
@@ -90,39 +167,217 @@ void Application::Run()
 
     GameManager::Get().ShowTitleScreen();
 
+    if (m_isPipelined)
+    {
+        m_simulationWorker = std::make_unique<FrameWorker>([this]() { SimulateAndExtract(); });
+    }
+
     while (m_isRunning)
     {
         Time::SetTime(m_window->GetInternalTime());
 
-        OnUpdate();
-        m_window->OnUpdate();
+        if (m_isPipelined)
+        {
+            OnPipelinedUpdate();
+        }
+        else
+        {
+            OnUpdate();
+            m_window->OnUpdate();
+        }
+
+        // Everything allocated in the frame arena is released past this point
+        Memory::EndFrame();
         
+        const MemoryStats& memoryStats = Memory::GetLastFrameStats();
         std::ostringstream titleStream;
         titleStream << std::fixed << std::setprecision(2);
-        titleStream << "Dungeon Master | " << (Time::GetDeltaTime()) * 1000 << "ms/frame";
+        titleStream << "Dungeon Master | " << (Time::GetFrameDeltaTime()) * 1000 << "ms/frame | ";
+        titleStream << memoryStats.frameBytes / 1024 << "KB in " << memoryStats.frameAllocations << " allocations/frame";
         m_window->SetTitle(titleStream.str());
     }
+
+    m_simulationWorker.reset();
+
+    if (m_recording)
+    {
+        m_recording->Save(m_recordingPath);
+    }
 }
 
 void Application::OnUpdate() 
 {
     double time = Time::GetTime();
 
+    UpdateResources();
+    Simulate();
+
+    Renderer& renderer = Renderer::Get();
+    renderer.BeginFrame();
+    renderer.ClearBuffer(0);
+    renderer.RenderScene(m_scene, m_scene->GetMainCamera());
+    renderer.BlitRenderToBuffer(0);
+    renderer.EndFrame(m_window->GetInternalTime() - time);
+}
+
+void Application::OnPipelinedUpdate()
+{
+    double time = Time::GetTime();
+
+    // The simulation thread is idle, the events and resources can safely reach the scene
+    m_window->PollEvents();
+    UpdateResources();
+
+    // Taken before starting the simulation so that every snapshot is rendered, and released here
+    RenderCommandList* snapshot = m_snapshots.AcquireLatest();
+
+    // The next frame is simulated and extracted while the previous one is rendered
+    m_simulationWorker->Kick();
+
+    Renderer& renderer = Renderer::Get();
+    renderer.BeginFrame();
+    renderer.ClearBuffer(0);
+    if (snapshot)
+    {
+        renderer.SubmitCommands(*snapshot);
+        // Dropping the resources referenced by the snapshot on the GL thread
+        snapshot->Clear();
+    }
+    renderer.BlitRenderToBuffer(0);
+    renderer.EndFrame(m_window->GetInternalTime() - time);
+    m_window->SwapBuffer();
+
+    m_simulationWorker->Wait();
+}
+
+void Application::SimulateAndExtract()
+{
+    Simulate();
+
+    RenderCommandList& snapshot = m_snapshots.GetWriteBuffer();
+    Renderer::Get().ExtractScene(m_scene, m_scene->GetMainCamera(), snapshot);
+    m_snapshots.Publish();
+}
+
+void Application::UpdateResources()
+{
+#ifdef ENABLE_HOT_RELOAD
+    ResourceWatcher::Get().OnUpdate();
+#endif
+
+    // GL work queued by the simulation and the jobs
+    JobSystem::Get().RunMainThreadJobs();
+
+    // Uploading the resources streamed in, their callbacks may switch scenes
+    ResourceStreamer::Get().OnUpdate();
+
     // Switching scenes in a safe spot to avoid unwanted accesses
     if (m_nextScene)
     {
         SwitchScenes();
     }
 
-    Navigation::Engine& navEngine = Navigation::Engine::Get();
-    navEngine.OnUpdate();
+    // Evicting the resources released by the previous frame once over budget
+    ResourceManager::OnUpdate();
+}
+
+void Application::Simulate()
+{
+    if (m_replay)
+    {
+        SimulateReplay();
+        return;
+    }
+
+    if (m_tickDuration > 0.0)
+    {
+        // Running as many fixed steps as the elapsed time covers, the remainder is carried over to the next frame
+        m_accumulator += Time::GetFrameDeltaTime();
+        uint32_t tickCount = 0;
+        while (m_accumulator >= m_tickDuration && tickCount < m_maxTicksPerFrame)
+        {
+            Time::SetDeltaTime(m_tickDuration);
+            OnTick();
+            m_accumulator -= m_tickDuration;
+            tickCount++;
+        }
+
+        // Too far behind (loading, debugger...), the simulation slows down instead of trying to catch up
+        if (m_accumulator >= m_tickDuration)
+        {
+            m_accumulator = std::fmod(m_accumulator, m_tickDuration);
+        }
+
+        Time::SetDeltaTime(Time::GetFrameDeltaTime());
+        Time::SetInterpolationFactor(m_accumulator / m_tickDuration);
+    }
+    else
+    {
+        OnTick();
+        Time::SetInterpolationFactor(1.0f);
+    }
+}
+
+void Application::SimulateReplay()
+{
+    // One recorded step per frame whatever the time the frames take, so that runs can be compared
+    while (m_replayFrame < m_replay->GetFrameCount() && m_replay->GetFrame(m_replayFrame).scene < m_sceneCount)
+    {
+        m_replayFrame++;
+    }
 
+    if (m_replayFrame >= m_replay->GetFrameCount())
+    {
+        LOG_INFO("Replay over");
+        Stop();
+        return;
+    }
+
+    // The scene of the frame is still loading, the current one runs without inputs meanwhile
+    const InputFrame& frame = m_replay->GetFrame(m_replayFrame);
+    if (frame.scene > m_sceneCount)
+    {
+        Inputs::SetState(InputState());
+    }
+    else
+    {
+        Inputs::SetState(frame.state);
+        m_replayFrame++;
+    }
+
+    Time::SetDeltaTime(frame.deltaTime);
+    OnTick();
+    Time::SetInterpolationFactor(1.0f);
+}
+
+void Application::OnTick()
+{
+    if (!m_replay)
+    {
+        Inputs::SampleState();
+        if (m_recording)
+        {
+            m_recording->AddFrame({m_sceneCount, Time::GetDeltaTime(), Inputs::GetState()});
+        }
+    }
+
+    // Keeping the state of the previous step for the renderer to interpolate from
+    Components::Transform::SavePreviousTransforms(m_scene);
+
+    Navigation::Engine::Get().OnUpdate();
     Scripting::Engine::Get().OnUpdate();
 
-    Renderer& renderer = Renderer::Get();
-    renderer.ClearBuffer(0);
-    renderer.RenderScene(m_scene, m_scene->GetMainCamera());
-    renderer.BlitRenderToBuffer(0);
+    ChangeJournal* journal = m_scene->GetJournal();
+    if (journal)
+    {
+        journal->NextTick();
+    }
+}
+
+void Application::SetTickRate(const double& tickRate)
+{
+    m_tickDuration = tickRate > 0.0 ? 1.0 / tickRate : 0.0;
+    m_accumulator = 0.0;
 }
 
 void Application::Stop()
@@ -150,10 +405,8 @@ void Application::EmitEvent(Event* event)
                 mainCamera->camera.SetAspectRatio((float)resizeEvent->GetWidth() / (float)resizeEvent->GetHeight());
             }
 
-            Renderer& renderer = Renderer::Get();
-            FrameBufferPtr renderBuffer = renderer.GetRenderBuffer();
-            renderBuffer->Resize(resizeEvent->GetWidth(), resizeEvent->GetHeight());
-            renderer.SetRenderBuffer(renderBuffer);
+            // The render buffer follows the output size, scaled by the frame budget
+            Renderer::Get().SetOutputSize(resizeEvent->GetWidth(), resizeEvent->GetHeight());
 
             break;
         }
@@ -173,10 +426,13 @@ void Application::SetMainScene(const ScenePtr& scene)
 void Application::SwitchScenes()
 {
     m_scene = m_nextScene;
+    m_sceneCount++;
+
     Scripting::Engine& engine = Scripting::Engine::Get();
     GameManager& gameManager = GameManager::Get();
     
     engine.Clear();
+    engine.SetActiveScene(m_scene.get());
     gameManager.Clear();
     
     for (const auto& entity : m_scene->Traverse())
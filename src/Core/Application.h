@@ -2,10 +2,13 @@
 #define APPLICATION_H
 
 #include "Foundations.h"
+#include "FramePipeline.h"
+#include "InputRecording.h"
 
 #include "Renderer/FrameBuffer.h"
 #include "Renderer/Camera.h"
 #include "Renderer/Shader.h"
+#include "Renderer/RenderCommands.h"
 
 #include "Scene/Scene.h"
 
@@ -30,6 +33,19 @@ public:
 
     inline int GetExitCode() const { return m_exitCode; }
 
+    // With --pipelined the simulation runs on its own thread, one frame ahead of the rendering. Anything
+    // touching GL (loading resources, releasing scenes) must then go through JobSystem::RunOnMainThread()
+    inline bool IsPipelined() const { return m_isPipelined; }
+
+    // With --journal the GameManager records the changes made to the floors from their start, rolling them back
+    // to restart them (see ChangeJournal). Returns the number of changes kept, 0 when disabled.
+    inline size_t GetJournalCapacity() const { return m_journalCapacity; }
+
+    // Simulation steps per second, 0 runs a single step per frame with a variable duration
+    void SetTickRate(const double& tickRate);
+    // Steps run at most in a frame before the simulation gives up on catching up
+    inline void SetMaxTicksPerFrame(const uint32_t& tickCount) { m_maxTicksPerFrame = tickCount; }
+
     inline Window& GetWindow() const { return *m_window; };
     double GetCurrentTime();
 
@@ -38,6 +54,17 @@ private:
     ~Application() = default;
 
     void OnUpdate();
+    void OnPipelinedUpdate();
+    void SimulateAndExtract();
+
+    // Streams resources in and out and switches scenes, the simulation must not be running
+    void UpdateResources();
+    // Runs the simulation steps covered by the frame
+    void Simulate();
+    // Runs the next step of the replay
+    void SimulateReplay();
+    // Advances the simulation (navigation, scripts) by Time::GetDeltaTime()
+    void OnTick();
     void SwitchScenes();
 
     uint32_t m_exitCode = 0;
@@ -45,6 +72,26 @@ private:
     std::unique_ptr<Window> m_window;
     bool m_isRunning;
 
+    double m_tickDuration = 1.0 / 60.0;
+    uint32_t m_maxTicksPerFrame = 5;
+    double m_accumulator = 0.0;
+
+    size_t m_journalCapacity = 0;
+    static const size_t s_journalCapacity = 1 << 16;
+
+    // With --record <file> the inputs of every step are saved when the application stops,
+    // --replay <file> runs the steps of a recording instead of reading the window
+    std::string m_recordingPath;
+    InputRecordingPtr m_recording;
+    InputRecordingPtr m_replay;
+    size_t m_replayFrame = 0;
+    uint32_t m_sceneCount = 0;
+
+    bool m_isPipelined = false;
+    std::unique_ptr<FrameWorker> m_simulationWorker;
+    // Render snapshots produced by the simulation thread
+    TripleBuffer<RenderCommandList> m_snapshots;
+
     ScenePtr m_scene;
     ScenePtr m_nextScene = nullptr;
 
@@ -0,0 +1,59 @@
+#include "FramePipeline.h"
+
+
+FrameWorker::FrameWorker(const std::function<void()>& task) :
+        m_task(task)
+{
+    m_thread = std::thread(&FrameWorker::Loop, this);
+}
+
+FrameWorker::~FrameWorker()
+{
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    m_thread.join();
+}
+
+void FrameWorker::Kick()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isRunning = true;
+    }
+    m_condition.notify_all();
+}
+
+void FrameWorker::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() { return !m_isRunning; });
+}
+
+void FrameWorker::Loop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_isRunning || m_stopping; });
+            if (m_stopping)
+            {
+                return;
+            }
+        }
+
+        m_task();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_isRunning = false;
+        }
+        m_condition.notify_all();
+    }
+}
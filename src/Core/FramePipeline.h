@@ -0,0 +1,75 @@
+#ifndef FRAMEPIPELINE_H
+#define FRAMEPIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+
+// Hands snapshots from a producer thread to a consumer thread, neither of them ever waits for the other: 
+// the producer always has a buffer to write into and the consumer reads the latest one published.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Producer side
+    inline T& GetWriteBuffer() { return m_buffers[m_writeIndex]; }
+    inline void Publish() { m_writeIndex = m_ready.exchange(m_writeIndex | s_freshBit) & s_indexMask; }
+
+    // Consumer side, returns nullptr until something has been published
+    T* AcquireLatest()
+    {
+        if (m_ready.load() & s_freshBit)
+        {
+            m_readIndex = m_ready.exchange(m_readIndex) & s_indexMask;
+            m_hasRead = true;
+        }
+
+        return m_hasRead ? &m_buffers[m_readIndex] : nullptr;
+    }
+
+private:
+    static const uint32_t s_indexMask = 0x3;
+    static const uint32_t s_freshBit = 0x4;
+
+    std::array<T, 3> m_buffers;
+    uint32_t m_writeIndex = 0;
+    uint32_t m_readIndex = 1;
+    // Index of the buffer in between, flagged when it has been published but not read yet
+    std::atomic<uint32_t> m_ready = 2;
+    bool m_hasRead = false;
+};
+
+
+// Thread running a task once per frame in parallel with the thread driving it, which starts the 
+// task with Kick() and joins it with Wait() before touching what the task works on.
+class FrameWorker
+{
+public:
+    FrameWorker(const std::function<void()>& task);
+    ~FrameWorker();
+    FrameWorker(const FrameWorker&) = delete;
+
+    void Kick();
+    void Wait();
+
+    inline std::thread::id GetThreadId() const { return m_thread.get_id(); }
+
+private:
+    void Loop();
+
+    std::function<void()> m_task;
+    std::thread m_thread;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_isRunning = false;
+    bool m_stopping = false;
+};
+
+
+#endif  // FRAMEPIPELINE_H
@@ -5,6 +5,11 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+#include <limits>
+
 
 ColorSpace GuessColorSpace(const std::string& ext) 
 {
@@ -29,6 +34,86 @@ ColorSpace GuessColorSpace(const std::string& ext)
 }
 
 
+// Simple gamma handling for the formats that can't be stored as sRGB on the GPU.
+// Further work should be achieved if we want a more advanced color system
+template <typename T>
+static void LinearizeComponents(T* data, const size_t& pixelCount, const uint32_t& channels)
+{
+    constexpr float maxValue = (float)std::numeric_limits<T>::max();
+
+    // Alpha is always linear
+    uint32_t colorChannels = (channels == 2 || channels == 4) ? channels - 1 : channels;
+    for (size_t i = 0 ; i < pixelCount ; ++i)
+    {
+        for (uint32_t c = 0 ; c < colorChannels ; ++c)
+        {
+            T& value = data[i * channels + c];
+            value = (T)std::round(std::pow(value / maxValue, 2.2f) * maxValue);
+        }
+    }
+}
+
+
+uint32_t Image::GetComponentSize(const ImageComponentType& type)
+{
+    switch (type)
+    {
+        case ImageComponentType::UInt8:    return 1;
+        case ImageComponentType::UInt16:   return 2;
+        case ImageComponentType::Float16:  return 2;
+        case ImageComponentType::Float32:  return 4;
+    }
+
+    return 0;
+}
+
+glm::vec4 Image::GetPixel(const uint32_t& x, const uint32_t& y) const
+{
+    const size_t index = ((size_t)y * m_width + x) * m_channels;
+
+    float values[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    for (uint32_t c = 0 ; c < m_channels ; ++c)
+    {
+        switch (m_componentType)
+        {
+            case ImageComponentType::UInt8:
+                values[c] = static_cast<const uint8_t*>(GetData())[index + c] / 255.0f;
+                break;
+            case ImageComponentType::UInt16:
+                values[c] = static_cast<const uint16_t*>(GetData())[index + c] / 65535.0f;
+                break;
+            case ImageComponentType::Float16:
+                values[c] = glm::unpackHalf1x16(static_cast<const uint16_t*>(GetData())[index + c]);
+                break;
+            case ImageComponentType::Float32:
+                values[c] = static_cast<const float*>(GetData())[index + c];
+                break;
+        }
+    }
+
+    switch (m_channels)
+    {
+        case 1:  return glm::vec4(values[0], values[0], values[0], 1.0f);
+        case 2:  return glm::vec4(values[0], values[0], values[0], values[1]);
+        default: return glm::vec4(values[0], values[1], values[2], values[3]);
+    }
+}
+
+ImagePtr Image::Create(const uint32_t& width, 
+                       const uint32_t& height, 
+                       const uint32_t& channels,
+                       const ImageComponentType& componentType,
+                       const ColorSpace& colorSpace)
+{
+    size_t size = (size_t)width * height * channels * GetComponentSize(componentType);
+    DataPtr data(new uint8_t[size], [](void* data) { delete[] static_cast<uint8_t*>(data); });
+
+    Image* image = new Image(width, height, channels, componentType, std::move(data));
+    image->m_colorSpace = colorSpace;
+
+    return ImagePtr(image);
+}
+
 ImagePtr Image::Read(const std::string& path, 
                      const ColorSpace& inputColorSpace) {
 
@@ -46,61 +131,57 @@ ImagePtr Image::Read(const std::string& path,
         }
     }
 
-    // Simple gamma handling based on the input colorspace of the image. 
-    // Further work should be achieved if we want a more advanced color system
-    switch (colorSpace) {
-        case ColorSpace::Raw:
-            stbi_ldr_to_hdr_gamma(1.0f);
-            break;
-        
-        case ColorSpace::sRGB:
-            stbi_ldr_to_hdr_gamma(2.2f);
-            break;
-    }
     stbi_set_flip_vertically_on_load(true); 
 
-    // Image doesn't exist, opening it
+    // Decoding the image with the stb entry point that matches its bit depth, 
+    // the decoded buffer is then owned by the Image without any copy
     int width, height, channels;
-    float *img = stbi_loadf(path.c_str(), &width, &height, &channels, 0);
-    if(img == nullptr) {
+    void* data = nullptr;
+    ImageComponentType componentType;
+    if (stbi_is_hdr(path.c_str()))
+    {
+        stbi_ldr_to_hdr_gamma(1.0f);
+        data = stbi_loadf(path.c_str(), &width, &height, &channels, 0);
+        componentType = ImageComponentType::Float32;
+        colorSpace = ColorSpace::Raw;
+    }
+    else if (stbi_is_16_bit(path.c_str()))
+    {
+        data = stbi_load_16(path.c_str(), &width, &height, &channels, 0);
+        componentType = ImageComponentType::UInt16;
+    }
+    else
+    {
+        data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+        componentType = ImageComponentType::UInt8;
+    }
+
+    if(data == nullptr) {
         LOG_ERROR("Could not read image %s...", path.c_str());
         return ImagePtr();
     }
 
-    Image* image = new Image(width, height);
-    image->m_inputColorSpace = colorSpace;
-    image->m_filePath = path;
-    glm::vec4* pixels = image->GetPixels();
-
-    switch (channels) {
-        case 4:
-        {
-            for (size_t i = 0 ; i < width * height ; i++) {
-                pixels[i] = glm::vec4(img[i * channels],
-                                      img[i * channels + 1],
-                                      img[i * channels + 2],
-                                      img[i * channels + 3]);
-            }
-            break;
-        }
+    if (channels < 1 || channels > 4)
+    {
+        LOG_ERROR("Invalid image channel count : %d", channels);
+        stbi_image_free(data);
+        return ImagePtr();
+    }
 
-        case 3:
-        {
-            for (size_t i = 0 ; i < width * height ; i++) {
-                pixels[i] = glm::vec4(img[i * channels],
-                                      img[i * channels + 1],
-                                      img[i * channels + 2],
-                                      1.0f);
-            }
-            break;
-        }
+    // Only 8 bits RGB(A) images have a matching sRGB format on the GPU, the others are converted here
+    if (colorSpace == ColorSpace::sRGB && (componentType != ImageComponentType::UInt8 || channels < 3))
+    {
+        if (componentType == ImageComponentType::UInt16)
+            LinearizeComponents(static_cast<uint16_t*>(data), (size_t)width * height, channels);
+        else
+            LinearizeComponents(static_cast<uint8_t*>(data), (size_t)width * height, channels);
 
-        default:
-            LOG_ERROR("Invalid image channel count : %d", channels);
-            return ImagePtr();
+        colorSpace = ColorSpace::Raw;
     }
 
-    stbi_image_free(img);
+    Image* image = new Image(width, height, channels, componentType, DataPtr(data, stbi_image_free));
+    image->m_colorSpace = colorSpace;
+    image->m_filePath = path;
 
     return ImagePtr(image);
 }
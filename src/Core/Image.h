@@ -29,6 +29,18 @@ enum class ColorSpace
 };
 
 
+// Type of each channel of the pixels
+enum class ImageComponentType : uint8_t
+{
+    UInt8 = 0,
+    UInt16,
+    Float16,
+    Float32
+};
+
+
+// Images keep the pixels in the layout they were decoded in (channel count and component type), 
+// without any conversion, so that they can be uploaded as is.
 class Image
 {
 public:
@@ -36,27 +48,53 @@ public:
 
     inline uint32_t GetWidth() const { return m_width; }
     inline uint32_t GetHeight() const { return m_height; }
+    inline uint32_t GetChannels() const { return m_channels; }
+    inline ImageComponentType GetComponentType() const { return m_componentType; }
+    inline ColorSpace GetColorSpace() const { return m_colorSpace; }
+    inline const std::string& GetFilePath() const { return m_filePath; }
+
+    inline uint32_t GetPixelSize() const { return m_channels * GetComponentSize(m_componentType); }
+    inline size_t GetDataSize() const { return (size_t)m_width * m_height * GetPixelSize(); }
+
+    inline const void* GetData() const { return m_data.get(); }
+    inline void* GetData() { return m_data.get(); }
 
-    inline const glm::vec4* GetPixels() const { return m_pixels.data(); }
-    inline glm::vec4* GetPixels() { return m_pixels.data(); }
+    // Normalized value of the pixel, missing channels are filled the same way OpenGL does (grey images are expanded to RGB)
+    glm::vec4 GetPixel(const uint32_t& x, const uint32_t& y) const;
 
-    inline const glm::vec4& GetPixel(const uint32_t& x, const uint32_t& y) const { return m_pixels[y * m_width + x]; }
-    inline glm::vec4 GetPixel(const uint32_t& x, const uint32_t& y) { return m_pixels[y * m_width + x]; }
+    static uint32_t GetComponentSize(const ImageComponentType& type);
 
+    static ImagePtr Create(const uint32_t& width, 
+                           const uint32_t& height, 
+                           const uint32_t& channels,
+                           const ImageComponentType& componentType,
+                           const ColorSpace& colorSpace=ColorSpace::Raw);
     static ImagePtr Read(const std::string& path, 
                          const ColorSpace& inputColorSpace=ColorSpace::None);
 
 private:
-    Image(const uint32_t& width, const uint32_t& height) : 
-            m_width(width), m_height(height), m_pixels(width * height) {}
+    typedef std::unique_ptr<void, void(*)(void*)> DataPtr;
+
+    Image(const uint32_t& width, 
+          const uint32_t& height, 
+          const uint32_t& channels, 
+          const ImageComponentType& componentType,
+          DataPtr&& data) : 
+            m_width(width), 
+            m_height(height), 
+            m_channels(channels), 
+            m_componentType(componentType),
+            m_data(std::move(data)) {}
 
     uint32_t m_width = 0;
     uint32_t m_height = 0;
-    ColorSpace m_inputColorSpace;
+    uint32_t m_channels = 0;
+    ImageComponentType m_componentType = ImageComponentType::UInt8;
+    ColorSpace m_colorSpace = ColorSpace::Raw;
     std::string m_filePath;
 
-    // TODO: This variable could be templated to fit the image channels
-    std::vector<glm::vec4> m_pixels;
+    // Owned by stb when the image has been decoded by it, hence the custom deleter
+    DataPtr m_data;
 };
 
 
@@ -0,0 +1,97 @@
+#include "InputRecording.h"
+
+#include "Logging.h"
+
+#include "Utils/FileUtils.h"
+
+#include <cstring>
+
+
+InputRecordingPtr InputRecording::Create(const uint32_t& seed)
+{
+    return InputRecordingPtr(new InputRecording(seed));
+}
+
+InputRecordingPtr InputRecording::Load(const std::string& path)
+{
+    MappedFile file;
+    if (!file.Open(path) || file.GetSize() < sizeof(RecordingHeader))
+    {
+        LOG_ERROR("Could not read the input recording %s", path.c_str());
+        return nullptr;
+    }
+
+    RecordingHeader header;
+    std::memcpy(&header, file.GetData(), sizeof(RecordingHeader));
+    if (header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION ||
+        header.frameCount > (file.GetSize() - sizeof(RecordingHeader)) / sizeof(RecordedFrame))
+    {
+        LOG_ERROR("Invalid input recording %s", path.c_str());
+        return nullptr;
+    }
+
+    InputRecordingPtr recording = Create(header.seed);
+    recording->m_frames.resize(header.frameCount);
+
+    const uint8_t* data = file.GetData() + sizeof(RecordingHeader);
+    for (auto& frame : recording->m_frames)
+    {
+        RecordedFrame recorded;
+        std::memcpy(&recorded, data, sizeof(RecordedFrame));
+        data += sizeof(RecordedFrame);
+
+        frame.scene = recorded.scene;
+        frame.deltaTime = recorded.deltaTime;
+        frame.state.mousePosition = {recorded.mousePosition[0], recorded.mousePosition[1]};
+        for (int i = 0 ; i < InputState::MouseButtonCount ; ++i)
+        {
+            frame.state.mouseButtons[i] = (recorded.mouseButtons >> i) & 1;
+        }
+        for (int i = 0 ; i < InputState::KeyCount ; ++i)
+        {
+            frame.state.keys[i] = (recorded.keys[i / 8] >> (i % 8)) & 1;
+        }
+    }
+
+    return recording;
+}
+
+bool InputRecording::Save(const std::string& path) const
+{
+    RecordingHeader header = {INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION, m_seed, (uint32_t)m_frames.size()};
+
+    std::vector<uint8_t> output(sizeof(RecordingHeader) + m_frames.size() * sizeof(RecordedFrame));
+    std::memcpy(output.data(), &header, sizeof(RecordingHeader));
+
+    uint8_t* data = output.data() + sizeof(RecordingHeader);
+    for (const auto& frame : m_frames)
+    {
+        // Zeroing the padding too, recording the same inputs gives the same file
+        RecordedFrame recorded;
+        std::memset(&recorded, 0, sizeof(RecordedFrame));
+        recorded.scene = frame.scene;
+        recorded.deltaTime = frame.deltaTime;
+        recorded.mousePosition[0] = frame.state.mousePosition.x;
+        recorded.mousePosition[1] = frame.state.mousePosition.y;
+        for (int i = 0 ; i < InputState::MouseButtonCount ; ++i)
+        {
+            recorded.mouseButtons |= frame.state.mouseButtons[i] << i;
+        }
+        for (int i = 0 ; i < InputState::KeyCount ; ++i)
+        {
+            recorded.keys[i / 8] |= frame.state.keys[i] << (i % 8);
+        }
+
+        std::memcpy(data, &recorded, sizeof(RecordedFrame));
+        data += sizeof(RecordedFrame);
+    }
+
+    if (!WriteFile(path, output.data(), output.size()))
+    {
+        LOG_ERROR("Could not write the input recording %s", path.c_str());
+        return false;
+    }
+
+    LOG_INFO("Recorded %zu frames into %s", m_frames.size(), path.c_str());
+    return true;
+}
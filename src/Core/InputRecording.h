@@ -0,0 +1,76 @@
+#ifndef INPUTRECORDING_H
+#define INPUTRECORDING_H
+
+#include "Inputs.h"
+#include "Foundations.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+class InputRecording;
+
+DECLARE_PTR_TYPE(InputRecording);
+
+
+#define INPUT_RECORDING_MAGIC 0x4e494d44  // "DMIN"
+#define INPUT_RECORDING_VERSION 1
+
+
+// Inputs of a simulation step
+struct InputFrame
+{
+    // Scene switches since the start of the run. Loading times vary from a run to another, the frames
+    // recorded on a scene are only replayed once it has been switched to.
+    uint32_t scene = 0;
+    double deltaTime = 0.0;
+    InputState state;
+};
+
+
+// Inputs and durations of the simulation steps of a run, along with the seed of the entity ids (see
+// EntityIndex) since the scripts are updated in the order of their entities. Replaying them on the same
+// level gives the same simulation, whatever the time the frames take.
+class InputRecording
+{
+public:
+    static InputRecordingPtr Create(const uint32_t& seed);
+    // Returns nullptr if the file can't be read
+    static InputRecordingPtr Load(const std::string& path);
+
+    bool Save(const std::string& path) const;
+
+    inline void AddFrame(const InputFrame& frame) { m_frames.push_back(frame); }
+    inline const InputFrame& GetFrame(const size_t& index) const { return m_frames[index]; }
+    inline size_t GetFrameCount() const { return m_frames.size(); }
+
+    inline uint32_t GetSeed() const { return m_seed; }
+
+private:
+    InputRecording(const uint32_t& seed) : m_seed(seed) {}
+
+    // Layout of the frames in the recording files
+    struct RecordedFrame
+    {
+        double deltaTime;
+        uint32_t scene;
+        float mousePosition[2];
+        uint8_t mouseButtons;
+        uint8_t keys[(InputState::KeyCount + 7) / 8];
+    };
+
+    struct RecordingHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t seed;
+        uint32_t frameCount;
+    };
+
+    uint32_t m_seed;
+    std::vector<InputFrame> m_frames;
+};
+
+
+#endif // INPUTRECORDING_H
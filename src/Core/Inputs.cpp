@@ -1,26 +1,67 @@
 #include "Inputs.h"
 
-#include "Core/Window.h"
-#include "Core/Application.h"
-
 #include <GLFW/glfw3.h>
 
 
+static_assert(InputState::KeyCount == GLFW_KEY_LAST + 1, "InputState must hold every GLFW key");
+static_assert(InputState::MouseButtonCount == GLFW_MOUSE_BUTTON_LAST + 1, "InputState must hold every GLFW mouse button");
+
+// Filled by the window callbacks
+static InputState s_windowState;
+// Read by the simulation
+static InputState s_state;
+
+
 bool Inputs::IsKeyPressed(const KeyCode &key)
 {
-    int state = glfwGetKey(Application::Get().GetWindow().GetInternalWindow(), (int)key);
-    return state == GLFW_PRESS || state == GLFW_REPEAT;
+    int index = (int)key;
+    return index >= 0 && index < InputState::KeyCount && s_state.keys[index];
 }
 
 bool Inputs::IsMouseButtonPressed(const MouseButton &button)
 {
-    int state = glfwGetMouseButton(Application::Get().GetWindow().GetInternalWindow(), (int)button);
-    return state == GLFW_PRESS || state == GLFW_REPEAT;
+    int index = (int)button;
+    return index >= 0 && index < InputState::MouseButtonCount && s_state.mouseButtons[index];
 }
 
 glm::vec2 Inputs::GetMousePosition()
 {
-    double x, y;
-    glfwGetCursorPos(Application::Get().GetWindow().GetInternalWindow(), &x, &y);
-    return glm::vec2((float)x, (float)y);
+    return s_state.mousePosition;
+}
+
+const InputState& Inputs::GetState()
+{
+    return s_state;
+}
+
+void Inputs::SetKeyState(const int& key, const bool& isPressed)
+{
+    // Unknown keys are reported as -1
+    if (key >= 0 && key < InputState::KeyCount)
+    {
+        s_windowState.keys[key] = isPressed;
+    }
+}
+
+void Inputs::SetMouseButtonState(const int& button, const bool& isPressed)
+{
+    if (button >= 0 && button < InputState::MouseButtonCount)
+    {
+        s_windowState.mouseButtons[button] = isPressed;
+    }
+}
+
+void Inputs::SetMousePosition(const glm::vec2& position)
+{
+    s_windowState.mousePosition = position;
+}
+
+void Inputs::SampleState()
+{
+    s_state = s_windowState;
+}
+
+void Inputs::SetState(const InputState& state)
+{
+    s_state = state;
 }
@@ -3,6 +3,8 @@
 
 #include <glm/vec2.hpp>
 
+#include <bitset>
+
 
 // These enums are just a 1 to 1 copy of the inputs used in GLFW.
 // The same goes for the various functions of the Inputs class.
@@ -133,12 +135,41 @@ enum class MouseButton
 };
 
 
+struct InputState
+{
+    static const int KeyCount = 349;         // GLFW_KEY_LAST + 1
+    static const int MouseButtonCount = 8;   // GLFW_MOUSE_BUTTON_LAST + 1
+
+    std::bitset<KeyCount> keys;
+    std::bitset<MouseButtonCount> mouseButtons;
+    glm::vec2 mousePosition{0.0f};
+};
+
+
+// The state of the inputs is captured from the window callbacks when the events are polled instead of 
+// querying GLFW, so that it can be read from the simulation thread while the main thread renders.
+// The queries return the state sampled at the beginning of the simulation step, which is what gets
+// recorded and replayed (see InputRecording).
 class Inputs
 {
 public:
     static bool IsKeyPressed(const KeyCode &key);
     static bool IsMouseButtonPressed(const MouseButton &button);
     static glm::vec2 GetMousePosition();
+
+    static const InputState& GetState();
+
+private:
+    static void SetKeyState(const int& key, const bool& isPressed);
+    static void SetMouseButtonState(const int& button, const bool& isPressed);
+    static void SetMousePosition(const glm::vec2& position);
+
+    // Called before every simulation step, either from the window state or from a replay
+    static void SampleState();
+    static void SetState(const InputState& state);
+
+    friend class Window;
+    friend class Application;
 };
 
 
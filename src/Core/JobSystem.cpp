@@ -0,0 +1,387 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+
+struct JobState
+{
+    JobFn function;
+    const char* name;
+    bool isBackground = false;
+
+    // Unfinished dependencies, plus one while the job is being scheduled
+    std::atomic<uint32_t> pendingDependencies = 1;
+
+    std::mutex mutex;
+    bool isDone = false;
+    std::vector<std::shared_ptr<JobState>> dependents;
+};
+
+
+JobSystem* JobSystem::s_instance = nullptr;
+
+// Index of the worker running on this thread, -1 outside of the workers
+static thread_local int t_workerIndex = -1;
+
+
+bool JobHandle::IsDone() const
+{
+    if (!m_state)
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->isDone;
+}
+
+
+JobSystem& JobSystem::Init(const uint32_t& threadCount)
+{
+    uint32_t count = threadCount;
+    if (!count)
+    {
+        count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    s_instance = new JobSystem(count);
+    return *s_instance;
+}
+
+JobSystem::JobSystem(const uint32_t& threadCount) :
+        m_mainThreadId(std::this_thread::get_id())
+{
+    // The main thread counts as one of the threads, it runs jobs while waiting for them
+    uint32_t workerCount = threadCount > 1 ? threadCount - 1 : 0;
+    for (uint32_t i = 0 ; i <= workerCount ; ++i)
+    {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    for (uint32_t i = 0 ; i < workerCount ; ++i)
+    {
+        m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::Run(const JobFn& job, const char* name)
+{
+    Schedule(job, {}, name);
+}
+
+JobHandle JobSystem::Schedule(const JobFn& job, const std::vector<JobHandle>& dependencies, const char* name)
+{
+    return Schedule(job, dependencies, name, false);
+}
+
+JobHandle JobSystem::ScheduleBackground(const JobFn& job, const std::vector<JobHandle>& dependencies, const char* name)
+{
+    return Schedule(job, dependencies, name, true);
+}
+
+JobHandle JobSystem::Schedule(const JobFn& job, const std::vector<JobHandle>& dependencies, const char* name, const bool& isBackground)
+{
+    auto state = std::make_shared<JobState>();
+    state->function = job;
+    state->name = name;
+    state->isBackground = isBackground;
+
+    for (const auto& dependency : dependencies)
+    {
+        if (!dependency.m_state)
+        {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(dependency.m_state->mutex);
+        if (!dependency.m_state->isDone)
+        {
+            state->pendingDependencies++;
+            dependency.m_state->dependents.push_back(state);
+        }
+    }
+
+    // Releasing the scheduling guard, the last dependency to finish enqueues the job otherwise
+    if (--state->pendingDependencies == 0)
+    {
+        Enqueue(state);
+    }
+
+    return JobHandle(state);
+}
+
+void JobSystem::Wait(const JobHandle& handle)
+{
+    while (!handle.IsDone())
+    {
+        if (!RunOneJob())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(const uint32_t& count, const ParallelTaskFn& task, const uint32_t& batchSize)
+{
+    ParallelForRange(count, batchSize, [&task](const uint32_t& begin, const uint32_t& end)
+    {
+        for (uint32_t i = begin ; i < end ; ++i)
+        {
+            task(i);
+        }
+    });
+}
+
+void JobSystem::ParallelForRange(const uint32_t& count, const uint32_t& batchSize, const ParallelRangeFn& task)
+{
+    if (!count)
+    {
+        return;
+    }
+
+    // A few ranges per thread keeps the threads busy when the ranges don't cost the same
+    uint32_t rangeCount = std::min((count + std::max(batchSize, 1u) - 1) / std::max(batchSize, 1u), GetThreadCount() * 4);
+    if (m_workers.empty() || rangeCount <= 1)
+    {
+        task(0, count);
+        return;
+    }
+
+    uint32_t rangeSize = (count + rangeCount - 1) / rangeCount;
+    std::atomic<uint32_t> remaining = rangeCount;
+    for (uint32_t range = 1 ; range < rangeCount ; ++range)
+    {
+        uint32_t begin = range * rangeSize;
+        uint32_t end = std::min(begin + rangeSize, count);
+        Run([&task, &remaining, begin, end]()
+        {
+            if (begin < end)
+            {
+                task(begin, end);
+            }
+            remaining--;
+        }, "ParallelFor");
+    }
+
+    // The calling thread takes the first range then helps with the others
+    task(0, std::min(rangeSize, count));
+    remaining--;
+
+    while (remaining > 0)
+    {
+        if (!RunOneJob())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::RunOnMainThread(const JobFn& job)
+{
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    m_mainThreadJobs.push_back(job);
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+    // Jobs queued by these jobs wait for the next frame
+    std::vector<JobFn> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        jobs.swap(m_mainThreadJobs);
+    }
+
+    for (const auto& job : jobs)
+    {
+        job();
+    }
+}
+
+void JobSystem::SetInstrumentation(const JobHookFn& onJobBegin, const JobHookFn& onJobEnd)
+{
+    m_onJobBegin = onJobBegin;
+    m_onJobEnd = onJobEnd;
+}
+
+void JobSystem::Enqueue(const std::shared_ptr<JobState>& job)
+{
+    if (m_workers.empty())
+    {
+        Execute(job);
+        return;
+    }
+
+    if (job->isBackground)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_backgroundQueue.mutex);
+            m_backgroundQueue.jobs.push_back(job);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_backgroundJobs++;
+        }
+        m_wakeCondition.notify_one();
+        return;
+    }
+
+    // Workers keep their jobs, the other threads share the last queue
+    WorkQueue& queue = t_workerIndex >= 0 ? *m_queues[t_workerIndex] : *m_queues.back();
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_queuedJobs++;
+    }
+    m_wakeCondition.notify_one();
+}
+
+std::shared_ptr<JobState> JobSystem::TakeJob()
+{
+    std::shared_ptr<JobState> job;
+    auto take = [&](WorkQueue& queue, const bool& isOwner)
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+        {
+            return false;
+        }
+
+        // The owner takes its most recent job (still hot in cache), thieves the oldest one
+        if (isOwner)
+        {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        }
+        else
+        {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        m_queuedJobs--;
+        return true;
+    };
+
+    // Own queue first, then the shared one, then the other workers starting from the next one
+    if (t_workerIndex >= 0 && take(*m_queues[t_workerIndex], true))
+    {
+        return job;
+    }
+    if (take(*m_queues.back(), false))
+    {
+        return job;
+    }
+
+    uint32_t workerCount = m_queues.size() - 1;
+    for (uint32_t i = 1 ; i <= workerCount ; ++i)
+    {
+        uint32_t index = (std::max(t_workerIndex, 0) + i) % workerCount;
+        if ((int)index != t_workerIndex && take(*m_queues[index], false))
+        {
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+bool JobSystem::RunOneJob()
+{
+    std::shared_ptr<JobState> job = TakeJob();
+    if (!job)
+    {
+        return false;
+    }
+
+    Execute(job);
+    return true;
+}
+
+bool JobSystem::RunBackgroundJob()
+{
+    std::shared_ptr<JobState> job;
+    {
+        std::lock_guard<std::mutex> lock(m_backgroundQueue.mutex);
+        if (m_backgroundQueue.jobs.empty())
+        {
+            return false;
+        }
+
+        job = std::move(m_backgroundQueue.jobs.front());
+        m_backgroundQueue.jobs.pop_front();
+        m_backgroundJobs--;
+    }
+
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(const std::shared_ptr<JobState>& job)
+{
+    int threadIndex = t_workerIndex >= 0 ? t_workerIndex + 1 : (IsMainThread() ? 0 : -1);
+    if (m_onJobBegin)
+    {
+        m_onJobBegin(job->name, threadIndex);
+    }
+
+    job->function();
+
+    if (m_onJobEnd)
+    {
+        m_onJobEnd(job->name, threadIndex);
+    }
+
+    std::vector<std::shared_ptr<JobState>> dependents;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->isDone = true;
+        dependents.swap(job->dependents);
+    }
+
+    for (const auto& dependent : dependents)
+    {
+        if (--dependent->pendingDependencies == 0)
+        {
+            Enqueue(dependent);
+        }
+    }
+}
+
+void JobSystem::WorkerLoop(const uint32_t& workerIndex)
+{
+    t_workerIndex = workerIndex;
+
+    while (true)
+    {
+        // Only the top of the loop runs background jobs, a worker waiting inside of a job does not
+        if (RunOneJob() || RunBackgroundJob())
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.wait(lock, [this]() { return m_stopping || m_queuedJobs > 0 || m_backgroundJobs > 0; });
+        if (m_stopping)
+        {
+            return;
+        }
+    }
+}
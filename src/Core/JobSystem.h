@@ -0,0 +1,121 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+typedef std::function<void()> JobFn;
+typedef std::function<void(const uint32_t&)> ParallelTaskFn;
+typedef std::function<void(const uint32_t& begin, const uint32_t& end)> ParallelRangeFn;
+// Instrumentation, called on the thread running the job. Thread 0 is the main thread, workers start at 1
+// and threads outside of the system (simulation, streaming) that help waiting are reported as -1
+typedef std::function<void(const char* name, const int& threadIndex)> JobHookFn;
+
+struct JobState;
+
+// Handle on a scheduled job that other jobs can depend on
+class JobHandle
+{
+public:
+    JobHandle() = default;
+
+    bool IsDone() const;
+    inline bool IsValid() const { return m_state != nullptr; }
+
+private:
+    JobHandle(const std::shared_ptr<JobState>& state) : m_state(state) {}
+
+    std::shared_ptr<JobState> m_state;
+
+    friend class JobSystem;
+};
+
+
+// Engine wide pool of worker threads. Each worker owns a deque of jobs: it runs the last job it pushed
+// while idle workers steal the oldest ones of the others. Jobs submitted from outside of the workers go
+// through a shared queue. Threads waiting for jobs (Wait(), ParallelFor()) run other jobs meanwhile, so
+// jobs can wait for other jobs. Anything touching GL goes through the main thread queue instead.
+class JobSystem
+{
+public:
+    // A thread count of 0 uses one worker per hardware thread, minus the main thread
+    static JobSystem& Init(const uint32_t& threadCount=0);
+    inline static JobSystem& Get() { return *s_instance; }
+
+    // Fire and forget
+    void Run(const JobFn& job, const char* name="Job");
+    // The job starts once all of its dependencies are done
+    JobHandle Schedule(const JobFn& job, const std::vector<JobHandle>& dependencies={}, const char* name="Job");
+    // Long jobs that must not delay a frame (building a level...). They are only picked up by idle workers,
+    // the threads waiting for other jobs never run them.
+    JobHandle ScheduleBackground(const JobFn& job, const std::vector<JobHandle>& dependencies={}, const char* name="Job");
+    void Wait(const JobHandle& handle);
+
+    // Calls task(i) for every i in [0, count), batchSize consecutive indices per job
+    void ParallelFor(const uint32_t& count, const ParallelTaskFn& task, const uint32_t& batchSize=1);
+    // Calls task(begin, end) on consecutive ranges of at least batchSize indices covering [0, count)
+    void ParallelForRange(const uint32_t& count, const uint32_t& batchSize, const ParallelRangeFn& task);
+
+    // Jobs run at the beginning of the next frame on the main thread, where the simulation is not running
+    void RunOnMainThread(const JobFn& job);
+    // Main thread only
+    void RunMainThreadJobs();
+    inline bool IsMainThread() const { return std::this_thread::get_id() == m_mainThreadId; }
+
+    // Must be set before any job is submitted
+    void SetInstrumentation(const JobHookFn& onJobBegin, const JobHookFn& onJobEnd);
+
+    inline uint32_t GetThreadCount() const { return m_workers.size() + 1; }
+
+private:
+    JobSystem(const uint32_t& threadCount);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<JobState>> jobs;
+    };
+
+    JobHandle Schedule(const JobFn& job, const std::vector<JobHandle>& dependencies, const char* name, const bool& isBackground);
+    void Enqueue(const std::shared_ptr<JobState>& job);
+    std::shared_ptr<JobState> TakeJob();
+    // Returns false if there was no job to run
+    bool RunOneJob();
+    bool RunBackgroundJob();
+    void Execute(const std::shared_ptr<JobState>& job);
+
+    void WorkerLoop(const uint32_t& workerIndex);
+
+    std::vector<std::thread> m_workers;
+    // One queue per worker, followed by the queue shared by the other threads
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    // Taken by the workers once the queues above are empty
+    WorkQueue m_backgroundQueue;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<uint32_t> m_queuedJobs = 0;
+    std::atomic<uint32_t> m_backgroundJobs = 0;
+    bool m_stopping = false;
+
+    std::thread::id m_mainThreadId;
+    std::mutex m_mainThreadMutex;
+    std::vector<JobFn> m_mainThreadJobs;
+
+    JobHookFn m_onJobBegin;
+    JobHookFn m_onJobEnd;
+
+    static JobSystem* s_instance;
+};
+
+
+#endif  // JOBSYSTEM_H
@@ -0,0 +1,125 @@
+#include "Memory.h"
+
+#include <algorithm>
+
+
+// Large enough for the pathfinding of a frame and the nav map of a level without chaining blocks
+static const size_t s_frameArenaBlockSize = 1024 * 1024;
+static const size_t s_levelArenaBlockSize = 1024 * 1024;
+
+MemoryCounters Memory::s_frameCounters;
+MemoryStats Memory::s_lastFrameStats;
+
+
+LinearArena::LinearArena(const size_t& blockSize) :
+        m_blockSize(blockSize)
+{
+
+}
+
+LinearArena::~LinearArena()
+{
+
+}
+
+void* LinearArena::Allocate(const size_t& size, const size_t& alignment)
+{
+    // Moving on to the next block that can hold the allocation, adding one when there is none left
+    while (true)
+    {
+        if (m_currentBlock < m_blocks.size())
+        {
+            Block& block = m_blocks[m_currentBlock];
+            uintptr_t address = reinterpret_cast<uintptr_t>(block.data.get()) + m_offset;
+            size_t padding = (alignment - address % alignment) % alignment;
+            if (m_offset + padding + size <= block.size)
+            {
+                m_offset += padding + size;
+                m_usedSize += padding + size;
+                m_allocationCount++;
+
+                return reinterpret_cast<void*>(address + padding);
+            }
+
+            if (m_currentBlock + 1 < m_blocks.size())
+            {
+                m_currentBlock++;
+                m_offset = 0;
+                continue;
+            }
+        }
+
+        AddBlock(size + alignment);
+    }
+}
+
+void LinearArena::Free(void* data, const size_t& size)
+{
+    if (m_currentBlock >= m_blocks.size())
+    {
+        return;
+    }
+
+    std::byte* blockData = m_blocks[m_currentBlock].data.get();
+    std::byte* end = static_cast<std::byte*>(data) + size;
+    if (end == blockData + m_offset)
+    {
+        m_offset -= size;
+        m_usedSize -= size;
+    }
+}
+
+void LinearArena::Reset()
+{
+    // Merging the blocks so that the next uses fit in a single one
+    if (m_blocks.size() > 1)
+    {
+        m_blocks.clear();
+        m_capacity = 0;
+        m_currentBlock = 0;
+        m_offset = 0;
+        AddBlock(m_usedSize);
+    }
+
+    m_currentBlock = 0;
+    m_offset = 0;
+    m_usedSize = 0;
+    m_allocationCount = 0;
+}
+
+void LinearArena::AddBlock(const size_t& minSize)
+{
+    size_t size = std::max(minSize, m_blockSize);
+    m_blocks.push_back({std::make_unique<std::byte[]>(size), size});
+    m_capacity += size;
+
+    m_currentBlock = m_blocks.size() - 1;
+    m_offset = 0;
+    Memory::GetFrameCounters().heapAllocations++;
+}
+
+
+LinearArena& Memory::GetFrameArena()
+{
+    static LinearArena arena(s_frameArenaBlockSize);
+    return arena;
+}
+
+LinearArena& Memory::GetLevelArena()
+{
+    static LinearArena arena(s_levelArenaBlockSize);
+    return arena;
+}
+
+void Memory::EndFrame()
+{
+    LinearArena& frameArena = GetFrameArena();
+    s_lastFrameStats.frameBytes = frameArena.GetUsedSize();
+    s_lastFrameStats.frameAllocations = frameArena.GetAllocationCount();
+
+    // The block merged by the reset belongs to this frame, the counters are only read afterwards
+    frameArena.Reset();
+
+    s_lastFrameStats.poolAcquisitions = s_frameCounters.poolAcquisitions.exchange(0);
+    s_lastFrameStats.heapAllocations = s_frameCounters.heapAllocations.exchange(0);
+}
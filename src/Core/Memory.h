@@ -0,0 +1,212 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Allocations made by the arenas and pools during the last frame, see Memory::EndFrame()
+struct MemoryStats
+{
+    // Memory handed out by the frame arena
+    size_t frameBytes = 0;
+    size_t frameAllocations = 0;
+    // Objects taken from the pools
+    size_t poolAcquisitions = 0;
+    // Blocks the arenas and pools had to request from the heap, should stay at 0 once warmed up
+    size_t heapAllocations = 0;
+};
+
+// Counters of the frame in progress. The arenas and pools of the background jobs (level streaming,
+// simulation thread) report to them as well, hence the atomics.
+struct MemoryCounters
+{
+    std::atomic<size_t> poolAcquisitions = 0;
+    std::atomic<size_t> heapAllocations = 0;
+};
+
+
+// Bump allocator handing out memory from large blocks, everything is released at once by Reset().
+// Destructors are never called, it only holds trivially destructible data or containers that don't
+// outlive the arena. Not thread safe.
+class LinearArena
+{
+public:
+    LinearArena(const size_t& blockSize);
+    ~LinearArena();
+    LinearArena(const LinearArena&) = delete;
+
+    void* Allocate(const size_t& size, const size_t& alignment=alignof(std::max_align_t));
+    // Gives the memory back if it was the last allocation (a container growing in place), does nothing otherwise
+    void Free(void* data, const size_t& size);
+
+    template <typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+        return new (Allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+    }
+
+    // Invalidates every allocation, blocks are kept for the next use
+    void Reset();
+
+    inline size_t GetUsedSize() const { return m_usedSize; }
+    inline size_t GetCapacity() const { return m_capacity; }
+    inline uint32_t GetAllocationCount() const { return m_allocationCount; }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    void AddBlock(const size_t& minSize);
+
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    size_t m_currentBlock = 0;
+    size_t m_offset = 0;
+
+    size_t m_usedSize = 0;
+    size_t m_capacity = 0;
+    uint32_t m_allocationCount = 0;
+};
+
+
+// Allocator allowing std containers to live in a LinearArena, only the last allocation can be given back
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    ArenaAllocator(LinearArena& arena) : m_arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.GetArena()) {}
+
+    inline T* allocate(const size_t& count) { return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T))); }
+    inline void deallocate(T* data, const size_t& count) { m_arena->Free(data, count * sizeof(T)); }
+
+    inline LinearArena* GetArena() const { return m_arena; }
+
+    template <typename U>
+    friend bool operator==(const ArenaAllocator& first, const ArenaAllocator<U>& second) { return first.m_arena == second.GetArena(); }
+    template <typename U>
+    friend bool operator!=(const ArenaAllocator& first, const ArenaAllocator<U>& second) { return !(first == second); }
+
+private:
+    LinearArena* m_arena;
+};
+
+
+// Fixed size objects recycled through a free list, memory is only returned to the heap with the pool.
+// Not thread safe.
+template <typename T>
+class ObjectPool
+{
+public:
+    ObjectPool(const size_t& objectsPerChunk=256) : m_objectsPerChunk(objectsPerChunk) {}
+    ObjectPool(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* Acquire(Args&&... args);
+    void Release(T* object);
+
+    inline size_t GetLiveCount() const { return m_liveCount; }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    void AddChunk();
+
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    Slot* m_freeList = nullptr;
+    size_t m_objectsPerChunk;
+    size_t m_liveCount = 0;
+};
+
+
+// Arenas shared by the engine, main thread only.
+// They serve the A* searches (frame arena and node pool) and the nav map (level arena). The other allocations
+// of the hot paths don't fit them: the component slots are shared between scenes and threads and outlive the
+// frames (copy-on-write), the job closures are freed by another thread than the one allocating them, events are
+// already stack objects and entity names are only built while loading levels.
+class Memory
+{
+public:
+    // Released at the end of every frame
+    static LinearArena& GetFrameArena();
+    // Released by the GameManager once the next level has been loaded
+    static LinearArena& GetLevelArena();
+
+    // Rewinds the frame arena and moves the counters of the frame to the last frame stats
+    static void EndFrame();
+    inline static const MemoryStats& GetLastFrameStats() { return s_lastFrameStats; }
+
+    // Counters of the frame in progress, filled by the arenas and pools
+    inline static MemoryCounters& GetFrameCounters() { return s_frameCounters; }
+
+private:
+    static MemoryCounters s_frameCounters;
+    static MemoryStats s_lastFrameStats;
+};
+
+
+template <typename T>
+template <typename... Args>
+T* ObjectPool<T>::Acquire(Args&&... args)
+{
+    if (!m_freeList)
+    {
+        AddChunk();
+    }
+
+    Slot* slot = m_freeList;
+    m_freeList = slot->next;
+    m_liveCount++;
+    Memory::GetFrameCounters().poolAcquisitions++;
+
+    return new (slot->storage) T{std::forward<Args>(args)...};
+}
+
+template <typename T>
+void ObjectPool<T>::Release(T* object)
+{
+    if (!object)
+    {
+        return;
+    }
+
+    object->~T();
+    Slot* slot = reinterpret_cast<Slot*>(object);
+    slot->next = m_freeList;
+    m_freeList = slot;
+    m_liveCount--;
+}
+
+template <typename T>
+void ObjectPool<T>::AddChunk()
+{
+    Slot* chunk = new Slot[m_objectsPerChunk];
+    for (size_t i = 0 ; i < m_objectsPerChunk ; ++i)
+    {
+        chunk[i].next = i + 1 < m_objectsPerChunk ? &chunk[i + 1] : m_freeList;
+    }
+    m_freeList = chunk;
+    m_chunks.emplace_back(chunk);
+    Memory::GetFrameCounters().heapAllocations++;
+}
+
+
+#endif  // MEMORY_H
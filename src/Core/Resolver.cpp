@@ -55,3 +55,8 @@ std::string Resolver::GetResourcesPath() const
 {
     return m_rootPath / "resources";
 }
+
+std::string Resolver::GetCachePath() const
+{
+    return m_rootPath / "cache";
+}
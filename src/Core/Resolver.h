@@ -14,11 +14,13 @@ public:
     std::string Resolve(const std::string& identifier) const;
     std::string AsIdentifier(const std::string& path) const;
 
+    std::string GetResourcesPath() const;
+    // Directory holding the cooked versions of the resources
+    std::string GetCachePath() const;
+
 private:
     Resolver(const std::filesystem::path& rootPath) : m_rootPath(rootPath) {}
     ~Resolver() = default;
-
-    std::string GetResourcesPath() const;
     
     std::filesystem::path m_rootPath;
 
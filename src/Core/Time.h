@@ -4,23 +4,37 @@
 
 class Application;
 
+namespace Benchmark { class State; }
+
 class Time
 {
 public:
+    // Time at the beginning of the frame
     inline static double GetTime() { return s_time; }
+    // Duration of the current step: the fixed timestep while simulating, the frame duration otherwise
     inline static double GetDeltaTime() { return s_deltaTime; }
+    inline static double GetFrameDeltaTime() { return s_frameDeltaTime; }
+    // Position of the frame between the last two simulation steps, from 0 (previous) to 1 (latest)
+    inline static float GetInterpolationFactor() { return s_interpolationFactor; }
 
 private:
     inline static void SetTime(const double& time)
     {
-        s_deltaTime = time - s_time; 
+        s_frameDeltaTime = time - s_time; 
+        s_deltaTime = s_frameDeltaTime;
         s_time = time;
     } 
 
+    inline static void SetDeltaTime(const double& deltaTime) { s_deltaTime = deltaTime; }
+    inline static void SetInterpolationFactor(const float& factor) { s_interpolationFactor = factor; }
+
     static double s_time;
     static double s_deltaTime;
+    static double s_frameDeltaTime;
+    static float s_interpolationFactor;
 
     friend Application;
+    friend Benchmark::State;
 };
 
 
@@ -4,6 +4,7 @@
 #include "Event.h"
 #include "Time.h"
 #include "Application.h"
+#include "Inputs.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -63,6 +64,8 @@ Window::Window(const WindowSettings& settings) :
 
     glfwSetCursorPosCallback(m_window, [](GLFWwindow* window, double xpos, double ypos)
     {
+        Inputs::SetMousePosition(glm::vec2((float)xpos, (float)ypos));
+
         MouseMovedEvent event(xpos, ypos);
         Application::Get().EmitEvent(&event);
     });
@@ -75,6 +78,8 @@ Window::Window(const WindowSettings& settings) :
 
     glfwSetMouseButtonCallback(m_window, [](GLFWwindow* window, int button, int action, int mods)
     {
+        Inputs::SetMouseButtonState(button, action == GLFW_PRESS);
+
         switch (action) {
             case GLFW_PRESS: {
                 MouseButtonPressedEvent event((MouseButton)button, mods);
@@ -91,6 +96,8 @@ Window::Window(const WindowSettings& settings) :
 
     glfwSetKeyCallback(m_window,[](GLFWwindow *window, int key, int scancode, int action, int mods)
     {
+        Inputs::SetKeyState(key, action != GLFW_RELEASE);
+
         switch (action) {
             case GLFW_PRESS:
             case GLFW_REPEAT: {
@@ -148,8 +155,18 @@ int Window::GetHeight() const
 }
 
 void Window::OnUpdate()
+{
+    PollEvents();
+    SwapBuffer();
+}
+
+void Window::PollEvents()
 {
     glfwPollEvents();
+}
+
+void Window::SwapBuffer() const
+{
     glfwSwapBuffers(m_window);
 }
 
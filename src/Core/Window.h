@@ -35,7 +35,9 @@ public:
     int GetWidth() const;
     int GetHeight() const;
     
+    // Polls the events then swaps the buffers
     void OnUpdate();
+    void PollEvents();
     void SwapBuffer() const; 
 
     void SetTitle(const std::string& title);
@@ -8,10 +8,14 @@
 #include "Scripting/Engine.h"
 #include "Scripting/Trigger.h"
 
+#include "Scene/Components/Lights.h"
+#include "Scene/SceneSerializer.h"
+
 #include "Renderer/Renderer.h"
 
 #include "Core/Event.h"
 #include "Core/Inputs.h"
+#include "Core/JobSystem.h"
 #include "Core/Logging.h"
 #include "Core/Time.h"
 #include "Core/Animation.h"
@@ -45,11 +49,11 @@ Scriptable CreateCharacterController(const Entity& entity)
     CharacterControllerData& data = std::any_cast<CharacterControllerData&>(dataBlock);
     if (!data.haloEffectAnimation.ended)
     {
-        Renderer::Get().GetPostProcessShader()->SetVec4("uHaloColor", data.haloEffectAnimation.Evaluate(Time::GetDeltaTime()));
+        Renderer::Get().SetPostProcessValue("uHaloColor", data.haloEffectAnimation.Evaluate(Time::GetDeltaTime()));
     }
     else 
     {
-        Renderer::Get().GetPostProcessShader()->SetVec4("uHaloColor", glm::vec4(0.0f));
+        Renderer::Get().SetPostProcessValue("uHaloColor", glm::vec4(0.0f));
     }
 
     auto& transform = entity.GetComponent<Transform>();
@@ -214,10 +218,23 @@ Scriptable CreateCharacterController(const Entity& entity)
             {
                 weaponData = newWeaponData;
 
-                // Switch weapon models
-                weapon.FindChild("model").Remove();
-                auto model = ResourceManager::LoadModel(newWeaponData.modelIdentifier);
-                weapon.GetScene()->CopyEntity(model.Get()->GetRootEntity(), "model", weapon);
+                // Switch weapon models, loading the model touches GL so it can't run on the simulation thread
+                std::string modelIdentifier = newWeaponData.modelIdentifier;
+                auto switchModels = [weapon, modelIdentifier]() mutable {
+                    weapon.FindChild("model").Remove();
+                    auto model = ResourceManager::LoadModel(modelIdentifier);
+                    weapon.GetScene()->CopyEntity(model.Get()->GetRootEntity(), "model", weapon);
+                };
+
+                JobSystem& jobSystem = JobSystem::Get();
+                if (jobSystem.IsMainThread())
+                {
+                    switchModels();
+                }
+                else
+                {
+                    jobSystem.RunOnMainThread(switchModels);
+                }
             }
             break;
         }
@@ -410,7 +427,7 @@ nullptr);
 Scriptable CreateHealLogic(const Entity& entity)
 {
     return Scriptable(
-        "MonsterLogic",
+        "HealLogic",
         entity,
 
 // HealLogic::OnCreate
@@ -563,6 +580,39 @@ nullptr);
 }
 
 
+// == Torch Logic ==
+
+Scriptable CreateTorchLogic(const Entity& entity)
+{
+    return Scriptable(
+        "TorchLogic",
+        entity,
+
+// TorchLogic::OnCreate
+nullptr,
+
+// TorchLogic::OnUpdate
+[](Entity entity, std::any& dataBlock)
+{
+    auto* light = entity.FindComponent<PointLight>();
+    if (!light)
+    {
+        return;
+    }
+
+    // Flickering torch effect
+    double time = Time::GetTime();
+    light->intensity = (0.8 + (std::abs(sin(time * 2.3)) * 2 + sin(0.5 + time * 7.7)) * 0.3) * 10.0;
+},
+
+// TorchLogic::OnEvent
+nullptr,
+
+// TorchLogic::OnDestroy
+nullptr);
+}
+
+
 // == Title Screen Logic ==
 
 Scriptable CreateTitleScreenLogic(const Entity& entity)
@@ -630,7 +680,7 @@ nullptr);
 Scriptable CreateExitLogic(const Entity& entity)
 {
     return Scriptable(
-        "TitleScreen",
+        "ExitLogic",
         entity,
 
 // ExitLogic::OnCreate
@@ -646,8 +696,16 @@ nullptr,
     {
         case TriggerEnterEvent::TypeId:
         {
+            // Going down to the next floor, the game ends after the last one
+            GameManager& gameManager = GameManager::Get();
+            if (gameManager.HasNextFloor())
+            {
+                gameManager.SetNextFloor(gameManager.GetCurrentFloor() + 1);
+                break;
+            }
+
             LOG_INFO("END !");
-            GameManager::Get().ShowEndScreen();
+            gameManager.ShowEndScreen();
         }
     };
 },
@@ -687,4 +745,120 @@ nullptr);
 }
 
 
+
+// == Serialization ==
+
+// Scripts are rebuilt from their name, their data blocks are set up again by OnCreate(). 
+// Only the data the level loader fills after creating a script has to be saved along with it.
+struct ScriptSerializer
+{
+    std::function<Scriptable(const Entity&)> create;
+    std::function<void(const Scriptable&, SnapshotWriter&)> writeData;
+    std::function<void(Scriptable&, SnapshotReader&)> readData;
+};
+
+static const std::unordered_map<std::string, ScriptSerializer> s_scriptSerializers = {
+    {"CharacterController", {CreateCharacterController}},
+    {"MonsterLogic",        {CreateMonsterLogic}},
+    {"RewardAnimator",      {CreateRewardAnimator}},
+    {"HealLogic",           {CreateHealLogic,
+                             [](const Scriptable& script, SnapshotWriter& writer) { writer.Write(script.GetDataBlock<HealData>().healing); },
+                             [](Scriptable& script, SnapshotReader& reader) { script.GetDataBlock<HealData>().healing = reader.Read<float>(); }}},
+    {"WeaponLogic",         {CreateWeaponLogic}},
+    {"DoorLogic",           {CreateDoorLogic}},
+    {"TorchLogic",          {CreateTorchLogic}},
+    {"TitleScreen",         {CreateTitleScreenLogic}},
+    {"GameOverLogic",       {CreateGameOverLogic}},
+    {"ExitLogic",           {CreateExitLogic}},
+    {"EndScreen",           {CreateEndScreenLogic}}
+};
+
+void RegisterSerializers()
+{
+    SceneSerializer::RegisterTrivial<CharacterData>("CharacterData");
+
+    SceneSerializer::Register<MonsterData>("MonsterData",
+        [](const MonsterData& data, SnapshotWriter& writer)
+        {
+            writer.WriteEntity(data.target);
+            writer.Write(data.attackSpeed);
+            writer.Write(data.strength);
+            writer.Write(data.angleOfView);
+            writer.Write(data.viewDistance);
+            writer.Write(data.attackDelay);
+        },
+        [](const Entity& entity, SnapshotReader& reader)
+        {
+            auto& data = entity.EmplaceComponent<MonsterData>();
+            data.target = reader.ReadEntity();
+            data.attackSpeed = reader.Read<float>();
+            data.strength = reader.Read<float>();
+            data.angleOfView = reader.Read<float>();
+            data.viewDistance = reader.Read<float>();
+            data.attackDelay = reader.Read<double>();
+        });
+
+    SceneSerializer::Register<WeaponData>("WeaponData",
+        [](const WeaponData& data, SnapshotWriter& writer)
+        {
+            writer.Write(data.damage);
+            writer.Write(data.speed);
+            writer.Write(data.range);
+            writer.WriteString(data.modelIdentifier);
+        },
+        [](const Entity& entity, SnapshotReader& reader)
+        {
+            auto& data = entity.EmplaceComponent<WeaponData>();
+            data.damage = reader.Read<float>();
+            data.speed = reader.Read<float>();
+            data.range = reader.Read<float>();
+            data.modelIdentifier = reader.ReadString();
+        });
+
+    SceneSerializer::Register<Scriptable>("Scriptable",
+        [](const Scriptable& script, SnapshotWriter& writer)
+        {
+            writer.WriteString(script.GetName());
+            auto it = s_scriptSerializers.find(script.GetName());
+            if (it != s_scriptSerializers.end() && it->second.writeData)
+            {
+                it->second.writeData(script, writer);
+            }
+        },
+        [](const Entity& entity, SnapshotReader& reader)
+        {
+            std::string name = reader.ReadString();
+            auto it = s_scriptSerializers.find(name);
+            if (it == s_scriptSerializers.end())
+            {
+                LOG_WARNING("Unknown script %s in scene snapshot.", name.c_str());
+                return;
+            }
+
+            auto& script = entity.EmplaceComponent<Scriptable>(it->second.create(entity));
+            if (it->second.readData)
+            {
+                it->second.readData(script, reader);
+            }
+        });
+
+    SceneSerializer::Register<NavAgent>("NavAgent",
+        [](const NavAgent&, SnapshotWriter&) {},
+        [](const Entity& entity, SnapshotReader&) { entity.EmplaceComponent<NavAgent>(entity); });
+
+    SceneSerializer::Register<Trigger>("Trigger",
+        [](const Trigger& trigger, SnapshotWriter& writer)
+        {
+            writer.WriteEntity(trigger.GetTarget());
+            writer.Write(trigger.GetRadius());
+        },
+        [](const Entity& entity, SnapshotReader& reader)
+        {
+            Entity target = reader.ReadEntity();
+            float radius = reader.Read<float>();
+            entity.EmplaceComponent<Trigger>(entity, target, radius);
+        });
+}
+
+
 } // Namespace Components
@@ -116,6 +116,10 @@ struct DoorData
 Scriptable CreateDoorLogic(const Entity& entity);
 
 
+// Animates the PointLight carried by the entity
+Scriptable CreateTorchLogic(const Entity& entity);
+
+
 // General game logics
 Scriptable CreateTitleScreenLogic(const Entity& entity);
 Scriptable CreateGameOverLogic(const Entity& entity);
@@ -123,6 +127,10 @@ Scriptable CreateExitLogic(const Entity& entity);
 Scriptable CreateEndScreenLogic(const Entity& entity);
 
 
+// Makes the game components and scripts part of the scene snapshots (see SceneSerializer)
+void RegisterSerializers();
+
+
 } // Namespace Components
 
 
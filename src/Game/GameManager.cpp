@@ -2,9 +2,14 @@
 #include "Level.h"
 
 #include "Scripting/Components.h"
+#include "Scripting/Engine.h"
 
 #include "Navigation/Engine.h"
 
+#include "Scene/SceneSerializer.h"
+
+#include "Core/JobSystem.h"
+#include "Core/Memory.h"
 #include "Core/Resolver.h"
 
 
@@ -16,6 +21,7 @@ GameManager& GameManager::Init()
     if (!s_instance)
     {
         s_instance = new GameManager;
+        Components::RegisterSerializers();
     }
 
     return *s_instance;
@@ -28,7 +34,7 @@ void GameManager::SetPlayer(const Entity& player)
 
 void GameManager::AddMonster(const Entity& entity)
 {
-    if (entity.GetScene() != Application::Get().GetMainScene().get())
+    if (entity.GetScene() != Scripting::Engine::Get().GetActiveScene())
     {
         return;
     }
@@ -42,7 +48,7 @@ void GameManager::AddMonster(const Entity& entity)
 
 void GameManager::RemoveMonster(const Entity& entity)
 {
-    if (entity.GetScene() != Application::Get().GetMainScene().get())
+    if (entity.GetScene() != Scripting::Engine::Get().GetActiveScene())
     {
         return;
     }
@@ -65,13 +71,45 @@ void GameManager::SetNextLevel(const std::string& levelIdentifier)
     m_nextLevel = levelIdentifier;
 }
 
+bool GameManager::HasNextFloor() const
+{
+    LevelPtr level = ResourceManager::GetResource<Level>(m_levelIdentifier).Get();
+    return level && m_currentFloor + 1 < level->floors.size();
+}
+
 void GameManager::SetNextFloor(const uint32_t& floor)
 {
+    if (DeferToMainThread([this, floor]() { SetNextFloor(floor); }))
+    {
+        return;
+    }
+
     m_nextFloor = floor;
+
+    // Outside of a level the floor is used by the next StartGame()
+    LevelPtr level = ResourceManager::GetResource<Level>(m_levelIdentifier).Get();
+    if (!level || !m_loadingLevel.empty() || floor >= level->floors.size())
+    {
+        return;
+    }
+
+    if (level->floors[floor].IsBuilt())
+    {
+        SwitchToFloor(level, floor);
+        return;
+    }
+
+    std::string identifier = m_levelIdentifier;
+    ResourceManager::PreloadLevelFloor(identifier, floor, [this, identifier, floor]() { OnFloorLoaded(identifier, floor); });
 }
 
 void GameManager::StartGame()
 {
+    if (DeferToMainThread([this]() { StartGame(); }))
+    {
+        return;
+    }
+
     if (m_nextLevel.empty())
     {
         m_nextLevel = m_currentLevel;
@@ -79,7 +117,7 @@ void GameManager::StartGame()
     
     if (m_nextFloor == -1)
     {
-        m_nextFloor = m_currentFloor;
+        m_nextFloor = (int)m_currentFloor;
     }
 
     LoadLevel(m_nextLevel, m_nextFloor);
@@ -87,36 +125,161 @@ void GameManager::StartGame()
 
 void GameManager::RestartGame()
 {
+    if (DeferToMainThread([this]() { RestartGame(); }))
+    {
+        return;
+    }
+
+    // The floor is rebuilt from the snapshot taken when it started instead of loading the level again.
+    // Rolling back its journal is not enough, the data of the scripts (opened doors...) is not journaled.
+    LevelPtr level = ResourceManager::GetResource<Level>(m_levelIdentifier).Get();
+    if (level && m_loadingLevel.empty() && m_snapshotFloor == (int)m_currentFloor && m_currentFloor < level->floors.size())
+    {
+        LevelFloor& levelFloor = level->floors[m_currentFloor];
+        ScenePtr scene = SceneSerializer::Load(m_floorSnapshot);
+        if (scene)
+        {
+            levelFloor.scene = scene;
+            EnableJournal(scene);
+            SwitchToFloor(level, m_currentFloor);
+            return;
+        }
+    }
+
+    LoadLevel(m_currentLevel, m_currentFloor);
+}
+
+void GameManager::OnResourceReloaded(const std::string& identifier)
+{
+    auto& resolver = Resolver::Get(); 
+    std::string levelIdentifier = resolver.AsIdentifier(resolver.Resolve(m_currentLevel));
+    LevelPtr level = ResourceManager::GetResource<Level>(levelIdentifier).Get();
+    if (!level)
+    {
+        return;
+    }
+
+    ImagePtr map = m_currentFloor < level->floors.size() ? level->floors[m_currentFloor].map : nullptr;
+    std::string mapIdentifier = map ? resolver.AsIdentifier(map->GetFilePath()) : "";
+    if (identifier != levelIdentifier && identifier != mapIdentifier)
+    {
+        return;
+    }
+
+    // The map is cached as a prefab, it has to be built again from the new image
+    ResourceManager::FreeResource<Prefab>(mapIdentifier);
+
+    LOG_INFO("Reloading level %s", levelIdentifier.c_str());
     LoadLevel(m_currentLevel, m_currentFloor);
 }
 
 
 void GameManager::LoadLevel(const std::string& levelIdentifier, const uint32_t& floor)
 {
-    ResourceManager::FreeResource<Level>(m_currentLevel);
+    // Every floor is built again, along with the one preloaded
+    ResourceManager::FreeResource<Level>(m_levelIdentifier);
+    m_floorSnapshot = SceneSnapshot();
+    m_snapshotFloor = -1;
 
     m_currentLevel = levelIdentifier;
     m_currentFloor = floor;
 
+    // The current scene keeps running while the level is streamed in
     auto& resolver = Resolver::Get(); 
-    LevelPtr level = ResourceManager::LoadLevel(resolver.Resolve(levelIdentifier)).Get();
-    if (!level)
+    m_levelIdentifier = resolver.AsIdentifier(resolver.Resolve(levelIdentifier));
+    m_loadingLevel = m_levelIdentifier;
+    std::string identifier = m_loadingLevel;
+    ResourceManager::LoadLevelAsync(identifier, floor, [this, identifier]() { OnLevelLoaded(identifier); });
+
+    // Cleanup
+    m_nextLevel.clear();
+    m_nextFloor = -1;
+}
+
+void GameManager::OnLevelLoaded(const std::string& identifier)
+{
+    // Another level has been requested in the meantime
+    if (identifier != m_loadingLevel)
     {
+        return;
+    }
+    m_loadingLevel.clear();
+
+    // The previous level kept running while this one was streamed in, its memory can only be released now
+    Navigation::Engine::Get().ClearNavMap();
+    Memory::GetLevelArena().Reset();
+
+    LevelPtr level = ResourceManager::GetResource<Level>(identifier).Get();
+    if (!level || m_currentFloor >= level->floors.size() || !level->floors[m_currentFloor].IsBuilt())
+    {
+        Application::Get().Stop();
+        return;
+    }
+
+    SwitchToFloor(level, m_currentFloor);
+}
+
+void GameManager::OnFloorLoaded(const std::string& identifier, const uint32_t& floor)
+{
+    // Only switching if the floor has been requested in the meantime, not just preloaded
+    if (identifier != m_levelIdentifier || m_nextFloor != (int)floor)
+    {
+        return;
+    }
+
+    LevelPtr level = ResourceManager::GetResource<Level>(identifier).Get();
+    if (!level || !level->floors[floor].IsBuilt())
+    {
+        LOG_ERROR("Could not build floor %u of %s", floor, identifier.c_str());
         Application::Get().Stop();
         return;
     }
 
+    SwitchToFloor(level, floor);
+}
+
+void GameManager::SwitchToFloor(const LevelPtr& level, const uint32_t& floor)
+{
+    uint32_t previousFloor = m_currentFloor;
+    m_currentFloor = floor;
+    m_nextFloor = -1;
+
+    const LevelFloor& levelFloor = level->floors[floor];
     Navigation::Engine& navEngine = Navigation::Engine::Get();
-    navEngine.SetNavMap(level->map);
+    navEngine.SetNavMap(levelFloor.grid);
+    navEngine.SetActiveScene(levelFloor.scene.get());
 
     Application& application = Application::Get();
-    application.SetMainScene(level->scene);
+    application.SetMainScene(levelFloor.scene);
 
-    // Cleanup
-    m_nextLevel.clear();
-    m_nextFloor = -1;
+    // The floor left is not played anymore, the application keeps its scene until the switch
+    if (previousFloor != floor && previousFloor < level->floors.size())
+    {
+        level->floors[previousFloor].scene.reset();
+    }
+
+    // Saved before the floor is played, restarting goes back to this state
+    if (m_snapshotFloor != (int)floor)
+    {
+        m_snapshotFloor = SceneSerializer::Save(levelFloor.scene, m_floorSnapshot) ? (int)floor : -1;
+        EnableJournal(levelFloor.scene);
+    }
 
-    LOG_INFO("Starting %s !", level->floorName.c_str());
+    LOG_INFO("Starting %s !", levelFloor.name.c_str());
+
+    PreloadNextFloor(level);
+}
+
+void GameManager::PreloadNextFloor(const LevelPtr& level)
+{
+    uint32_t floor = m_currentFloor + 1;
+    if (floor >= level->floors.size() || level->floors[floor].IsBuilt())
+    {
+        return;
+    }
+
+    std::string identifier = m_levelIdentifier;
+    ResourceManager::PreloadLevelFloor(identifier, floor, [this, identifier, floor]() { OnFloorLoaded(identifier, floor); });
 }
 
 void GameManager::ShowTitleScreen() const
@@ -136,6 +299,11 @@ void GameManager::ShowTitleScreen() const
 
 void GameManager::ShowGameOverScreen() const
 {
+    if (DeferToMainThread([this]() { ShowGameOverScreen(); }))
+    {
+        return;
+    }
+
     LOG_INFO("GAME OVER !");
     ScenePtr scene = Scene::Create();
 
@@ -152,6 +320,11 @@ void GameManager::ShowGameOverScreen() const
 
 void GameManager::ShowEndScreen() const
 {
+    if (DeferToMainThread([this]() { ShowEndScreen(); }))
+    {
+        return;
+    }
+
     ScenePtr scene = Scene::Create();
 
     Entity camera = scene->CreateEntity();
@@ -164,3 +337,24 @@ void GameManager::ShowEndScreen() const
     Application& application = Application::Get();
     application.SetMainScene(scene);
 }
+
+bool GameManager::DeferToMainThread(const JobFn& call)
+{
+    JobSystem& jobSystem = JobSystem::Get();
+    if (jobSystem.IsMainThread())
+    {
+        return false;
+    }
+
+    jobSystem.RunOnMainThread(call);
+    return true;
+}
+
+void GameManager::EnableJournal(const ScenePtr& scene)
+{
+    size_t capacity = Application::Get().GetJournalCapacity();
+    if (capacity)
+    {
+        scene->EnableJournal(capacity);
+    }
+}
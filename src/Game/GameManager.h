@@ -2,8 +2,12 @@
 #define GAMEMANAGER_H
 
 #include "Components.h"
+#include "Level.h"
 
 #include "Scene/Entity.h"
+#include "Scene/SceneSerializer.h"
+
+#include "Core/JobSystem.h"
 
 
 class GameManager
@@ -22,12 +26,20 @@ public:
     void Clear();
 
     inline std::string GetCurrentLevel() const { return m_currentLevel; }
+    inline uint32_t GetCurrentFloor() const { return m_currentFloor; }
+    bool HasNextFloor() const;
     void SetNextLevel(const std::string& levelIdentifier);
+    // Switches to another floor of the level being played, right away when it has been preloaded and as soon 
+    // as it is built otherwise. Before the level is loaded, sets the floor the game starts on.
     void SetNextFloor(const uint32_t& floor);
 
     void StartGame();
+    // Restarts the current floor from the state it was in when it started
     void RestartGame();
 
+    // Restarts the current level when its description or its map has been modified
+    void OnResourceReloaded(const std::string& identifier);
+
     void ShowTitleScreen() const;
     void ShowGameOverScreen() const;
     void ShowEndScreen() const;
@@ -36,7 +48,18 @@ private:
     GameManager() = default;
     ~GameManager() = default;
 
+    // Scenes and levels hold GL resources, the simulation thread leaves their changes to the main thread.
+    // Returns true when the call was queued, the caller then has nothing left to do.
+    static bool DeferToMainThread(const JobFn& call);
+
     void LoadLevel(const std::string& levelIdentifier, const uint32_t& floor);
+    void OnLevelLoaded(const std::string& identifier);
+    void OnFloorLoaded(const std::string& identifier, const uint32_t& floor);
+    void SwitchToFloor(const LevelPtr& level, const uint32_t& floor);
+    // Builds the floor after the current one in the background, so that going down is instant
+    void PreloadNextFloor(const LevelPtr& level);
+    // Starts recording the changes made to the floor from its current state, when journaling is enabled
+    static void EnableJournal(const ScenePtr& scene);
 
     static GameManager* s_instance;
 
@@ -45,8 +68,15 @@ private:
 
     std::string m_currentLevel;
     std::string m_nextLevel;
-    int m_currentFloor = 0;
+    // Resource identifier of the current level
+    std::string m_levelIdentifier;
+    std::string m_loadingLevel;
+    uint32_t m_currentFloor = 0;
     int m_nextFloor = -1;
+
+    // Current floor as built, before being played
+    SceneSnapshot m_floorSnapshot;
+    int m_snapshotFloor = -1;
 };
 
 
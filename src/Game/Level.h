@@ -1,25 +1,40 @@
 #ifndef LEVEL_H
 #define LEVEL_H
 
+#include "Navigation/CellGrid.h"
+
 #include "Scene/Scene.h"
 
 #include "Core/Image.h"
 #include "Core/Foundations.h"
 
+#include <vector>
+
 
 struct Level;
 
 DECLARE_PTR_TYPE(Level);
 
 
-struct Level
+// Every floor of a level is described up front, but only the floors being played or 
+// preloaded are built, in a scene of their own
+struct LevelFloor
 {
-    ScenePtr scene;
+    std::string name;
     ImagePtr map;
-    std::string floorName;
+    CellGridPtr grid;
+    ScenePtr scene;
+
+    inline bool IsBuilt() const { return scene != nullptr; }
+};
+
+struct Level
+{
+    std::string name;
+    std::vector<LevelFloor> floors;
 
     inline static LevelPtr Create() { return std::make_shared<Level>(); }
 };
 
 
-#endif // LEVEL_H
\ No newline at end of file
+#endif // LEVEL_H
@@ -10,7 +10,8 @@
 namespace Navigation {
 
 
-Agent::Agent()
+Agent::Agent(const Scene* scene) :
+        m_scene(scene)
 {
 
 }
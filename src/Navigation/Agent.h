@@ -7,6 +7,9 @@
 #include <glm/glm.hpp>
 
 
+class Scene;
+
+
 namespace Navigation {
 
 
@@ -37,14 +40,18 @@ public:
     bool IsMoving() const;
     bool HasPath() const;
 
+    // Scene of the entity moved by the agent, only the agents of the active scene are simulated
+    inline const Scene* GetScene() const { return m_scene; }
+
 private:
-    Agent();
+    Agent(const Scene* scene);
 
     void SetPath(const std::vector<glm::vec2>& path);
     inline bool NeedsNewPath() const { return m_requestsNewPath; }
 
     void MakeProgress(const float& deltaTime);
 
+    const Scene* m_scene;
     glm::vec3 m_destination;
     glm::mat4 m_nextTransform;
     glm::mat4 m_transform;
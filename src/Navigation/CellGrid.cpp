@@ -0,0 +1,146 @@
+#include "CellGrid.h"
+
+#include "Core/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+// Rows handled by each task, keeping the tasks large enough to be worth dispatching
+static const uint32_t s_rowsPerTask = 32;
+
+// Colors of the cell types (see LevelCell) packed as RGBA8, indexed by CellType.
+// They are compared with the colors stored in the map, not linearized: once linearized the Door color matched
+// none of these, and the doors painted in the maps were read as unknown cells.
+static const uint32_t s_cellColors[] = {
+    0xff000000,  // Wall
+    0xffffffff,  // Floor
+    0xff2277aa,  // Door
+    0xffff0000,  // Water
+    0xff0000ff,  // Entrance
+    0xff00ff00   // Exit
+};
+static const uint32_t s_cellColorCount = sizeof(s_cellColors) / sizeof(uint32_t);
+
+
+static inline uint32_t PackColor(const uint32_t& r, const uint32_t& g, const uint32_t& b, const uint32_t& a)
+{
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+static inline uint8_t ClassifyColor(const uint32_t& color)
+{
+    for (uint32_t i = 0 ; i < s_cellColorCount ; ++i)
+    {
+        if (color == s_cellColors[i])
+            return i;
+    }
+
+    return (uint8_t)CellType::Unknown;
+}
+
+static void ClassifyColors(const uint32_t* colors, const uint32_t& count, uint8_t* outCells)
+{
+    uint32_t x = 0;
+
+#if defined(__SSE2__)
+    // Four pixels at a time, each lane is replaced by the index of the color it matches
+    const __m128i unknown = _mm_set1_epi32((int)CellType::Unknown);
+    for ( ; x + 4 <= count ; x += 4)
+    {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + x));
+        __m128i types = unknown;
+        for (uint32_t i = 0 ; i < s_cellColorCount ; ++i)
+        {
+            __m128i match = _mm_cmpeq_epi32(pixels, _mm_set1_epi32((int)s_cellColors[i]));
+            types = _mm_or_si128(_mm_andnot_si128(match, types), _mm_and_si128(match, _mm_set1_epi32(i)));
+        }
+
+        // Narrowing the four 32 bits types to bytes
+        types = _mm_packs_epi32(types, types);
+        types = _mm_packus_epi16(types, types);
+        uint32_t packed = (uint32_t)_mm_cvtsi128_si32(types);
+        std::copy_n(reinterpret_cast<const uint8_t*>(&packed), 4, outCells + x);
+    }
+#endif
+
+    for ( ; x < count ; ++x)
+    {
+        outCells[x] = ClassifyColor(colors[x]);
+    }
+}
+
+
+CellGrid::CellGrid(const uint32_t& width, const uint32_t& height) :
+        m_width(width),
+        m_height(height),
+        m_cells((size_t)width * height),
+        m_wallNeighbours((size_t)width * height)
+{
+
+}
+
+CellGridPtr CellGrid::Create(const Image& map)
+{
+    CellGridPtr grid(new CellGrid(map.GetWidth(), map.GetHeight()));
+
+    // The wall masks read the rows around each row, they are computed once every row has been classified
+    JobSystem& jobSystem = JobSystem::Get();
+    jobSystem.ParallelFor(grid->m_height, [&](const uint32_t& y) { grid->ClassifyRow(map, y); }, s_rowsPerTask);
+    jobSystem.ParallelFor(grid->m_height, [&](const uint32_t& y) { grid->ComputeWallNeighbours(y); }, s_rowsPerTask);
+
+    return grid;
+}
+
+void CellGrid::ClassifyRow(const Image& map, const uint32_t& y)
+{
+    // Packing the row as RGBA8 colors first, whatever the layout of the image
+    thread_local std::vector<uint32_t> colors;
+    colors.resize(m_width);
+
+    const uint32_t channels = map.GetChannels();
+    if (map.GetComponentType() == ImageComponentType::UInt8 && channels >= 3)
+    {
+        const uint8_t* pixels = static_cast<const uint8_t*>(map.GetData()) + (size_t)y * m_width * channels;
+        for (uint32_t x = 0 ; x < m_width ; ++x, pixels += channels)
+        {
+            colors[x] = PackColor(pixels[0], pixels[1], pixels[2], channels == 4 ? pixels[3] : 255);
+        }
+    }
+    else
+    {
+        auto quantize = [](const float& value) { return (uint32_t)std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f); };
+        for (uint32_t x = 0 ; x < m_width ; ++x)
+        {
+            glm::vec4 pixel = map.GetPixel(x, y);
+            colors[x] = PackColor(quantize(pixel.x), quantize(pixel.y), quantize(pixel.z), quantize(pixel.w));
+        }
+    }
+
+    ClassifyColors(colors.data(), m_width, &m_cells[(size_t)y * m_width]);
+}
+
+void CellGrid::ComputeWallNeighbours(const uint32_t& y)
+{
+    // Out of the map cells count as walls
+    auto isWall = [](const uint8_t* row, const int64_t& x, const int64_t& width) -> uint8_t {
+        return !row || x < 0 || x >= width || row[x] == (uint8_t)CellType::Wall;
+    };
+
+    const int64_t width = m_width;
+    const uint8_t* row = &m_cells[(size_t)y * m_width];
+    const uint8_t* top = y + 1 < m_height ? row + m_width : nullptr;
+    const uint8_t* bottom = y > 0 ? row - m_width : nullptr;
+    uint8_t* masks = &m_wallNeighbours[(size_t)y * m_width];
+    for (int64_t x = 0 ; x < width ; ++x)
+    {
+        masks[x] = isWall(row, x - 1, width) * WallLeft |
+                   isWall(row, x + 1, width) * WallRight |
+                   isWall(top, x, width) * WallTop |
+                   isWall(bottom, x, width) * WallBottom;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef CELLGRID_H
+#define CELLGRID_H
+
+#include "Core/Image.h"
+#include "Core/Foundations.h"
+
+#include <stdint.h>
+#include <vector>
+
+
+class CellGrid;
+
+DECLARE_PTR_TYPE(CellGrid);
+
+
+// Content of a cell, read from the color of its pixel in the level map (see LevelCell)
+enum class CellType : uint8_t
+{
+    Wall = 0,
+    Floor,
+    Door,
+    Water,
+    Entrance,
+    Exit,
+    Unknown
+};
+
+// Bits of the wall masks, set when the neighbour in that direction is a wall
+enum CellNeighbours : uint8_t
+{
+    WallLeft   = 1 << 0,  // x - 1
+    WallRight  = 1 << 1,  // x + 1
+    WallTop    = 1 << 2,  // y + 1
+    WallBottom = 1 << 3   // y - 1
+};
+
+
+// Level map classified once into one byte per cell, shared by the level loader, the navigation
+// and whatever builds geometry out of the map instead of comparing pixels again.
+// Cells outside of the map are walls.
+class CellGrid
+{
+public:
+    // Thread safe (the streamer workers read the level maps), the rows are classified in parallel on the JobSystem
+    // with the calling thread taking part. The map must not be modified meanwhile.
+    static CellGridPtr Create(const Image& map);
+
+    inline uint32_t GetWidth() const { return m_width; }
+    inline uint32_t GetHeight() const { return m_height; }
+
+    inline CellType GetCell(const int& x, const int& y) const
+    {
+        if (x < 0 || x >= (int)m_width || y < 0 || y >= (int)m_height)
+            return CellType::Wall;
+
+        return (CellType)m_cells[(size_t)y * m_width + x];
+    }
+
+    // Combination of CellNeighbours
+    inline uint8_t GetWallNeighbours(const int& x, const int& y) const { return m_wallNeighbours[(size_t)y * m_width + x]; }
+
+    // Row major cell types
+    inline const uint8_t* GetCells() const { return m_cells.data(); }
+
+private:
+    CellGrid(const uint32_t& width, const uint32_t& height);
+
+    void ClassifyRow(const Image& map, const uint32_t& y);
+    void ComputeWallNeighbours(const uint32_t& y);
+
+    uint32_t m_width;
+    uint32_t m_height;
+    std::vector<uint8_t> m_cells;
+    std::vector<uint8_t> m_wallNeighbours;
+};
+
+
+#endif // CELLGRID_H
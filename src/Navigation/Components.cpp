@@ -14,14 +14,14 @@ namespace Components {
 
 NavAgent::NavAgent(const Entity& entity) :
         Scripted("NavAgent", entity),
-        m_agent(Navigation::Engine::Get().CreateAgent())
+        m_agent(Navigation::Engine::Get().CreateAgent(entity.GetScene()))
 {
     
 }
 
 NavAgent::NavAgent(const NavAgent& other) :
         Scripted(other),
-        m_agent(Navigation::Engine::Get().CreateAgent())
+        m_agent(Navigation::Engine::Get().CreateAgent(other.GetEntity().GetScene()))
 {
 
 }
@@ -31,6 +31,26 @@ NavAgent::~NavAgent()
     Navigation::Engine::Get().RemoveAgent(m_agent);
 }
 
+void NavAgent::Rebind(const Entity& entity)
+{
+    Scripted::Rebind(entity);
+    if (m_agent->GetScene() != entity.GetScene())
+    {
+        ResetAgent();
+    }
+}
+
+void NavAgent::ResetAgent()
+{
+    const Entity& entity = GetEntity();
+    Navigation::Engine& engine = Navigation::Engine::Get();
+    Navigation::AgentPtr agent = engine.CreateAgent(entity.GetScene());
+    agent->SetSpeed(m_agent->GetSpeed());
+    agent->SetTransform(Transform::ComputeWorldMatrix(entity));
+    engine.RemoveAgent(m_agent);
+    m_agent = agent;
+}
+
 void NavAgent::OnUpdate()
 {
     const Entity& entity = GetEntity();
@@ -17,6 +17,11 @@ public:
     ~NavAgent();
 
     void OnUpdate() override;
+    // The agent is moved to the scene of the new entity
+    void Rebind(const Entity& entity) override;
+    // Replaces the agent by one without any path, which starts over from the transform of the entity.
+    // The agents are not journaled, they are reset once their scene has been rolled back.
+    void ResetAgent();
 
     Navigation::AgentPtr GetAgent();
 
@@ -1,7 +1,5 @@
 #include "Engine.h"
 
-#include "Resources/Loaders/LevelLoader.h"
-
 #include "Core/Logging.h"
 #include "Core/Time.h"
 
@@ -24,41 +22,48 @@ Engine& Engine::Init()
     return *s_instance;
 }
 
-void Engine::SetNavMap(const ImagePtr& navMap)
+void Engine::SetNavMap(const CellGridPtr& grid)
 {
-    m_navWidth = navMap->GetWidth();
-    m_navHeight = navMap->GetHeight();
-
-    uint32_t pixelCount = m_navWidth * m_navHeight;
-    m_navMap.resize(pixelCount);
-    
-    auto pixels = navMap->GetPixels();
-    for (size_t i=0 ; i < pixelCount ; ++i)
+    // Filters of each CellType
+    static const uint32_t cellFilters[] = {
+        CellFilters::Walls,   // Wall
+        CellFilters::Floor,   // Floor
+        CellFilters::Doors,   // Door
+        CellFilters::Water,   // Water
+        CellFilters::Floor,   // Entrance
+        CellFilters::Floor,   // Exit
+        CellFilters::None     // Unknown
+    };
+
+    m_navWidth = grid->GetWidth();
+    m_navHeight = grid->GetHeight();
+
+    // A larger map releases the previous one first, so that the level arena reuses its memory instead of growing
+    // on every floor switch. Smaller maps reuse the capacity.
+    uint32_t cellCount = m_navWidth * m_navHeight;
+    if (cellCount > m_navMap.capacity())
     {
-        const auto& pixel = pixels[i];
-        if (pixel == LevelCell::Wall)
-            m_navMap[i] = CellFilters::Walls;
-
-        else if (pixel == LevelCell::Floor || 
-                 pixel == LevelCell::Entrance || 
-                 pixel == LevelCell::Exit)
-            m_navMap[i] = CellFilters::Floor;
-
-        else if (pixel == LevelCell::Water)
-            m_navMap[i] = CellFilters::Water;
-
-        else if (pixel == LevelCell::Door)
-            m_navMap[i] = CellFilters::Doors;
+        decltype(m_navMap)(m_navMap.get_allocator()).swap(m_navMap);
+    }
+    m_navMap.resize(cellCount);
 
-        else 
-        {
-            m_navMap[i] = CellFilters::None;
-        }
+    const uint8_t* cells = grid->GetCells();
+    for (size_t i=0 ; i < cellCount ; ++i)
+    {
+        m_navMap[i] = cellFilters[cells[i]];
     }
 
     m_navMapHasChanged = true;
 }
 
+void Engine::ClearNavMap()
+{
+    // Swapping with an empty map, clear() would keep pointing to the level arena
+    decltype(m_navMap)(m_navMap.get_allocator()).swap(m_navMap);
+    m_navWidth = 0;
+    m_navHeight = 0;
+}
+
 uint32_t Engine::GetCell(const int& x, const int& y) const
 {
     if (x < 0 || x >= m_navWidth || -y < 0 || -y >= m_navHeight)
@@ -79,8 +84,21 @@ void Engine::OnUpdate()
         return;
     }
 
+    // The agents are updated outside of the lock, moving them looks up the other agents
+    std::vector<AgentPtr> agents;
+    {
+        std::lock_guard<std::mutex> lock(m_agentsMutex);
+        for (const auto& agent : m_agents)
+        {
+            if (agent->GetScene() == m_activeScene)
+            {
+                agents.push_back(agent);
+            }
+        }
+    }
+
     // Update disabled agents
-    for (const auto& agent : m_agents)
+    for (const auto& agent : agents)
     {
         if (agent->IsMoving())
         {
@@ -113,9 +131,11 @@ void Engine::ComputeAgentPath(const AgentPtr& agent)
     agent->SetPath(FindPath(glm::vec2(round(pos.x), round(pos.z)), glm::vec2(round(dest.x), round(dest.z))));
 }
 
-AgentPtr Engine::CreateAgent()
+AgentPtr Engine::CreateAgent(const Scene* scene)
 {
-    AgentPtr agent(new Agent);
+    AgentPtr agent(new Agent(scene));
+
+    std::lock_guard<std::mutex> lock(m_agentsMutex);
     m_agents.push_back(agent);
 
     return agent;
@@ -123,6 +143,7 @@ AgentPtr Engine::CreateAgent()
 
 void Engine::RemoveAgent(const AgentPtr& agent)
 {
+    std::lock_guard<std::mutex> lock(m_agentsMutex);
     const auto it = std::find(m_agents.begin(), m_agents.end(), agent);
     if (it != m_agents.end())
     {
@@ -139,8 +160,14 @@ bool Engine::CellIsEmpty(const glm::vec2& cell,
 
 bool Engine::CellContainsAgent(const glm::vec2& cell)
 {
+    std::lock_guard<std::mutex> lock(m_agentsMutex);
     for (const auto& agent : m_agents)
     {
+        if (agent->GetScene() != m_activeScene)
+        {
+            continue;
+        }
+
         const glm::vec4& position = agent->GetTransform()[3];
         if (cell == glm::vec2(round(position.x), round(position.z)))
         {
@@ -225,12 +252,17 @@ bool Engine::CanSeeCell(glm::vec2 source,
 
 std::vector<glm::vec2> Engine::ReconstructPath(const Cell& end) const
 {
-    std::vector<glm::vec2> result {end.pos};
-    const Cell* cell = end.previous;
-    while (cell)
+    size_t length = 0;
+    for (const Cell* cell = &end ; cell ; cell = cell->previous)
     {
-        result.insert(result.begin(), cell->pos);
-        cell = cell->previous;
+        length++;
+    }
+
+    // Filling the path from its end
+    std::vector<glm::vec2> result(length);
+    for (const Cell* cell = &end ; cell ; cell = cell->previous)
+    {
+        result[--length] = cell->pos;
     }
     return result;
 }
@@ -248,10 +280,23 @@ std::vector<glm::vec2> Engine::FindPath(const glm::vec2& startPos, const glm::ve
         return {};
     }
 
-    std::unordered_map<glm::vec2, Cell*> openedCells;
-    openedCells.insert({startPos, new Cell{startPos, 0, CostHeuristic(startPos, endPos)}});
+    // The search only lasts for the frame, its containers live in the frame arena
+    typedef std::unordered_map<glm::vec2, Cell*, std::hash<glm::vec2>, std::equal_to<glm::vec2>,
+                               ArenaAllocator<std::pair<const glm::vec2, Cell*>>> CellMap;
+    LinearArena& arena = Memory::GetFrameArena();
+
+    // Every cell is released at the end of the search, even those replaced by a better path
+    std::vector<Cell*, ArenaAllocator<Cell*>> cells(arena);
+    cells.reserve(256);
+    auto createCell = [&](const glm::vec2& pos, const uint32_t& gCost, const uint32_t& fCost, Cell* previous) {
+        cells.push_back(m_cellPool.Acquire(pos, gCost, fCost, previous));
+        return cells.back();
+    };
+
+    CellMap openedCells(64, std::hash<glm::vec2>(), std::equal_to<glm::vec2>(), arena);
+    openedCells.insert({startPos, createCell(startPos, 0, CostHeuristic(startPos, endPos), nullptr)});
 
-    std::unordered_map<glm::vec2, Cell*> closedCells;
+    CellMap closedCells(64, std::hash<glm::vec2>(), std::equal_to<glm::vec2>(), arena);
 
     std::vector<glm::vec2> result;
     while (!openedCells.empty())
@@ -295,16 +340,16 @@ std::vector<glm::vec2> Engine::FindPath(const glm::vec2& startPos, const glm::ve
                 continue;
 
             // This is the best path to this cell so far, adding it to the queue
-            openedCells[pos] = new Cell{pos, gCost, fCost, currentCell};
+            openedCells[pos] = createCell(pos, gCost, fCost, currentCell);
         }
 
         closedCells[currentCell->pos] = currentCell;
     }
 
     // Cleanup temporary data
-    for (const auto &it : closedCells)
+    for (Cell* cell : cells)
     {
-        delete it.second;
+        m_cellPool.Release(cell);
     }
 
     return result;
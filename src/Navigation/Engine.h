@@ -2,11 +2,13 @@
 #define NAVIGATIONENGINE_H
 
 #include "Agent.h"
+#include "CellGrid.h"
 
-#include "Core/Image.h"
+#include "Core/Memory.h"
 
 #include "Utils/TypeUtils.h"
 
+#include <mutex>
 #include <vector>
 
 
@@ -47,7 +49,11 @@ public:
     static Engine& Init();
     inline static Engine& Get() { return *s_instance; }
 
-    void SetNavMap(const ImagePtr& navMap);
+    void SetNavMap(const CellGridPtr& grid);
+    // Must be called before releasing the level arena
+    void ClearNavMap();
+    // Scene being played, the agents of the other scenes (floors built in the background) are ignored
+    inline void SetActiveScene(const Scene* scene) { m_activeScene = scene; }
     void SetCell(const int& x, const int& y, const CellFilters& value);
 
     void OnUpdate();
@@ -61,7 +67,7 @@ public:
                     glm::vec2 target, 
                     const CellFilters& filter=CellFilters::Vision);
 
-    AgentPtr CreateAgent();
+    AgentPtr CreateAgent(const Scene* scene);
     void RemoveAgent(const AgentPtr& agent);
 
 private:
@@ -74,12 +80,19 @@ private:
 
     std::vector<glm::vec2> ReconstructPath(const Cell& end) const;
 
-    std::vector<uint32_t> m_navMap;
+    // Nodes of the searches, recycled from one search to the other
+    mutable ObjectPool<Cell> m_cellPool;
+
+    // The nav map lives as long as the level, its memory is released along with the level arena
+    std::vector<uint32_t, ArenaAllocator<uint32_t>> m_navMap {ArenaAllocator<uint32_t>(Memory::GetLevelArena())};
     uint32_t m_navWidth;
     uint32_t m_navHeight;
     bool m_navMapHasChanged = false;
 
+    // Agents are also created and removed by the floors built on the job system
     std::vector<AgentPtr> m_agents;
+    std::mutex m_agentsMutex;
+    const Scene* m_activeScene = nullptr;
 
     static Engine* s_instance;
 };
@@ -0,0 +1,127 @@
+#include "FrameBudget.h"
+
+#include "Core/Logging.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+FrameBudget::FrameBudget(const FrameBudgetSettings& settings, const uint32_t& samples) :
+        m_settings(settings),
+        m_averageFrameTime(settings.targetFrameTime),
+        m_resolutionScale(settings.maxResolutionScale),
+        m_cooldown(settings.cooldownFrames)
+{
+    SetSamples(samples);
+}
+
+void FrameBudget::SetSettings(const FrameBudgetSettings& settings)
+{
+    uint32_t samples = GetSamples();
+
+    m_settings = settings;
+    m_resolutionScale = std::clamp(m_resolutionScale, settings.minResolutionScale, settings.maxResolutionScale);
+    SetSamples(samples);
+}
+
+uint32_t FrameBudget::GetSamples() const
+{
+    if (m_settings.sampleLevels.empty())
+    {
+        return 1;
+    }
+
+    return m_settings.sampleLevels[m_sampleLevel];
+}
+
+void FrameBudget::SetSamples(const uint32_t& samples)
+{
+    // Picking the highest level that doesn't exceed the requested samples
+    m_sampleLevel = 0;
+    for (uint32_t level = 0 ; level < m_settings.sampleLevels.size() ; ++level)
+    {
+        if (m_settings.sampleLevels[level] <= samples)
+        {
+            m_sampleLevel = level;
+        }
+    }
+}
+
+bool FrameBudget::Update(const float& frameTime)
+{
+    if (!m_enabled)
+    {
+        return false;
+    }
+
+    // Clamping the outliers (loading screens, window moves...) so that they don't take over the average
+    float clampedTime = std::min(frameTime, m_settings.targetFrameTime * 4.0f);
+    m_averageFrameTime += (clampedTime - m_averageFrameTime) * m_settings.smoothing;
+
+    if (m_cooldown)
+    {
+        m_cooldown--;
+        return false;
+    }
+
+    float ratio = m_averageFrameTime / m_settings.targetFrameTime;
+    m_overBudgetFrames = ratio > m_settings.downgradeThreshold ? m_overBudgetFrames + 1 : 0;
+    m_underBudgetFrames = ratio < m_settings.upgradeThreshold ? m_underBudgetFrames + 1 : 0;
+
+    bool changed = false;
+    if (m_overBudgetFrames >= m_settings.sustainFrames)
+    {
+        changed = Downgrade();
+    }
+    else if (m_underBudgetFrames >= m_settings.sustainFrames)
+    {
+        changed = Upgrade();
+    }
+
+    if (changed)
+    {
+        m_overBudgetFrames = 0;
+        m_underBudgetFrames = 0;
+        m_cooldown = m_settings.cooldownFrames;
+
+        LOG_INFO("Frame budget: %.2fms average, rendering at %d%% with %dx MSAA", 
+                 m_averageFrameTime * 1000.0f, (int)std::round(m_resolutionScale * 100.0f), GetSamples());
+    }
+
+    return changed;
+}
+
+bool FrameBudget::Downgrade()
+{
+    if (m_sampleLevel > 0)
+    {
+        m_sampleLevel--;
+        return true;
+    }
+
+    if (m_resolutionScale > m_settings.minResolutionScale)
+    {
+        m_resolutionScale = std::max(m_settings.minResolutionScale, m_resolutionScale - m_settings.resolutionScaleStep);
+        return true;
+    }
+
+    return false;
+}
+
+bool FrameBudget::Upgrade()
+{
+    // Going back up in the opposite order
+    if (m_resolutionScale < m_settings.maxResolutionScale)
+    {
+        m_resolutionScale = std::min(m_settings.maxResolutionScale, m_resolutionScale + m_settings.resolutionScaleStep);
+        return true;
+    }
+
+    if (m_sampleLevel + 1 < m_settings.sampleLevels.size())
+    {
+        m_sampleLevel++;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,69 @@
+#ifndef FRAMEBUDGET_H
+#define FRAMEBUDGET_H
+
+#include <stdint.h>
+#include <vector>
+
+
+struct FrameBudgetSettings
+{
+    float targetFrameTime = 1.0f / 60.0f;
+
+    // Ratios of the target frame time outside of which the quality is changed
+    float downgradeThreshold = 1.05f;
+    float upgradeThreshold = 0.75f;
+
+    // Number of consecutive frames the average has to stay outside of the thresholds before acting
+    uint32_t sustainFrames = 30;
+    // Number of frames to wait after a change, to let the average reflect the new settings
+    uint32_t cooldownFrames = 60;
+    float smoothing = 0.1f;
+
+    float minResolutionScale = 0.5f;
+    float maxResolutionScale = 1.0f;
+    float resolutionScaleStep = 0.125f;
+
+    // Allowed MSAA sample counts, sorted in increasing order
+    std::vector<uint32_t> sampleLevels = {1, 2, 4, 8};
+};
+
+
+// Watches the frame times and lowers or raises the render quality to stay within the frame budget.
+// The MSAA samples are the first thing to go, followed by the render resolution.
+class FrameBudget
+{
+public:
+    FrameBudget(const FrameBudgetSettings& settings={}, const uint32_t& samples=8);
+
+    // Returns true if the resolution scale or the samples changed
+    bool Update(const float& frameTime);
+
+    inline bool IsEnabled() const { return m_enabled; }
+    inline void SetEnabled(const bool& enabled) { m_enabled = enabled; }
+
+    inline const FrameBudgetSettings& GetSettings() const { return m_settings; }
+    void SetSettings(const FrameBudgetSettings& settings);
+
+    inline float GetAverageFrameTime() const { return m_averageFrameTime; }
+    inline float GetResolutionScale() const { return m_resolutionScale; }
+    uint32_t GetSamples() const;
+    void SetSamples(const uint32_t& samples);
+
+private:
+    bool Downgrade();
+    bool Upgrade();
+
+    FrameBudgetSettings m_settings;
+    bool m_enabled = true;
+
+    float m_averageFrameTime = 0.0f;
+    float m_resolutionScale = 1.0f;
+    uint32_t m_sampleLevel = 0;
+
+    uint32_t m_overBudgetFrames = 0;
+    uint32_t m_underBudgetFrames = 0;
+    uint32_t m_cooldown = 0;
+};
+
+
+#endif  // FRAMEBUDGET_H
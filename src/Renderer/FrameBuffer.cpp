@@ -42,7 +42,7 @@ FrameBuffer::FrameBuffer(const FrameBufferSpecs& specs) :
 
 FrameBuffer::~FrameBuffer()
 {
-    glDeleteFramebuffers(1, &m_id);
+    DeleteAttachments();
 }
 
 void FrameBuffer::Bind() const
@@ -84,12 +84,23 @@ void FrameBuffer::Resize(const uint32_t& width, const uint32_t& height)
     GenerateAttachments();
 }
 
-void FrameBuffer::Blit(const GLuint& destFrameBufferId, const uint32_t& destWidth, const uint32_t& destHeight) const
+void FrameBuffer::Resize(const uint32_t& width, const uint32_t& height, const uint32_t& samples)
+{
+    m_specs.width = width;
+    m_specs.height = height;
+    m_specs.samples = samples;
+
+    GenerateAttachments();
+}
+
+void FrameBuffer::Blit(const GLuint& destFrameBufferId, const uint32_t& destWidth, const uint32_t& destHeight,
+                       const GLbitfield& mask, const GLenum& filter) const
 {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_id);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destFrameBufferId);
     glBlitFramebuffer(0, 0, m_specs.width, m_specs.height, 
                       0, 0, destWidth, destHeight, 
-                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                      mask, filter);
 
     // Restore the current framebuffer as the drawing buffer
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_id);
@@ -128,16 +139,7 @@ void FrameBuffer::AttachTexture(const GLenum& slot, const GLuint id,
 void FrameBuffer::GenerateAttachments()
 {
     // Cleanup the previous buffers
-    if (m_id) 
-    {
-        glDeleteFramebuffers(1, &m_id);
-        glDeleteTextures(m_colorAttachments.size(), m_colorAttachments.data());
-        glDeleteTextures(1, &m_depthAttachment);
-
-        m_id = 0;
-        m_colorAttachments.clear();
-        m_depthAttachment = 0;
-    }
+    DeleteAttachments();
 
     glGenFramebuffers(1, &m_id); 
     glBindFramebuffer(GL_FRAMEBUFFER, m_id);
@@ -171,6 +173,25 @@ void FrameBuffer::GenerateAttachments()
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+void FrameBuffer::DeleteAttachments()
+{
+    if (!m_id)
+    {
+        return;
+    }
+
+    glDeleteFramebuffers(1, &m_id);
+    glDeleteTextures(m_colorAttachments.size(), m_colorAttachments.data());
+    if (m_depthAttachment)
+    {
+        glDeleteTextures(1, &m_depthAttachment);
+    }
+
+    m_id = 0;
+    m_colorAttachments.clear();
+    m_depthAttachment = 0;
+}
+
 FrameBufferPtr FrameBuffer::Create(const FrameBufferSpecs& specs)
 {
     return FrameBufferPtr(new FrameBuffer(specs));
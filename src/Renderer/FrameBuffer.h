@@ -4,6 +4,8 @@
 
 #include "Core/Foundations.h"
 
+#include "Utils/TypeUtils.h"
+
 #include <glad/glad.h>
 
 #include <vector>
@@ -21,6 +23,34 @@ struct FrameBufferSpecs
 
     std::vector<GLenum> colorFormats = {GL_RGBA8};
     GLenum depthFormat = GL_DEPTH24_STENCIL8;
+
+    inline bool operator==(const FrameBufferSpecs& other) const
+    {
+        return width == other.width && height == other.height && samples == other.samples && 
+               colorFormats == other.colorFormats && depthFormat == other.depthFormat;
+    }
+    inline bool operator!=(const FrameBufferSpecs& other) const { return !(*this == other); }
+};
+
+
+// Mandatory to use FrameBufferSpecs as a key of unordered_maps
+template <>
+struct std::hash<FrameBufferSpecs>
+{
+    std::size_t operator()(const FrameBufferSpecs& specs) const
+    {
+        size_t hash = 0;
+        HashCombine(hash, specs.width);
+        HashCombine(hash, specs.height);
+        HashCombine(hash, specs.samples);
+        for (const GLenum& format : specs.colorFormats)
+        {
+            HashCombine(hash, format);
+        }
+        HashCombine(hash, specs.depthFormat);
+
+        return hash;
+    }
 };
 
 
@@ -42,7 +72,9 @@ public:
     GLuint GetDepthAttachmentId() const;
 
     void Resize(const uint32_t& width, const uint32_t& height);
-    void Blit(const GLuint& destFrameBufferId, const uint32_t& destWidth, const uint32_t& destHeight) const;
+    void Resize(const uint32_t& width, const uint32_t& height, const uint32_t& samples);
+    void Blit(const GLuint& destFrameBufferId, const uint32_t& destWidth, const uint32_t& destHeight,
+              const GLbitfield& mask=GL_COLOR_BUFFER_BIT, const GLenum& filter=GL_NEAREST) const;
 
     static FrameBufferPtr Create(const FrameBufferSpecs& specs);
 
@@ -54,6 +86,7 @@ private:
     void AttachTexture(const GLenum& slot, const GLuint id, 
                        const GLenum& internalFormat);
     void GenerateAttachments();
+    void DeleteAttachments();
 
     GLuint m_id = 0;
     
@@ -62,7 +95,7 @@ private:
     
     // Texture attachments ids
     std::vector<GLuint> m_colorAttachments;
-    GLuint m_depthAttachment;
+    GLuint m_depthAttachment = 0;
 };
 
 #endif  // FRAMEBUFFER_H
\ No newline at end of file
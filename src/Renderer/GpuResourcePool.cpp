@@ -0,0 +1,138 @@
+#include "GpuResourcePool.h"
+
+#include "Utils/TypeUtils.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+template <typename T, typename MatchFn, typename CreateFn>
+std::shared_ptr<T> GpuResourcePool::Acquire(Pool<T>& pool, 
+                                            const size_t& key, 
+                                            const MatchFn& matches, 
+                                            const CreateFn& create)
+{
+    auto& entries = pool[key];
+    for (auto& entry : entries)
+    {
+        // The pool is the only owner of the object, it can be handed over again
+        if (entry.object.use_count() == 1 && matches(*entry.object))
+        {
+            entry.lastUsedFrame = m_frame;
+            return entry.object;
+        }
+    }
+
+    m_allocationCount++;
+    m_frameAllocationCount++;
+
+    entries.push_back({create(), m_frame});
+    return entries.back().object;
+}
+
+template <typename T>
+void GpuResourcePool::Evict(Pool<T>& pool)
+{
+    for (auto it = pool.begin() ; it != pool.end() ; )
+    {
+        auto& entries = it->second;
+        entries.erase(std::remove_if(entries.begin(), entries.end(), 
+                                     [this](const PoolEntry<T>& entry) 
+                                     { 
+                                         return entry.object.use_count() == 1 && 
+                                                m_frame - entry.lastUsedFrame > m_maxUnusedFrames; 
+                                     }),
+                      entries.end());
+
+        if (entries.empty())
+            it = pool.erase(it);
+        else
+            it++;
+    }
+}
+
+VertexArrayPtr GpuResourcePool::AcquireVertexArray()
+{
+    // Empty VertexArrays are all equivalent, they are used to issue buffer-less draws
+    return Acquire(m_vertexArrays, 0,
+                   [](const VertexArray& vertexArray) { return vertexArray.GetVertexBuffers().empty(); },
+                   []() { return VertexArray::Create(); });
+}
+
+FrameBufferPtr GpuResourcePool::AcquireFrameBuffer(const FrameBufferSpecs& specs)
+{
+    return Acquire(m_frameBuffers, std::hash<FrameBufferSpecs>()(specs),
+                   [&specs](const FrameBuffer& frameBuffer) { return frameBuffer.GetSpecs() == specs; },
+                   [&specs]() { return FrameBuffer::Create(specs); });
+}
+
+TexturePtr GpuResourcePool::AcquireTexture(const uint32_t& width, 
+                                           const uint32_t& height, 
+                                           const GLenum& internalFormat)
+{
+    size_t key = 0;
+    HashCombine(key, width);
+    HashCombine(key, height);
+    HashCombine(key, internalFormat);
+
+    return Acquire(m_textures, key,
+                   [&](const Texture& texture) 
+                   { 
+                       return texture.GetWidth() == width && 
+                              texture.GetHeight() == height && 
+                              texture.GetInternalFormat() == internalFormat; 
+                   },
+                   [&]() { return Texture::Create(width, height, internalFormat); });
+}
+
+void GpuResourcePool::RekeyFrameBuffers()
+{
+    std::vector<PoolEntry<FrameBuffer>> resized;
+    for (auto& [key, entries] : m_frameBuffers)
+    {
+        auto it = std::partition(entries.begin(), entries.end(), [key = key](const PoolEntry<FrameBuffer>& entry)
+        {
+            return std::hash<FrameBufferSpecs>()(entry.object->GetSpecs()) == key;
+        });
+        std::move(it, entries.end(), std::back_inserter(resized));
+        entries.erase(it, entries.end());
+    }
+
+    for (auto& entry : resized)
+    {
+        size_t key = std::hash<FrameBufferSpecs>()(entry.object->GetSpecs());
+        m_frameBuffers[key].push_back(std::move(entry));
+    }
+}
+
+void GpuResourcePool::NextFrame()
+{
+    m_frame++;
+    m_frameAllocationCount = 0;
+
+    RekeyFrameBuffers();
+
+    Evict(m_vertexArrays);
+    Evict(m_frameBuffers);
+    Evict(m_textures);
+}
+
+void GpuResourcePool::Clear()
+{
+    m_vertexArrays.clear();
+    m_frameBuffers.clear();
+    m_textures.clear();
+}
+
+uint32_t GpuResourcePool::GetPooledCount() const
+{
+    uint32_t count = 0;
+    for (const auto& [key, entries] : m_vertexArrays)
+        count += entries.size();
+    for (const auto& [key, entries] : m_frameBuffers)
+        count += entries.size();
+    for (const auto& [key, entries] : m_textures)
+        count += entries.size();
+
+    return count;
+}
@@ -0,0 +1,76 @@
+#ifndef GPURESOURCEPOOL_H
+#define GPURESOURCEPOOL_H
+
+#include "FrameBuffer.h"
+#include "Texture.h"
+#include "VertexArray.h"
+
+#include <unordered_map>
+#include <vector>
+
+
+// The GpuResourcePool keeps the transient GPU objects of the Renderer (full screen VertexArrays,
+// intermediate FrameBuffers, render Textures) alive across frames so that they can be recycled 
+// instead of being allocated and freed every frame.
+// Objects are keyed by their specs, and an object is considered available again as soon as
+// the pool holds the only reference to it.
+class GpuResourcePool
+{
+public:
+    GpuResourcePool() = default;
+    ~GpuResourcePool() = default;
+    GpuResourcePool(const GpuResourcePool&) = delete;
+
+    VertexArrayPtr AcquireVertexArray();
+    FrameBufferPtr AcquireFrameBuffer(const FrameBufferSpecs& specs);
+    TexturePtr AcquireTexture(const uint32_t& width, 
+                              const uint32_t& height, 
+                              const GLenum& internalFormat);
+
+    // Frees the objects that haven't been acquired for more than GetMaxUnusedFrames() frames
+    void NextFrame();
+    void Clear();
+
+    // Allocation counters, used to check the frame to frame GL object churn
+    inline uint64_t GetAllocationCount() const { return m_allocationCount; }
+    inline uint32_t GetFrameAllocationCount() const { return m_frameAllocationCount; }
+    uint32_t GetPooledCount() const;
+
+    inline uint32_t GetMaxUnusedFrames() const { return m_maxUnusedFrames; }
+    inline void SetMaxUnusedFrames(const uint32_t& frames) { m_maxUnusedFrames = frames; }
+
+private:
+    template <typename T>
+    struct PoolEntry
+    {
+        std::shared_ptr<T> object;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    template <typename T>
+    using Pool = std::unordered_map<size_t, std::vector<PoolEntry<T>>>;
+
+    template <typename T, typename MatchFn, typename CreateFn>
+    std::shared_ptr<T> Acquire(Pool<T>& pool, 
+                               const size_t& key, 
+                               const MatchFn& matches, 
+                               const CreateFn& create);
+
+    template <typename T>
+    void Evict(Pool<T>& pool);
+    // Moves the FrameBuffers resized since they were acquired to the entries of their new specs
+    void RekeyFrameBuffers();
+
+    Pool<VertexArray> m_vertexArrays;
+    Pool<FrameBuffer> m_frameBuffers;
+    Pool<Texture> m_textures;
+
+    uint64_t m_frame = 0;
+    uint32_t m_maxUnusedFrames = 4;
+
+    uint64_t m_allocationCount = 0;
+    uint32_t m_frameAllocationCount = 0;
+};
+
+
+#endif  // GPURESOURCEPOOL_H
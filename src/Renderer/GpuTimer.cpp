@@ -0,0 +1,67 @@
+#include "GpuTimer.h"
+
+
+GpuTimer::~GpuTimer()
+{
+    if (m_queries[0])
+    {
+        glDeleteQueries(QUERY_COUNT, m_queries.data());
+    }
+}
+
+void GpuTimer::Begin()
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    if (!m_queries[0])
+    {
+        glGenQueries(QUERY_COUNT, m_queries.data());
+    }
+
+    // Collecting the results that became available since the last frames
+    for (uint32_t i = 1 ; i <= QUERY_COUNT ; ++i)
+    {
+        uint32_t index = (m_current + i) % QUERY_COUNT;
+        if (!m_pending[index])
+        {
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            continue;
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(m_queries[index], GL_QUERY_RESULT, &elapsed);
+        m_elapsedTime = elapsed * 1e-9;
+        m_pending[index] = false;
+    }
+
+    // Skipping the frame if all the queries are still in flight
+    m_current = (m_current + 1) % QUERY_COUNT;
+    if (m_pending[m_current])
+    {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_current]);
+    m_running = true;
+}
+
+void GpuTimer::End()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_current] = true;
+    m_running = false;
+}
@@ -0,0 +1,36 @@
+#ifndef GPUTIMER_H
+#define GPUTIMER_H
+
+#include <glad/glad.h>
+
+#include <array>
+
+
+// Measures the GPU time spent between Begin() and End() using timer queries.
+// Results are read a few frames later so that querying them never stalls the pipeline.
+class GpuTimer
+{
+public:
+    GpuTimer() = default;
+    ~GpuTimer();
+    GpuTimer(const GpuTimer&) = delete;
+
+    void Begin();
+    void End();
+
+    // Last available measure, in seconds
+    inline double GetElapsedTime() const { return m_elapsedTime; }
+
+private:
+    static constexpr uint32_t QUERY_COUNT = 4;
+
+    std::array<GLuint, QUERY_COUNT> m_queries = {};
+    std::array<bool, QUERY_COUNT> m_pending = {};
+    uint32_t m_current = 0;
+    bool m_running = false;
+
+    double m_elapsedTime = 0.0;
+};
+
+
+#endif  // GPUTIMER_H
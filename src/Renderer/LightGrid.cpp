@@ -0,0 +1,173 @@
+#include "LightGrid.h"
+
+#include "Scene/Components/Basics.h"
+#include "Scene/Components/Lights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+// Radiance under which a light is considered as not contributing anymore
+#define LIGHT_CUTOFF_RADIANCE 0.01f
+#define MAX_LIGHT_RADIUS 64.0f
+#define MAX_CLUSTERS_PER_AXIS 64
+
+
+float LightGrid::ComputeLightRadius(const glm::vec3& color, const float& decay)
+{
+    float maxRadiance = std::max(color.x, std::max(color.y, color.z));
+    if (maxRadiance <= LIGHT_CUTOFF_RADIANCE)
+    {
+        return 0.0f;
+    }
+    if (decay <= 0.0f)
+    {
+        return MAX_LIGHT_RADIUS;
+    }
+
+    // Solving radiance / (distance + 1)^decay = cutoff
+    float radius = std::pow(maxRadiance / LIGHT_CUTOFF_RADIANCE, 1.0f / decay) - 1.0f;
+    return std::min(radius, MAX_LIGHT_RADIUS);
+}
+
+void LightGrid::Build(const ScenePtr& scene, Data& outData) const
+{
+    std::vector<GpuPointLight>& lights = outData.lights;
+    std::vector<uint32_t>& clusterData = outData.clusterData;
+    ClustersHeader& header = outData.header;
+    lights.clear();
+    clusterData.clear();
+
+    // Gathering the lights
+    glm::vec2 boundsMin(std::numeric_limits<float>::max());
+    glm::vec2 boundsMax(std::numeric_limits<float>::lowest());
+    for (Entity entity : scene->Traverse())
+    {
+        auto* pointLight = entity.ReadComponent<Components::PointLight>();
+        if (!pointLight)
+        {
+            continue;
+        }
+
+        glm::vec3 color = pointLight->color * pointLight->intensity;
+        float radius = ComputeLightRadius(color, pointLight->decay);
+        if (radius <= 0.0f)
+        {
+            continue;
+        }
+
+        glm::vec3 position = Components::Transform::ComputeWorldMatrix(entity)[3];
+        lights.push_back({position, pointLight->decay, color, radius});
+
+        boundsMin = glm::min(boundsMin, glm::vec2(position.x, position.z) - radius);
+        boundsMax = glm::max(boundsMax, glm::vec2(position.x, position.z) + radius);
+    }
+
+    header.lightCount = lights.size();
+    if (lights.empty())
+    {
+        header.origin = glm::vec2(0.0f);
+        header.clusterSize = m_minClusterSize;
+        header.clusterCount = glm::uvec2(0);
+        return;
+    }
+
+    // Fitting the grid to the area reached by the lights, growing the clusters if it becomes too large
+    glm::vec2 extent = boundsMax - boundsMin;
+    float clusterSize = std::max(m_minClusterSize, 
+                                 std::max(extent.x, extent.y) / MAX_CLUSTERS_PER_AXIS);
+    glm::uvec2 clusterCount = glm::max(glm::uvec2(glm::ceil(extent / clusterSize)), glm::uvec2(1));
+
+    header.origin = boundsMin;
+    header.clusterSize = clusterSize;
+    header.clusterCount = clusterCount;
+
+    auto clusterRange = [&](const GpuPointLight& light, glm::uvec2& first, glm::uvec2& last)
+    {
+        glm::vec2 center(light.position.x, light.position.z);
+        glm::ivec2 minCluster(glm::floor((center - light.radius - boundsMin) / clusterSize));
+        glm::ivec2 maxCluster(glm::floor((center + light.radius - boundsMin) / clusterSize));
+        first = glm::uvec2(glm::clamp(minCluster, glm::ivec2(0), glm::ivec2(clusterCount) - 1));
+        last = glm::uvec2(glm::clamp(maxCluster, glm::ivec2(0), glm::ivec2(clusterCount) - 1));
+    };
+
+    // First pass counts the lights per cluster, the second one fills the light indices
+    uint32_t clustersCount = clusterCount.x * clusterCount.y;
+    clusterData.resize(clustersCount * 2, 0);
+    glm::uvec2 first, last;
+    for (const auto& light : lights)
+    {
+        clusterRange(light, first, last);
+        for (uint32_t y = first.y ; y <= last.y ; ++y)
+            for (uint32_t x = first.x ; x <= last.x ; ++x)
+                clusterData[(y * clusterCount.x + x) * 2 + 1]++;
+    }
+
+    uint32_t offset = clustersCount * 2;
+    for (uint32_t i = 0 ; i < clustersCount ; ++i)
+    {
+        clusterData[i * 2] = offset;
+        offset += clusterData[i * 2 + 1];
+        clusterData[i * 2 + 1] = 0;
+    }
+    clusterData.resize(offset);
+
+    for (uint32_t lightIndex = 0 ; lightIndex < lights.size() ; ++lightIndex)
+    {
+        clusterRange(lights[lightIndex], first, last);
+        for (uint32_t y = first.y ; y <= last.y ; ++y)
+        {
+            for (uint32_t x = first.x ; x <= last.x ; ++x)
+            {
+                uint32_t cluster = (y * clusterCount.x + x) * 2;
+                clusterData[clusterData[cluster] + clusterData[cluster + 1]++] = lightIndex;
+            }
+        }
+    }
+}
+
+void LightGrid::Upload(const Data& data)
+{
+    m_header = data.header;
+
+    // Buffers are never left empty as binding a zero sized storage is invalid
+    uint32_t lightsSize = std::max<uint32_t>(data.lights.size(), 1) * sizeof(GpuPointLight);
+    if (!m_lightsBuffer)
+    {
+        m_lightsBuffer = StorageBuffer::Create(lightsSize);
+    }
+    m_lightsBuffer->Bind();
+    m_lightsBuffer->Resize(std::max(lightsSize, m_lightsBuffer->GetSize()));
+    if (!data.lights.empty())
+    {
+        m_lightsBuffer->SetData(data.lights.data(), data.lights.size() * sizeof(GpuPointLight), 0);
+    }
+
+    uint32_t dataSize = data.clusterData.size() * sizeof(uint32_t);
+    uint32_t clustersSize = sizeof(ClustersHeader) + std::max<uint32_t>(dataSize, sizeof(uint32_t));
+    if (!m_clustersBuffer)
+    {
+        m_clustersBuffer = StorageBuffer::Create(clustersSize);
+    }
+    m_clustersBuffer->Bind();
+    m_clustersBuffer->Resize(std::max(clustersSize, m_clustersBuffer->GetSize()));
+    m_clustersBuffer->SetData(&m_header, sizeof(ClustersHeader), 0);
+    if (dataSize)
+    {
+        m_clustersBuffer->SetData(data.clusterData.data(), dataSize, sizeof(ClustersHeader));
+    }
+    m_clustersBuffer->Unbind();
+}
+
+void LightGrid::Attach() const
+{
+    if (m_lightsBuffer)
+    {
+        m_lightsBuffer->Attach(POINT_LIGHTS_BINDING);
+    }
+    if (m_clustersBuffer)
+    {
+        m_clustersBuffer->Attach(LIGHT_CLUSTERS_BINDING);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef LIGHTGRID_H
+#define LIGHTGRID_H
+
+#include "StorageBuffer.h"
+
+#include "Scene/Scene.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+
+// Shader storage bindings shared by all the lit shaders
+#define POINT_LIGHTS_BINDING 1
+#define LIGHT_CLUSTERS_BINDING 2
+
+
+// Gathers the PointLight components of a scene and bins them into a 2D grid of clusters
+// laid on the XZ plane, so that each fragment only evaluates the lights that can reach it.
+class LightGrid
+{
+public:
+    // Layouts matching the std430 blocks declared in the lit shaders
+    struct GpuPointLight
+    {
+        glm::vec3 position;
+        float decay;
+        glm::vec3 color;
+        float radius;
+    };
+
+    struct ClustersHeader
+    {
+        glm::vec2 origin;
+        float clusterSize;
+        uint32_t lightCount;
+        glm::uvec2 clusterCount;
+    };
+
+    // Lights of a frame binned into the clusters, built with the rest of the frame snapshot
+    struct Data
+    {
+        std::vector<GpuPointLight> lights;
+
+        // Holds an (offset, count) pair per cluster followed by the light indices of all the clusters
+        std::vector<uint32_t> clusterData;
+        ClustersHeader header = {glm::vec2(0.0f), 1.0f, 0, glm::uvec2(0)};
+
+        inline void Clear() { lights.clear(); clusterData.clear(); }
+    };
+
+    LightGrid() = default;
+
+    // Doesn't touch any GL object, it can run outside of the GL thread
+    void Build(const ScenePtr& scene, Data& outData) const;
+    void Upload(const Data& data);
+    void Attach() const;
+
+    // Counts of the last upload
+    inline uint32_t GetLightCount() const { return m_header.lightCount; }
+    inline glm::uvec2 GetClusterCount() const { return m_header.clusterCount; }
+
+    inline float GetClusterSize() const { return m_minClusterSize; }
+    inline void SetClusterSize(const float& size) { m_minClusterSize = size; }
+
+    // Distance at which the light contribution falls under the cutoff radiance
+    static float ComputeLightRadius(const glm::vec3& color, const float& decay);
+
+private:
+    ClustersHeader m_header = {glm::vec2(0.0f), 1.0f, 0, glm::uvec2(0)};
+
+    float m_minClusterSize = 4.0f;
+
+    StorageBufferPtr m_lightsBuffer;
+    StorageBufferPtr m_clustersBuffer;
+};
+
+#endif  // LIGHTGRID_H
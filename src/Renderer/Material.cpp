@@ -56,7 +56,7 @@ void Material::SetInputTexture(const std::string& name, const TexturePtr& textur
     const auto binding = MATERIAL_TEXTURE_MAPPING.find(name);
     if (binding != MATERIAL_TEXTURE_MAPPING.end())
     {
-        m_textureBindings[binding->second] = texture->GetId();
+        m_textureBindings[binding->second] = texture;
     }
 }
 
@@ -77,7 +77,7 @@ void Material::RemoveInputTexture(const std::string& name)
     const auto binding = MATERIAL_TEXTURE_MAPPING.find(name);
     if (binding != MATERIAL_TEXTURE_MAPPING.end())
     {
-        m_textureBindings[binding->second] = 0;
+        m_textureBindings[binding->second] = nullptr;
     }
 }
 
@@ -98,12 +98,21 @@ void Material::ApplyUniforms() const
 {
     m_uniformBuffer->Attach(m_uniformBlock.index);
     
-    std::string uTexture = "uTexture[";
+    // Names of the sampler uniforms, built once instead of on every draw
+    static const std::vector<std::string> textureUniforms = []() {
+        std::vector<std::string> names;
+        for (size_t i=0 ; i < MATERIAL_TEXTURE_MAPPING.size() ; i++)
+        {
+            names.push_back("uTextures[" + std::to_string(i) + "]");
+        }
+        return names;
+    }();
+
     for (size_t i=0 ; i < m_textureBindings.size() ; i++)
     {
         glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_2D, m_textureBindings[i]);
-        m_shader->SetInt(uTexture + std::to_string(i) + "]", i);
+        glBindTexture(GL_TEXTURE_2D, m_textureBindings[i] ? m_textureBindings[i]->GetId() : 0);
+        m_shader->SetInt(textureUniforms[i], i);
     }
 }
 
@@ -28,6 +28,7 @@ public:
 
     inline ShaderPtr GetShader() const { return m_shader; }
     inline UniformBufferPtr GetUniformBuffer() const { return m_uniformBuffer; }
+    inline size_t GetGpuMemorySize() const { return m_uniformBlock.size; }
 
     void SetInputTexture(const std::string& name, const TexturePtr& texture);
     void RemoveInputTexture(const std::string& name);
@@ -52,7 +53,8 @@ private:
     UniformBufferPtr m_uniformBuffer;
     UniformBlockDescription m_uniformBlock;
 
-    std::vector<uint32_t> m_textureBindings;
+    // Holding the textures keeps them from being evicted while the material uses them
+    std::vector<TexturePtr> m_textureBindings;
 };
 
 
@@ -2,19 +2,26 @@
 
 Mesh::Mesh() 
 {
-    CreateVertexArray();
+    CreateVertexArray(nullptr, 0, nullptr, 0);
 }
 
 Mesh::Mesh(const std::vector<Vertex>& vertices, 
            const std::vector<uint32_t>& indices) :
         m_vertices(vertices), m_indices(indices)
 {
-    CreateVertexArray();
+    CreateVertexArray(m_vertices.data(), m_vertices.size(), m_indices.data(), m_indices.size());
+}
+
+Mesh::Mesh(const Vertex* vertices, const uint32_t& vertexCount,
+           const uint32_t* indices, const uint32_t& indexCount)
+{
+    CreateVertexArray(vertices, vertexCount, indices, indexCount);
 }
 
 void Mesh::SetVertices(const std::vector<Vertex> &vertices) 
 {
     m_vertices = vertices;
+    m_vertexCount = m_vertices.size();
     const auto& vBuffer = m_vertexArray->GetVertexBuffers()[0];
     vBuffer->Bind();
     vBuffer->SetData(m_vertices.data(), m_vertices.size() * sizeof(Vertex));
@@ -30,15 +37,17 @@ void Mesh::SetIndices(const std::vector<uint32_t>& indices)
     iBuffer->Unbind();
 }
 
-void Mesh::CreateVertexArray() 
+void Mesh::CreateVertexArray(const Vertex* vertices, const uint32_t& vertexCount,
+                             const uint32_t* indices, const uint32_t& indexCount) 
 {
-    VertexBufferPtr vBuffer = VertexBuffer::Create(m_vertices.data(), m_vertices.size() * sizeof(Vertex));
+    m_vertexCount = vertexCount;
+    VertexBufferPtr vBuffer = VertexBuffer::Create(vertices, vertexCount * sizeof(Vertex));
     vBuffer->SetLayout({{"aPosition",  3, GL_FLOAT, false},
                         {"aNormal",    3, GL_FLOAT, false},
                         {"aTexCoords", 2, GL_FLOAT, false}
                        });
 
-    IndexBufferPtr iBuffer = IndexBuffer::Create(m_indices.data(), m_indices.size());
+    IndexBufferPtr iBuffer = IndexBuffer::Create(indices, indexCount);
     
     m_vertexArray = VertexArray::Create();
     m_vertexArray->AddVertexBuffer(vBuffer);
@@ -57,3 +66,9 @@ MeshPtr Mesh::Create(const std::vector<Vertex>& vertices,
 {
     return MeshPtr(new Mesh(vertices, indices));
 }
+
+MeshPtr Mesh::Create(const Vertex* vertices, const uint32_t& vertexCount,
+                     const uint32_t* indices, const uint32_t& indexCount) 
+{
+    return MeshPtr(new Mesh(vertices, vertexCount, indices, indexCount));
+}
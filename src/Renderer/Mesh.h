@@ -7,10 +7,6 @@
 
 #include <glm/glm.hpp>
 
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-
 
 class Mesh;
 
@@ -29,6 +25,9 @@ struct Vertex
     }
 };
 
+// Vertices are uploaded and stored in cooked files as is
+static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertex must be tightly packed");
+
 
 class Mesh
 {
@@ -44,19 +43,30 @@ public:
     inline void Bind() const { m_vertexArray->Bind(); }
     inline void Unbind() const { m_vertexArray->Unbind(); }
     inline uint32_t GetElementCount() const { return m_vertexArray->GetIndexBuffer()->GetCount(); }
+    inline uint32_t GetVertexCount() const { return m_vertexCount; }
+
+    inline size_t GetCpuMemorySize() const { return m_vertices.capacity() * sizeof(Vertex) + m_indices.capacity() * sizeof(uint32_t); }
+    inline size_t GetGpuMemorySize() const { return (size_t)m_vertexCount * sizeof(Vertex) + (size_t)GetElementCount() * sizeof(uint32_t); }
 
     static MeshPtr Create();
     static MeshPtr Create(const std::vector<Vertex> &vertices, 
                           const std::vector<uint32_t> &indices);
+    // Uploads the data straight to the GPU without keeping a copy of it on the CPU
+    static MeshPtr Create(const Vertex* vertices, const uint32_t& vertexCount,
+                          const uint32_t* indices, const uint32_t& indexCount);
 
 private:
     Mesh();
     explicit Mesh(const std::vector<Vertex> &vertices, 
                   const std::vector<uint32_t> &indices);
-    void CreateVertexArray();
+    Mesh(const Vertex* vertices, const uint32_t& vertexCount,
+         const uint32_t* indices, const uint32_t& indexCount);
+    void CreateVertexArray(const Vertex* vertices, const uint32_t& vertexCount,
+                           const uint32_t* indices, const uint32_t& indexCount);
 
     std::vector<Vertex> m_vertices;
     std::vector<uint32_t> m_indices;
+    uint32_t m_vertexCount = 0;
     VertexArrayPtr m_vertexArray;
 };
 
@@ -0,0 +1,61 @@
+#ifndef RENDERCOMMANDS_H
+#define RENDERCOMMANDS_H
+
+#include "LightGrid.h"
+#include "Material.h"
+#include "Mesh.h"
+#include "Texture.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// Draw prepared by the extraction phase of the Renderer, holding everything the 
+// submission needs so that it doesn't have to access the Scene anymore.
+struct RenderCommand
+{
+    enum class Type : uint8_t
+    {
+        DrawMesh,
+        DrawImage
+    };
+
+    Type type = Type::DrawMesh;
+    bool doubleSided = false;
+
+    glm::mat4 modelMatrix{1.0f};
+    glm::mat4 mvpMatrix{1.0f};
+    glm::mat3 normalMatrix{1.0f};
+
+    MaterialPtr material;
+    MeshPtr mesh;
+    TexturePtr image;
+};
+
+
+// Commands of a whole frame, in scene traversal order. Along with the lights and the post process inputs
+// it is a complete snapshot of the frame, which can be rendered while the simulation moves on.
+struct RenderCommandList
+{
+    glm::mat4 viewMatrix{1.0f};
+    glm::mat4 projMatrix{1.0f};
+    glm::mat4 cameraModelMatrix{1.0f};
+    double time = 0.0;
+
+    std::vector<RenderCommand> commands;
+    LightGrid::Data lights;
+    std::vector<std::pair<std::string, glm::vec4>> postProcessValues;
+
+    inline void Clear() 
+    { 
+        commands.clear(); 
+        lights.Clear();
+        postProcessValues.clear();
+    }
+};
+
+
+#endif  // RENDERCOMMANDS_H
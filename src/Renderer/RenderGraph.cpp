@@ -0,0 +1,241 @@
+#include "RenderGraph.h"
+
+#include "Core/Logging.h"
+
+
+RenderGraph::RenderGraph(GpuResourcePool& pool) :
+        m_pool(pool)
+{
+}
+
+RenderResourceId RenderGraph::Import(const std::string& name, const FrameBufferPtr& frameBuffer)
+{
+    Resource resource;
+    resource.name = name;
+    resource.specs = frameBuffer->GetSpecs();
+    resource.frameBuffer = frameBuffer;
+    resource.importedId = frameBuffer->GetId();
+    resource.imported = true;
+
+    m_resources.push_back(resource);
+    m_compiled = false;
+
+    return m_resources.size() - 1;
+}
+
+RenderResourceId RenderGraph::Import(const std::string& name, const GLuint& id, const uint32_t& width, const uint32_t& height)
+{
+    Resource resource;
+    resource.name = name;
+    resource.specs = {width, height};
+    resource.importedId = id;
+    resource.imported = true;
+
+    m_resources.push_back(resource);
+    m_compiled = false;
+
+    return m_resources.size() - 1;
+}
+
+RenderResourceId RenderGraph::Create(const std::string& name, const FrameBufferSpecs& specs)
+{
+    Resource resource;
+    resource.name = name;
+    resource.specs = specs;
+
+    m_resources.push_back(resource);
+    m_compiled = false;
+
+    return m_resources.size() - 1;
+}
+
+void RenderGraph::AddPass(const std::string& name, 
+                          const std::vector<RenderResourceId>& inputs, 
+                          const RenderResourceId& output,
+                          const RenderPassFn& execute)
+{
+    ASSERT(output < m_resources.size(), "Invalid output for render pass %s", name.c_str());
+
+    m_passes.push_back({name, inputs, output, execute});
+    m_compiled = false;
+}
+
+void RenderGraph::Compile()
+{
+    for (auto& resource : m_resources)
+    {
+        resource.refCount = 0;
+        resource.firstPass = -1;
+        resource.lastPass = -1;
+    }
+
+    for (auto& pass : m_passes)
+    {
+        pass.culled = false;
+        for (const auto& input : pass.inputs)
+        {
+            m_resources[input].refCount++;
+        }
+    }
+
+    // Culling the passes that write to transients nobody reads, which can in turn 
+    // leave their own inputs unused
+    std::vector<RenderResourceId> unused;
+    for (RenderResourceId id = 0 ; id < m_resources.size() ; ++id)
+    {
+        if (!m_resources[id].imported && m_resources[id].refCount == 0)
+        {
+            unused.push_back(id);
+        }
+    }
+
+    while (!unused.empty())
+    {
+        RenderResourceId id = unused.back();
+        unused.pop_back();
+
+        for (auto& pass : m_passes)
+        {
+            if (pass.culled || pass.output != id)
+            {
+                continue;
+            }
+
+            pass.culled = true;
+            for (const auto& input : pass.inputs)
+            {
+                Resource& resource = m_resources[input];
+                if (--resource.refCount == 0 && !resource.imported)
+                {
+                    unused.push_back(input);
+                }
+            }
+        }
+    }
+
+    // Computing the lifetime of the resources over the remaining passes
+    for (int32_t passIndex = 0 ; passIndex < (int32_t)m_passes.size() ; ++passIndex)
+    {
+        const Pass& pass = m_passes[passIndex];
+        if (pass.culled)
+        {
+            continue;
+        }
+
+        auto extendLifetime = [passIndex](Resource& resource)
+        {
+            if (resource.firstPass < 0)
+            {
+                resource.firstPass = passIndex;
+            }
+            resource.lastPass = passIndex;
+        };
+
+        for (const auto& input : pass.inputs)
+        {
+            extendLifetime(m_resources[input]);
+        }
+        extendLifetime(m_resources[pass.output]);
+    }
+
+    m_compiled = true;
+}
+
+void RenderGraph::Execute()
+{
+    if (!m_compiled)
+    {
+        Compile();
+    }
+
+    for (int32_t passIndex = 0 ; passIndex < (int32_t)m_passes.size() ; ++passIndex)
+    {
+        const Pass& pass = m_passes[passIndex];
+        if (pass.culled)
+        {
+            continue;
+        }
+
+        // Transients are only acquired when they become needed
+        for (auto& resource : m_resources)
+        {
+            if (!resource.imported && resource.firstPass == passIndex)
+            {
+                resource.frameBuffer = m_pool.AcquireFrameBuffer(resource.specs);
+            }
+        }
+
+        const Resource& output = m_resources[pass.output];
+        if (output.frameBuffer)
+        {
+            output.frameBuffer->Bind();
+        }
+        else
+        {
+            FrameBuffer::BindFromId(output.importedId);
+            glViewport(0, 0, output.specs.width, output.specs.height);
+        }
+
+        if (pass.execute)
+        {
+            pass.execute(*this);
+        }
+
+        // ...and given back to the pool as soon as they are not, so that the next passes can reuse them
+        for (auto& resource : m_resources)
+        {
+            if (!resource.imported && resource.lastPass == passIndex)
+            {
+                resource.frameBuffer = nullptr;
+            }
+        }
+    }
+}
+
+void RenderGraph::Reset()
+{
+    m_resources.clear();
+    m_passes.clear();
+    m_compiled = false;
+}
+
+FrameBufferPtr RenderGraph::GetFrameBuffer(const RenderResourceId& resource) const
+{
+    ASSERT_OR_RETURN(resource < m_resources.size(), nullptr, "Invalid render graph resource %d", resource)
+
+    return m_resources[resource].frameBuffer;
+}
+
+GLuint RenderGraph::GetFrameBufferId(const RenderResourceId& resource) const
+{
+    ASSERT_OR_RETURN(resource < m_resources.size(), 0, "Invalid render graph resource %d", resource)
+
+    const Resource& res = m_resources[resource];
+    return res.frameBuffer ? res.frameBuffer->GetId() : res.importedId;
+}
+
+uint32_t RenderGraph::GetWidth(const RenderResourceId& resource) const
+{
+    ASSERT_OR_RETURN(resource < m_resources.size(), 0, "Invalid render graph resource %d", resource)
+
+    return m_resources[resource].specs.width;
+}
+
+uint32_t RenderGraph::GetHeight(const RenderResourceId& resource) const
+{
+    ASSERT_OR_RETURN(resource < m_resources.size(), 0, "Invalid render graph resource %d", resource)
+
+    return m_resources[resource].specs.height;
+}
+
+uint32_t RenderGraph::GetCulledPassCount() const
+{
+    uint32_t count = 0;
+    for (const auto& pass : m_passes)
+    {
+        if (pass.culled)
+            count++;
+    }
+
+    return count;
+}
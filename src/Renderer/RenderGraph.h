@@ -0,0 +1,89 @@
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include "FrameBuffer.h"
+#include "GpuResourcePool.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+class RenderGraph;
+
+typedef uint32_t RenderResourceId;
+typedef std::function<void(const RenderGraph&)> RenderPassFn;
+
+
+// Frame graph of the FrameBuffer passes of the Renderer.
+// Passes declare the FrameBuffers they read and the one they write to. Before executing, the graph 
+// drops the passes whose output is never consumed, and computes the lifetime of each transient 
+// FrameBuffer so that it can be acquired from the GpuResourcePool right before its first use and 
+// released right after its last one. Transients with matching specs hence alias the same GL objects.
+// Imported FrameBuffers (the scene buffer, the back buffer...) live outside of the graph and are 
+// considered as the outputs of the frame.
+class RenderGraph
+{
+public:
+    RenderGraph(GpuResourcePool& pool);
+    ~RenderGraph() = default;
+    RenderGraph(const RenderGraph&) = delete;
+
+    RenderResourceId Import(const std::string& name, const FrameBufferPtr& frameBuffer);
+    // Imports a FrameBuffer that isn't owned by the engine (like the default framebuffer)
+    RenderResourceId Import(const std::string& name, const GLuint& id, const uint32_t& width, const uint32_t& height);
+    RenderResourceId Create(const std::string& name, const FrameBufferSpecs& specs);
+
+    void AddPass(const std::string& name, 
+                 const std::vector<RenderResourceId>& inputs, 
+                 const RenderResourceId& output,
+                 const RenderPassFn& execute);
+
+    void Compile();
+    void Execute();
+    // Removes all the passes and resources, to be called before building the graph of the next frame
+    void Reset();
+
+    // Accessors meant to be used by the passes while the graph executes
+    FrameBufferPtr GetFrameBuffer(const RenderResourceId& resource) const;
+    GLuint GetFrameBufferId(const RenderResourceId& resource) const;
+    uint32_t GetWidth(const RenderResourceId& resource) const;
+    uint32_t GetHeight(const RenderResourceId& resource) const;
+    
+    inline uint32_t GetPassCount() const { return m_passes.size(); }
+    uint32_t GetCulledPassCount() const;
+
+private:
+    struct Resource
+    {
+        std::string name;
+        FrameBufferSpecs specs;
+        FrameBufferPtr frameBuffer;
+        GLuint importedId = 0;
+        bool imported = false;
+
+        // Computed by Compile()
+        uint32_t refCount = 0;
+        int32_t firstPass = -1;
+        int32_t lastPass = -1;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        std::vector<RenderResourceId> inputs;
+        RenderResourceId output;
+        RenderPassFn execute;
+
+        bool culled = false;
+    };
+
+    GpuResourcePool& m_pool;
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    bool m_compiled = false;
+};
+
+
+#endif  // RENDERGRAPH_H
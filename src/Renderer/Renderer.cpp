@@ -4,15 +4,20 @@
 
 #include "Mesh.h"
 #include "Shader.h"
+#include "ShaderLibrary.h"
 #include "VertexArray.h"
 #include "Texture.h"
 #include "Material.h"
 
 #include "Core/Resolver.h"
+#include "Core/JobSystem.h"
 #include "Core/Time.h"
 
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 Renderer* Renderer::s_instance = nullptr;
 
@@ -23,151 +28,436 @@ Renderer& Renderer::Init()
     return *s_instance;
 }
 
-Renderer::Renderer()
+Renderer::Renderer() :
+        m_renderGraph(m_resourcePool)
 {
     Resolver& resolver = Resolver::Get();
 
     // Full screen render (Blit) utils
-    m_blitTextureArray = VertexArray::Create();
-    m_blitTextureShader = Shader::Open(resolver.Resolve("Shaders/fullScreen.vert"), 
+    m_blitTextureArray = m_resourcePool.AcquireVertexArray();
+    m_blitTextureShader = ShaderLibrary::Open(resolver.Resolve("Shaders/fullScreen.vert"), 
                                        resolver.Resolve("Shaders/sprite.frag"));
 }
 
 void Renderer::SetRenderBuffer(const FrameBufferPtr& renderBuffer)
 {
+    // The intermediate buffers are allocated by the render graph, following the specs of the render buffer
     m_renderBuffer = renderBuffer;
     if (m_renderBuffer)
     {
-        FrameBufferSpecs specs = m_renderBuffer->GetSpecs();
-        specs.samples = 1;
-        m_postProcessBuffer = FrameBuffer::Create(specs);
+        m_outputWidth = m_renderBuffer->GetWidth();
+        m_outputHeight = m_renderBuffer->GetHeight();
+        m_frameBudget.SetSamples(m_renderBuffer->GetSpecs().samples);
+
+        ApplyFrameBudget();
+    }
+}
+
+void Renderer::SetOutputSize(const uint32_t& width, const uint32_t& height)
+{
+    m_outputWidth = width;
+    m_outputHeight = height;
+
+    ApplyFrameBudget();
+}
+
+void Renderer::ApplyFrameBudget()
+{
+    if (!m_renderBuffer || !m_outputWidth || !m_outputHeight)
+    {
+        return;
+    }
+
+    float scale = m_frameBudget.GetResolutionScale();
+    uint32_t width = std::max(1u, (uint32_t)std::round(m_outputWidth * scale));
+    uint32_t height = std::max(1u, (uint32_t)std::round(m_outputHeight * scale));
+    uint32_t samples = m_frameBudget.GetSamples();
+
+    FrameBufferSpecs specs = m_renderBuffer->GetSpecs();
+    if (specs.width != width || specs.height != height || specs.samples != samples)
+    {
+        m_renderBuffer->Resize(width, height, samples);
+    }
+}
+
+// Appends the draw of a single entity, if it renders anything
+static void ExtractEntity(const Entity& entity, 
+                          const glm::mat4& worldMatrix, 
+                          const glm::mat4& viewProjMatrix, 
+                          std::vector<RenderCommand>& commands)
+{
+    auto* meshRenderComp = entity.ReadComponent<Components::RenderMesh>();
+    if (meshRenderComp)
+    {
+        auto* meshComp = entity.ReadComponent<Components::Mesh>();
+        if (!meshComp)
+        {
+            return;
+        }
+
+        auto material = meshRenderComp->material.Get();
+        auto mesh = meshComp->mesh.Get();
+        if (!material || !mesh)
+        {
+            return;
+        }
+
+        // TODO: Insert culling here
+
+        RenderCommand& command = commands.emplace_back();
+        command.type = RenderCommand::Type::DrawMesh;
+        command.doubleSided = meshRenderComp->doubleSided;
+        command.modelMatrix = worldMatrix;
+        command.mvpMatrix = viewProjMatrix * worldMatrix;
+        command.normalMatrix = glm::transpose(glm::inverse(glm::mat3(worldMatrix)));
+        command.material = material;
+        command.mesh = mesh;
+        return;
     }
-    else 
+
+    auto* renderImage = entity.ReadComponent<Components::RenderImage>();
+    if (renderImage)
     {
-        m_postProcessBuffer = nullptr;
+        auto image = renderImage->image.Get();
+        if (!image)
+        {
+            return;
+        }
+
+        RenderCommand& command = commands.emplace_back();
+        command.type = RenderCommand::Type::DrawImage;
+        command.image = image;
+    }
+}
+
+// Extracts an entity and all its descendants, accumulating the world matrices on the way down
+static void ExtractSubtree(const Entity& subtreeRoot, 
+                           const glm::mat4& parentMatrix, 
+                           const glm::mat4& viewProjMatrix, 
+                           const float& interpolationFactor,
+                           std::vector<RenderCommand>& commands)
+{
+    // Ancestors of the current entity along with their world matrix
+    std::vector<std::pair<Entity, glm::mat4>> stack;
+    for (Entity entity : EntityView(subtreeRoot))
+    {
+        Entity parent = entity.GetParent();
+        while (!stack.empty() && stack.back().first != parent)
+        {
+            stack.pop_back();
+        }
+
+        glm::mat4 worldMatrix = stack.empty() ? parentMatrix : stack.back().second;
+        if (auto* transform = entity.ReadComponent<Components::Transform>())
+        {
+            worldMatrix = worldMatrix * transform->GetInterpolated(interpolationFactor);
+        }
+        stack.emplace_back(entity, worldMatrix);
+
+        ExtractEntity(entity, worldMatrix, viewProjMatrix, commands);
     }
 }
 
 void Renderer::RenderScene(const ScenePtr& scene, const Entity& cameraEntity)
+{
+    ExtractScene(scene, cameraEntity, m_commandList);
+    SubmitCommands(m_commandList);
+}
+
+void Renderer::ExtractScene(const ScenePtr& scene, const Entity& cameraEntity, RenderCommandList& commandList)
+{
+    commandList.Clear();
+    commandList.time = Time::GetTime();
+    commandList.viewMatrix = glm::mat4(1.0f);
+    commandList.cameraModelMatrix = glm::mat4(1.0f);
+    commandList.projMatrix = glm::mat4(1.0f);
+
+    // The simulation runs at its own rate, transforms are blended between its last two steps
+    float interpolationFactor = Time::GetInterpolationFactor();
+
+    auto* camera = cameraEntity.ReadComponent<Components::Camera>();
+    if (camera)
+    {
+        commandList.cameraModelMatrix = Components::Transform::ComputeInterpolatedWorldMatrix(cameraEntity, interpolationFactor);
+        commandList.viewMatrix = glm::inverse(commandList.cameraModelMatrix);
+        commandList.projMatrix = camera->camera.GetProjMatrix();
+    }
+
+    glm::mat4 viewProjMatrix = commandList.projMatrix * commandList.viewMatrix;
+
+    // Lights are gathered once for the whole frame and shared by all the lit shaders
+    m_lightGrid.Build(scene, commandList.lights);
+    commandList.postProcessValues = m_postProcessInputs;
+
+    Entity root = scene->GetRootEntity();
+    glm::mat4 rootMatrix(1.0f);
+    if (auto* transform = root.ReadComponent<Components::Transform>())
+    {
+        rootMatrix = transform->GetInterpolated(interpolationFactor);
+    }
+    ExtractEntity(root, rootMatrix, viewProjMatrix, commandList.commands);
+
+    // The children of the root are extracted in parallel, each one into its own list to keep the traversal order
+    std::vector<Entity> chunks = root.GetChildren();
+    if (m_chunkCommands.size() < chunks.size())
+    {
+        m_chunkCommands.resize(chunks.size());
+    }
+
+    JobSystem::Get().ParallelFor(chunks.size(), 
+                                  [&](const uint32_t& index)
+                                  {
+                                      m_chunkCommands[index].clear();
+                                      ExtractSubtree(chunks[index], rootMatrix, viewProjMatrix, interpolationFactor, m_chunkCommands[index]);
+                                  });
+
+    for (size_t i = 0 ; i < chunks.size() ; ++i)
+    {
+        auto& chunk = m_chunkCommands[i];
+        commandList.commands.insert(commandList.commands.end(), 
+                                    std::make_move_iterator(chunk.begin()), 
+                                    std::make_move_iterator(chunk.end()));
+        chunk.clear();
+    }
+}
+
+void Renderer::SubmitCommands(const RenderCommandList& commandList)
 {
     if (!m_renderBuffer)
     {
         return;
     }
-    // Clearing all the FrameBuffers
-    m_postProcessBuffer->Bind();
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
     m_renderBuffer->Bind();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-    glm::mat4 viewMatrix(1.0f);
-    glm::mat4 camModelMatrix(1.0f);
-    glm::mat4 projMatrix(1.0f);
+    m_lightGrid.Upload(commandList.lights);
+    m_postProcessValues = commandList.postProcessValues;
+    m_lightGrid.Attach();
 
-    auto* camera = cameraEntity.FindComponent<Components::Camera>();
-    if (camera)
+    // Commands are submitted in traversal order (transparent surfaces rely on it), consecutive 
+    // commands often share their shader, material or mesh so only the changes are sent to GL
+    const Shader* currentShader = nullptr;
+    const Material* currentMaterial = nullptr;
+    const Mesh* currentMesh = nullptr;
+    m_frameShaders.clear();
+
+    for (const RenderCommand& command : commandList.commands)
     {
-        camModelMatrix = Components::Transform::ComputeWorldMatrix(cameraEntity);
-        viewMatrix = glm::inverse(camModelMatrix);
-        projMatrix = camera->camera.GetProjMatrix();
-    }
+        if (command.type == RenderCommand::Type::DrawImage)
+        {
+            m_blitTextureArray->Bind();
 
-    glm::mat4 viewProjMatrix = projMatrix * viewMatrix;
+            m_blitTextureShader->Bind();
+            command.image->Bind(0);
+            m_blitTextureShader->SetInt("uTexture", 0);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            m_blitTextureArray->Unbind();
 
-    // Rendering the scene
-    for (Entity entity : scene->Traverse())
-    {
-        auto* meshRenderComp = entity.FindComponent<Components::RenderMesh>();
-        if (meshRenderComp)
+            currentShader = nullptr;
+            currentMaterial = nullptr;
+            currentMesh = nullptr;
+            continue;
+        }
+
+        const Material* material = command.material.get();
+        const ShaderPtr& shader = material->GetShader();
+        if (material != currentMaterial)
         {
-            auto* meshComp = entity.FindComponent<Components::Mesh>();
-            if (!meshComp)
+            if (shader.get() != currentShader)
             {
-                continue;
+                material->Bind();
+                currentShader = shader.get();
+
+                // Programs keep their uniform values, the per frame ones are only sent once
+                if (std::find(m_frameShaders.begin(), m_frameShaders.end(), currentShader) == m_frameShaders.end())
+                {
+                    m_frameShaders.push_back(currentShader);
+                    shader->SetMat4("uViewMatrix", commandList.viewMatrix);
+                    shader->SetMat4("uCameraModelMatrix", commandList.cameraModelMatrix);
+                    shader->SetFloat("uTime", commandList.time);
+                }
             }
-            
-            glm::mat4 modelMatrix = Components::Transform::ComputeWorldMatrix(entity);
 
-            auto material = meshRenderComp->material.Get();
-            auto mesh = meshComp->mesh.Get();
+            material->ApplyUniforms();
+            currentMaterial = material;
+        }
 
-            // TODO: Insert culling here
+        shader->SetInt("uDoubleSided", command.doubleSided); 
+        shader->SetMat4("uModelMatrix", command.modelMatrix);
+        shader->SetMat3("uNormalMatrix", command.normalMatrix);
+        shader->SetMat4("uMVPMatrix", command.mvpMatrix);
 
-            double time = Time::GetTime();
-            material->Bind();
-            material->ApplyUniforms();
-            material->GetShader()->SetInt("uDoubleSided", meshRenderComp->doubleSided); 
-
-            // Pass global uniforms to the shader
-            // Should be an uniform buffer as well
-            material->GetShader()->SetMat4("uModelMatrix", modelMatrix);
-            material->GetShader()->SetMat4("uViewMatrix", viewMatrix);
-            material->GetShader()->SetMat4("uCameraModelMatrix", camModelMatrix);
-            material->GetShader()->SetMat3("uNormalMatrix", glm::transpose(glm::inverse(glm::mat3(modelMatrix))));
-            material->GetShader()->SetMat4("uMVPMatrix", viewProjMatrix * modelMatrix);
-            material->GetShader()->SetVec3("uPointLights[0].position", glm::vec3(glm::inverse(viewMatrix) * glm::vec4(0, 0, 0, 1)));
-            material->GetShader()->SetVec3("uPointLights[0].color", glm::vec3(0.8 + (std::abs(sin(time * 2.3)) * 2 + sin(0.5 + time * 7.7)) * 0.3) * 10.0f);  // Flicking torch effect
-            material->GetShader()->SetFloat("uPointLights[0].decay", 2.0f);
-            material->GetShader()->SetFloat("uTime", time); 
-            mesh->Bind();
-
-            glDrawElements(GL_TRIANGLES, 
-                           mesh->GetElementCount(),
-                           GL_UNSIGNED_INT,
-                           nullptr);
-
-            mesh->Unbind();
-            material->Unbind();
-            continue;
+        if (command.mesh.get() != currentMesh)
+        {
+            command.mesh->Bind();
+            currentMesh = command.mesh.get();
         }
 
-        auto* renderImage = entity.FindComponent<Components::RenderImage>();
-        if (renderImage)
+        glDrawElements(GL_TRIANGLES, 
+                       command.mesh->GetElementCount(),
+                       GL_UNSIGNED_INT,
+                       nullptr);
+    }
+
+    if (currentMesh)
+    {
+        currentMesh->Unbind();
+    }
+    if (currentMaterial)
+    {
+        currentMaterial->Unbind();
+    }
+}
+
+void Renderer::AddPostProcessStage(const std::string& name, const ShaderPtr& shader)
+{
+    m_postProcessStages.push_back({name, shader});
+}
+
+void Renderer::RemovePostProcessStage(const std::string& name)
+{
+    m_postProcessStages.erase(std::remove_if(m_postProcessStages.begin(), m_postProcessStages.end(),
+                                             [&name](const PostProcessStage& stage) { return stage.name == name; }),
+                              m_postProcessStages.end());
+}
+
+ShaderPtr Renderer::GetPostProcessStage(const std::string& name) const
+{
+    for (const auto& stage : m_postProcessStages)
+    {
+        if (stage.name == name)
         {
-            VertexArrayPtr varray = VertexArray::Create();
-            varray->Bind();
+            return stage.shader;
+        }
+    }
 
-            m_blitTextureShader->Bind();
-            renderImage->image.Get()->Bind(0);
-            m_blitTextureShader->SetInt("uTexture", 0);
-            glDrawArrays(GL_TRIANGLES, 0, 3);
-            varray->Unbind();
-            continue;
+    return nullptr;
+}
+
+ShaderPtr Renderer::GetPostProcessShader() const
+{
+    return m_postProcessStages.empty() ? nullptr : m_postProcessStages.back().shader;
+}
+
+void Renderer::SetPostProcessValue(const std::string& name, const glm::vec4& value)
+{
+    for (auto& input : m_postProcessInputs)
+    {
+        if (input.first == name)
+        {
+            input.second = value;
+            return;
         }
     }
+
+    m_postProcessInputs.emplace_back(name, value);
 }
 
 void Renderer::SetPostProcessShader(const ShaderPtr& shader)
 {
-    m_postProcessShader = shader;
+    m_postProcessStages.clear();
+    if (shader)
+    {
+        AddPostProcessStage("PostProcess", shader);
+    }
 }
 
-void Renderer::BlitRenderToBuffer(const uint32_t& frameBufferId) const
+void Renderer::BlitRenderToBuffer(const uint32_t& frameBufferId)
 {
-    if (!m_postProcessShader)
+    if (!m_renderBuffer)
     {
-        m_renderBuffer->Bind();
-        m_renderBuffer->Blit(frameBufferId, m_renderBuffer->GetWidth(), m_renderBuffer->GetHeight());
-        m_renderBuffer->Unbind();
+        return;
+    }
+
+    const uint32_t width = m_renderBuffer->GetWidth();
+    const uint32_t height = m_renderBuffer->GetHeight();
+    const uint32_t outputWidth = m_outputWidth ? m_outputWidth : width;
+    const uint32_t outputHeight = m_outputHeight ? m_outputHeight : height;
+
+    m_renderGraph.Reset();
+    RenderResourceId scene = m_renderGraph.Import("Scene", m_renderBuffer);
+    RenderResourceId destination = m_renderGraph.Import("Destination", frameBufferId, outputWidth, outputHeight);
+
+    if (m_postProcessStages.empty() && (width != outputWidth || height != outputHeight))
+    {
+        // Multisampled buffers can't be scaled while blitting, the render is resolved first
+        FrameBufferSpecs resolvedSpecs = m_renderBuffer->GetSpecs();
+        resolvedSpecs.samples = 1;
+        RenderResourceId resolved = m_renderGraph.Create("Resolved", resolvedSpecs);
+        m_renderGraph.AddPass("Resolve", {scene}, resolved,
+                              [scene, resolved](const RenderGraph& graph)
+                              {
+                                  graph.GetFrameBuffer(scene)->Blit(graph.GetFrameBufferId(resolved), 
+                                                                    graph.GetWidth(resolved), 
+                                                                    graph.GetHeight(resolved));
+                              });
+        m_renderGraph.AddPass("Present", {resolved}, destination,
+                              [resolved, destination](const RenderGraph& graph)
+                              {
+                                  graph.GetFrameBuffer(resolved)->Blit(graph.GetFrameBufferId(destination), 
+                                                                       graph.GetWidth(destination), 
+                                                                       graph.GetHeight(destination),
+                                                                       GL_COLOR_BUFFER_BIT,
+                                                                       GL_LINEAR);
+                              });
+    }
+    else if (m_postProcessStages.empty())
+    {
+        m_renderGraph.AddPass("Present", {scene}, destination,
+                              [scene, destination](const RenderGraph& graph)
+                              {
+                                  graph.GetFrameBuffer(scene)->Blit(graph.GetFrameBufferId(destination), 
+                                                                    graph.GetWidth(destination), 
+                                                                    graph.GetHeight(destination));
+                              });
     }
     else
     {
-        // Blit the render to the "post processing" buffer (non-multisampled)
-        m_renderBuffer->Blit(m_postProcessBuffer->GetId(), m_renderBuffer->GetWidth(), m_renderBuffer->GetHeight());
-        FrameBuffer::BindFromId(frameBufferId);
+        // Resolving the multisampled render so that the post process stages can sample it
+        FrameBufferSpecs resolvedSpecs = m_renderBuffer->GetSpecs();
+        resolvedSpecs.samples = 1;
+        RenderResourceId resolved = m_renderGraph.Create("Resolved", resolvedSpecs);
+        m_renderGraph.AddPass("Resolve", {scene}, resolved,
+                              [scene, resolved](const RenderGraph& graph)
+                              {
+                                  graph.GetFrameBuffer(scene)->Blit(graph.GetFrameBufferId(resolved), 
+                                                                    graph.GetWidth(resolved), 
+                                                                    graph.GetHeight(resolved),
+                                                                    GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                              });
+
+        // Intermediate stages ping-pong between transient buffers, the last one draws straight into the destination
+        // which also upscales the render when it is rendered at a lower resolution
+        FrameBufferSpecs stageSpecs = {width, height, 1, {resolvedSpecs.colorFormats.front()}, GL_NONE};
+        RenderResourceId input = resolved;
+        for (size_t i = 0 ; i < m_postProcessStages.size() ; ++i)
+        {
+            const PostProcessStage& stage = m_postProcessStages[i];
+            RenderResourceId output = (i + 1 == m_postProcessStages.size()) ? destination : m_renderGraph.Create(stage.name, stageSpecs);
 
-        // Draw the post process into the destination frame buffer
-        VertexArrayPtr varray = VertexArray::Create();
-        varray->Bind();
+            m_renderGraph.AddPass(stage.name, {input, resolved}, output,
+                                  [this, shader=stage.shader, input, resolved](const RenderGraph& graph)
+                                  {
+                                      m_blitTextureArray->Bind();
 
-        m_postProcessShader->Bind();
-        Texture::BindFromId(m_postProcessBuffer->GetColorAttachmentId(0), 0);
-        Texture::BindFromId(m_postProcessBuffer->GetDepthAttachmentId(), 1);
-        m_postProcessShader->SetInt("uBeauty", 0);
-        m_postProcessShader->SetInt("uDepth", 1);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
-        varray->Unbind();
+                                      shader->Bind();
+                                      Texture::BindFromId(graph.GetFrameBuffer(input)->GetColorAttachmentId(0), 0);
+                                      Texture::BindFromId(graph.GetFrameBuffer(resolved)->GetDepthAttachmentId(), 1);
+                                      shader->SetInt("uBeauty", 0);
+                                      shader->SetInt("uDepth", 1);
+                                      for (const auto& [name, value] : m_postProcessValues)
+                                      {
+                                          shader->SetVec4(name, value);
+                                      }
+                                      glDrawArrays(GL_TRIANGLES, 0, 3);
+                                      m_blitTextureArray->Unbind();
+                                  });
+            input = output;
+        }
     }
+
+    m_renderGraph.Execute();
 }
 
 void Renderer::SetClearColor(const glm::vec3& color)
@@ -180,3 +470,22 @@ void Renderer::ClearBuffer(const uint32_t& frameBuffer)
     FrameBuffer::BindFromId(frameBuffer);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
+
+void Renderer::BeginFrame()
+{
+    m_gpuTimer.Begin();
+}
+
+void Renderer::EndFrame(const double& cpuFrameTime)
+{
+    m_gpuTimer.End();
+
+    // Only the slowest of the two matters, the other one is waiting for it
+    double frameTime = std::max(cpuFrameTime, m_gpuTimer.GetElapsedTime());
+    if (m_frameBudget.Update(frameTime))
+    {
+        ApplyFrameBudget();
+    }
+
+    m_resourcePool.NextFrame();
+}
@@ -1,7 +1,13 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include "FrameBudget.h"
 #include "FrameBuffer.h"
+#include "GpuResourcePool.h"
+#include "GpuTimer.h"
+#include "LightGrid.h"
+#include "RenderCommands.h"
+#include "RenderGraph.h"
 #include "VertexArray.h"
 #include "Shader.h"
 
@@ -17,25 +23,77 @@ public:
     inline FrameBufferPtr GetRenderBuffer() const { return m_renderBuffer; };
     void SetRenderBuffer(const FrameBufferPtr& renderBuffer);
 
+    // Size of the buffer the render is presented to, the render buffer itself is scaled down 
+    // from it when the frame budget requires it
+    void SetOutputSize(const uint32_t& width, const uint32_t& height);
+    inline uint32_t GetOutputWidth() const { return m_outputWidth; }
+    inline uint32_t GetOutputHeight() const { return m_outputHeight; }
+
     void RenderScene(const ScenePtr& scene, const Entity& camera);
-    void BlitRenderToBuffer(const uint32_t& frameBufferId) const;
 
-    inline ShaderPtr GetPostProcessShader() const { return m_postProcessShader; }
+    // Rendering is split in two phases: the extraction walks the scene (spreading the work over the
+    // JobSystem) and records the draws into a command list that the submission replays on the GL thread
+    void ExtractScene(const ScenePtr& scene, const Entity& camera, RenderCommandList& commandList);
+    void SubmitCommands(const RenderCommandList& commandList);
+    void BlitRenderToBuffer(const uint32_t& frameBufferId);
+
+    // Post process stages are applied in order, the last one drawing into the destination buffer
+    void AddPostProcessStage(const std::string& name, const ShaderPtr& shader);
+    void RemovePostProcessStage(const std::string& name);
+    ShaderPtr GetPostProcessStage(const std::string& name) const;
+
+    // Shader of the last post process stage
+    ShaderPtr GetPostProcessShader() const;
+    // Replaces all the post process stages by the given shader
     void SetPostProcessShader(const ShaderPtr& shader);
+    // Uniform given to the post process stages, it is recorded with the frame snapshot so the simulation can set it
+    void SetPostProcessValue(const std::string& name, const glm::vec4& value);
 
     void SetClearColor(const glm::vec3& color);
     void ClearBuffer(const uint32_t& frameBuffer);
 
+    void BeginFrame();
+    // The CPU time spent on the frame is combined with the GPU one to drive the frame budget
+    void EndFrame(const double& cpuFrameTime=0.0);
+
+    inline FrameBudget& GetFrameBudget() { return m_frameBudget; }
+
+    inline GpuResourcePool& GetResourcePool() { return m_resourcePool; }
+    inline LightGrid& GetLightGrid() { return m_lightGrid; }
+
 private:
     Renderer();
     ~Renderer() = default;
     Renderer(const Renderer&) = delete;
 
+    void ApplyFrameBudget();
+
+    GpuResourcePool m_resourcePool;
+    LightGrid m_lightGrid;
+    RenderGraph m_renderGraph;
+
     FrameBufferPtr m_renderBuffer;
-    FrameBufferPtr m_postProcessBuffer;
+    uint32_t m_outputWidth = 0;
+    uint32_t m_outputHeight = 0;
+
+    FrameBudget m_frameBudget;
+    GpuTimer m_gpuTimer;
+
+    RenderCommandList m_commandList;
+    std::vector<std::vector<RenderCommand>> m_chunkCommands;
+    std::vector<const Shader*> m_frameShaders;
 
-    ShaderPtr m_postProcessShader;
+    struct PostProcessStage
+    {
+        std::string name;
+        ShaderPtr shader;
+    };
+    std::vector<PostProcessStage> m_postProcessStages;
+    // Values set by the simulation, and those of the frame being submitted
+    std::vector<std::pair<std::string, glm::vec4>> m_postProcessInputs;
+    std::vector<std::pair<std::string, glm::vec4>> m_postProcessValues;
 
+    // Full screen draws don't need any vertex buffer, a single empty VertexArray is kept for all of them
     ShaderPtr m_blitTextureShader;
     VertexArrayPtr m_blitTextureArray;
 
@@ -5,6 +5,7 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <utility>
 #include <vector>
 #include <fstream>
 #include <iostream>
@@ -49,6 +50,9 @@ Shader::Shader(const char* vertexCode,
         glAttachShader(m_id, gShader);
     }
 
+    // Allows the program to be cached by the ShaderLibrary
+    glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     GLint success = 0;
     glLinkProgram(m_id);
     glGetProgramiv(m_id, GL_LINK_STATUS, &success);
@@ -120,6 +124,45 @@ ShaderPtr Shader::Open(const std::string& vertexPath,
                   !geometryCode.empty() ? geometryCode.c_str() : nullptr);
 }
 
+ShaderPtr Shader::FromBinary(const GLenum& format, const void* data, const uint32_t& size)
+{
+    ShaderPtr shader(new Shader());
+    shader->m_id = glCreateProgram();
+    glProgramBinary(shader->m_id, format, data, size);
+
+    // Binaries are rejected when the driver changed since they were retrieved
+    GLint success = 0;
+    glGetProgramiv(shader->m_id, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glDeleteProgram(shader->m_id);
+        shader->m_id = 0;
+    }
+
+    return shader;
+}
+
+bool Shader::GetBinary(GLenum& outFormat, std::vector<uint8_t>& outData) const
+{
+    GLint length = 0;
+    glGetProgramiv(m_id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return false;
+    }
+
+    outData.resize(length);
+    glGetProgramBinary(m_id, length, &length, &outFormat, outData.data());
+    outData.resize(length);
+
+    return length > 0;
+}
+
+void Shader::Swap(Shader& other)
+{
+    std::swap(m_id, other.m_id);
+}
+
 void Shader::Bind() const {
     glUseProgram(m_id);
 }
@@ -51,6 +51,11 @@ public:
 
     UniformBlockDescription GetUniformBlockDescription(const std::string& blockName);
 
+    // Linked program, as retrieved by glGetProgramBinary
+    bool GetBinary(GLenum& outFormat, std::vector<uint8_t>& outData) const;
+    // Exchanges the GL programs of both shaders, used to reload a shader in place
+    void Swap(Shader& other);
+
     static ShaderPtr Create(const char* vertexCode, 
                                           const char* fragmentCode,
                                           const char* tessCtrlCode=nullptr,
@@ -62,6 +67,8 @@ public:
                                         const std::string& tessEvalPath="",
                                         const std::string& geometryPath=""
                                         );
+    // Returns an invalid shader if the driver rejects the binary
+    static ShaderPtr FromBinary(const GLenum& format, const void* data, const uint32_t& size);
     
     static const char* ShaderTypeToText(const GLint &type);
 
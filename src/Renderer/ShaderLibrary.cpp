@@ -0,0 +1,207 @@
+#include "ShaderLibrary.h"
+
+#include "Utils/FileUtils.h"
+#include "Utils/TypeUtils.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+
+
+std::unordered_map<uint64_t, ShaderLibrary::Entry> ShaderLibrary::s_shaders;
+std::string ShaderLibrary::s_cacheDirectory;
+
+
+ShaderPtr ShaderLibrary::Open(const std::string& vertexPath,
+                              const std::string& fragmentPath,
+                              const std::string& tessCtrlPath,
+                              const std::string& tessEvalPath,
+                              const std::string& geometryPath)
+{
+    std::vector<std::string> paths;
+    for (const auto& path : {vertexPath, fragmentPath, tessCtrlPath, tessEvalPath, geometryPath})
+    {
+        paths.push_back(!path.empty() ? std::filesystem::path(path).lexically_normal().string() : path);
+    }
+
+    std::vector<std::string> sources;
+    uint64_t hash;
+    if (!ReadSources(paths, sources, hash))
+    {
+        // Invalid shader
+        return Shader::Open(vertexPath, fragmentPath, tessCtrlPath, tessEvalPath, geometryPath);
+    }
+
+    auto it = s_shaders.find(hash);
+    if (it != s_shaders.end())
+    {
+        if (ShaderPtr shader = it->second.shader.lock())
+        {
+            return shader;
+        }
+    }
+
+    ShaderPtr shader = Build(sources, hash);
+    if (!shader->IsValid())
+    {
+        return shader;
+    }
+
+    // Forgetting the shaders that are not used anymore
+    for (auto entry = s_shaders.begin() ; entry != s_shaders.end() ; )
+    {
+        entry = entry->second.shader.expired() ? s_shaders.erase(entry) : std::next(entry);
+    }
+    s_shaders[hash] = { shader, paths };
+
+    return shader;
+}
+
+uint32_t ShaderLibrary::ReloadFile(const std::string& path)
+{
+    std::string normPath = std::filesystem::path(path).lexically_normal().string();
+
+    std::vector<uint64_t> hashes;
+    for (const auto& [hash, entry] : s_shaders)
+    {
+        if (std::find(entry.paths.begin(), entry.paths.end(), normPath) != entry.paths.end())
+        {
+            hashes.push_back(hash);
+        }
+    }
+
+    uint32_t count = 0;
+    for (const auto& hash : hashes)
+    {
+        Entry entry = s_shaders[hash];
+        ShaderPtr shader = entry.shader.lock();
+        std::vector<std::string> sources;
+        uint64_t newHash;
+        if (!shader || !ReadSources(entry.paths, sources, newHash) || newHash == hash)
+        {
+            continue;
+        }
+
+        // The previous program is kept when the new sources don't compile
+        ShaderPtr newShader = Build(sources, newHash);
+        if (!newShader->IsValid())
+        {
+            continue;
+        }
+
+        shader->Swap(*newShader);
+        s_shaders.erase(hash);
+        s_shaders[newHash] = entry;
+        count++;
+    }
+
+    return count;
+}
+
+bool ShaderLibrary::ReadSources(const std::vector<std::string>& paths,
+                                std::vector<std::string>& outSources,
+                                uint64_t& outHash)
+{
+    outSources.resize(paths.size());
+    outHash = HashBytes(nullptr, 0);
+    for (size_t i = 0 ; i < paths.size() ; ++i)
+    {
+        if (paths[i].empty())
+        {
+            continue;
+        }
+
+        // Only the vertex and fragment shaders are required
+        if (!ReadFile(paths[i], outSources[i]) && i < 2)
+        {
+            return false;
+        }
+
+        // Hashing the stage along with the code, so that moving code from one stage to another changes the hash
+        size_t stage = i;
+        outHash = HashBytes(&stage, sizeof(stage), outHash);
+        outHash = HashBytes(outSources[i].data(), outSources[i].size(), outHash);
+    }
+
+    return true;
+}
+
+ShaderPtr ShaderLibrary::Build(const std::vector<std::string>& sources, const uint64_t& hash)
+{
+    std::string binaryPath = GetBinaryPath(hash);
+    if (!binaryPath.empty())
+    {
+        MappedFile file;
+        if (file.Open(binaryPath) && file.GetSize() >= sizeof(ShaderBinaryHeader))
+        {
+            const ShaderBinaryHeader* header = reinterpret_cast<const ShaderBinaryHeader*>(file.GetData());
+            if (header->magic == SHADER_BINARY_MAGIC &&
+                header->version == SHADER_BINARY_VERSION &&
+                sizeof(ShaderBinaryHeader) + header->size <= file.GetSize())
+            {
+                ShaderPtr shader = Shader::FromBinary(header->format, file.GetData() + sizeof(ShaderBinaryHeader), header->size);
+                if (shader->IsValid())
+                {
+                    return shader;
+                }
+            }
+        }
+    }
+
+    auto code = [&sources](const size_t& stage) { return !sources[stage].empty() ? sources[stage].c_str() : nullptr; };
+    ShaderPtr shader = Shader::Create(sources[0].c_str(), sources[1].c_str(), code(2), code(3), code(4));
+    if (!shader->IsValid() || binaryPath.empty())
+    {
+        return shader;
+    }
+
+    GLenum format = 0;
+    std::vector<uint8_t> binary;
+    if (shader->GetBinary(format, binary))
+    {
+        ShaderBinaryHeader header{SHADER_BINARY_MAGIC, SHADER_BINARY_VERSION, format, (uint32_t)binary.size()};
+        binary.insert(binary.begin(), sizeof(ShaderBinaryHeader), 0);
+        memcpy(binary.data(), &header, sizeof(ShaderBinaryHeader));
+        WriteFile(binaryPath, binary.data(), binary.size());
+    }
+
+    return shader;
+}
+
+std::string ShaderLibrary::GetBinaryPath(const uint64_t& hash)
+{
+    if (s_cacheDirectory.empty())
+    {
+        return "";
+    }
+
+    // Binaries only make sense for the driver that produced them
+    static const uint64_t driverHash = []() {
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        if (!formatCount)
+        {
+            return (uint64_t)0;
+        }
+
+        std::string driver;
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+        {
+            const GLubyte* value = glGetString(name);
+            driver += value ? reinterpret_cast<const char*>(value) : "";
+        }
+        return HashBytes(driver.data(), driver.size());
+    }();
+    if (!driverHash)
+    {
+        return "";
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)HashBytes(&hash, sizeof(hash), driverHash));
+
+    return (std::filesystem::path(s_cacheDirectory) / "shaders" / name).string();
+}
@@ -0,0 +1,61 @@
+#ifndef SHADERLIBRARY_H
+#define SHADERLIBRARY_H
+
+#include "Shader.h"
+
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+
+#define SHADER_BINARY_MAGIC 0x48534d44  // "DMSH"
+#define SHADER_BINARY_VERSION 1
+
+
+struct ShaderBinaryHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t size;
+};
+
+
+// Shaders opened from files are shared by every user of the same sources, identified by a hash of their code.
+// Linked programs are also cached on disk with glGetProgramBinary so that warm starts don't compile anything,
+// falling back on compiling the sources when the driver rejects a cached binary.
+class ShaderLibrary
+{
+public:
+    static ShaderPtr Open(const std::string& vertexPath,
+                          const std::string& fragmentPath,
+                          const std::string& tessCtrlPath="",
+                          const std::string& tessEvalPath="",
+                          const std::string& geometryPath="");
+
+    // Recompiles the opened shaders using the given file in place, returns how many have been reloaded
+    static uint32_t ReloadFile(const std::string& path);
+
+    // Directory the program binaries are written to, they are not cached if empty
+    inline static void SetCacheDirectory(const std::string& directory) { s_cacheDirectory = directory; }
+
+private:
+    struct Entry
+    {
+        ShaderWeakPtr shader;
+        // Vertex, fragment, tessellation control, tessellation evaluation and geometry files
+        std::vector<std::string> paths;
+    };
+
+    static bool ReadSources(const std::vector<std::string>& paths,
+                            std::vector<std::string>& outSources,
+                            uint64_t& outHash);
+    static ShaderPtr Build(const std::vector<std::string>& sources, const uint64_t& hash);
+    static std::string GetBinaryPath(const uint64_t& hash);
+
+    static std::unordered_map<uint64_t, Entry> s_shaders;
+    static std::string s_cacheDirectory;
+};
+
+
+#endif // SHADERLIBRARY_H
@@ -0,0 +1,60 @@
+#include "StorageBuffer.h"
+
+
+StorageBuffer::StorageBuffer(const uint32_t& size) :
+        m_size(size)
+{
+    glGenBuffers(1, &m_id);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_id);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+StorageBuffer::~StorageBuffer()
+{
+    glDeleteBuffers(1, &m_id);
+    m_id = 0;
+}
+
+void StorageBuffer::Attach(const uint32_t& index) const
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, m_id);
+}
+
+void StorageBuffer::Detach(const uint32_t& index) const
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, 0);
+}
+
+void StorageBuffer::Bind() const
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_id);
+}
+
+void StorageBuffer::Unbind() const
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+bool StorageBuffer::IsValid() const
+{
+    return m_id;
+}
+
+void StorageBuffer::Resize(const uint32_t& size)
+{
+    // Respecifying the storage also orphans the previous one, which avoids 
+    // waiting for the draws of the previous frame that might still be using it
+    m_size = size;
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+}
+
+void StorageBuffer::SetData(const void* data, const uint32_t& size, const uint32_t& offset) const
+{
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+}
+
+StorageBufferPtr StorageBuffer::Create(const uint32_t& size)
+{
+    return StorageBufferPtr(new StorageBuffer(size));
+}
@@ -0,0 +1,42 @@
+#ifndef STORAGEBUFFER_H
+#define STORAGEBUFFER_H
+
+#include "Core/Foundations.h"
+
+#include <glad/glad.h>
+
+
+class StorageBuffer;
+
+DECLARE_PTR_TYPE(StorageBuffer);
+
+
+// Shader storage buffer, used to upload data whose size is only known at runtime (light lists for example)
+class StorageBuffer
+{
+public:
+    ~StorageBuffer();
+
+    void Attach(const uint32_t& index) const;
+    void Detach(const uint32_t& index) const;
+
+    void Bind() const;
+    void Unbind() const;
+    bool IsValid() const;
+
+    inline uint32_t GetSize() const { return m_size; }
+
+    // Reallocates the buffer storage, the previous content is lost
+    void Resize(const uint32_t& size);
+    void SetData(const void* data, const uint32_t& size, const uint32_t& offset) const;
+
+    static StorageBufferPtr Create(const uint32_t& size);
+
+private:
+    StorageBuffer(const uint32_t& size);
+
+    GLuint m_id = 0;
+    uint32_t m_size = 0;
+};
+
+#endif  // STORAGEBUFFER_H
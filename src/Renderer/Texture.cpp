@@ -3,29 +3,63 @@
 #include "Core/Image.h"
 #include "Core/Logging.h"
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
 
 uint32_t ChannelsOfGLType(const GLenum& type) {
         switch (type) {
             case GL_RED: 
             case GL_R8:
+            case GL_R16:
+            case GL_R16F:
             case GL_R32F:             return 1;
 
             case GL_RG: 
             case GL_RG8:
+            case GL_RG16:
+            case GL_RG16F:
             case GL_RG32F:            return 2;
 
             case GL_RGB:
             case GL_RGB8: 
+            case GL_SRGB8: 
+            case GL_RGB16:
+            case GL_RGB16F:
             case GL_RGB32F:           return 3;
 
             case GL_RGBA:
             case GL_RGBA8:
+            case GL_SRGB8_ALPHA8:
+            case GL_RGBA16:
+            case GL_RGBA16F:
             case GL_RGBA32F:          return 4;
 
             default:                  return 0;
     }
 }
 
+uint32_t ChannelSizeOfGLType(const GLenum& type) {
+        switch (type) {
+            case GL_R16:
+            case GL_R16F:
+            case GL_RG16:
+            case GL_RG16F:
+            case GL_RGB16:
+            case GL_RGB16F:
+            case GL_RGBA16:
+            case GL_RGBA16F:          return 2;
+
+            case GL_R32F:
+            case GL_RG32F:
+            case GL_RGB32F:
+            case GL_RGBA32F:          return 4;
+
+            default:                  return 1;
+    }
+}
+
 
 Texture::Texture()
 {
@@ -44,22 +78,23 @@ Texture::Texture()
 
 
 Texture::Texture(const uint32_t& width, const uint32_t& height,
-                 const GLenum& internalFormat) : 
+                 const GLenum& internalFormat, const uint32_t& mipCount) : 
         m_width(width),
         m_height(height),
-        m_internalFormat(internalFormat)
+        m_internalFormat(internalFormat),
+        m_mipCount(mipCount)
 {
     glGenTextures(1, &m_id);
     glBindTexture(GL_TEXTURE_2D, m_id);
 
     // Reserve space on the GPU
-    glTexStorage2D(GL_TEXTURE_2D, 1, m_internalFormat, width, height);
+    glTexStorage2D(GL_TEXTURE_2D, mipCount, m_internalFormat, width, height);
 
     // Default wrapping parameters
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     // Default filtering parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -83,6 +118,77 @@ void Texture::BindFromId(const GLuint& id, const GLuint& unit)
     glBindTexture(GL_TEXTURE_2D, id);
 }
 
+bool Texture::IsCompressedFormat(const GLenum& internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            return true;
+    }
+
+    return false;
+}
+
+static bool HasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0 ; i < count ; ++i)
+    {
+        if (strcmp(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)), name) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Texture::IsFormatSupported(const GLenum& internalFormat)
+{
+    if (!IsCompressedFormat(internalFormat))
+    {
+        return true;
+    }
+
+    static const bool s3tc = HasExtension("GL_EXT_texture_compression_s3tc");
+    static const bool s3tcSRGB = s3tc && (HasExtension("GL_EXT_texture_sRGB") || 
+                                          HasExtension("GL_EXT_texture_compression_s3tc_srgb"));
+    switch (internalFormat)
+    {
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            return s3tcSRGB;
+    }
+
+    return s3tc;
+}
+
+size_t Texture::GetGpuMemorySize() const
+{
+    bool compressed = IsCompressedFormat(m_internalFormat);
+    // DXT1 stores 4x4 blocks in 8 bytes, DXT5 in 16 bytes
+    size_t blockSize = (m_internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || 
+                        m_internalFormat == GL_COMPRESSED_SRGB_S3TC_DXT1_EXT) ? 8 : 16;
+    size_t texelSize = ChannelsOfGLType(m_internalFormat) * ChannelSizeOfGLType(m_internalFormat);
+
+    size_t size = 0;
+    for (uint32_t level = 0 ; level < m_mipCount ; ++level)
+    {
+        size_t width = std::max(m_width >> level, 1u);
+        size_t height = std::max(m_height >> level, 1u);
+        if (compressed)
+            size += ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+        else
+            size += width * height * texelSize;
+    }
+
+    return size;
+}
+
 void Texture::Unbind() const
 {
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -117,20 +223,56 @@ void Texture::SetData(const uint32_t& width, const uint32_t& height, void* data,
     m_width = width;
     m_height = height;
     m_internalFormat = internalFormat;
+    m_mipCount = 1;
+    while (std::max(width, height) >> m_mipCount)
+    {
+        m_mipCount++;
+    }
 
     glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, dataFormat, dataType, data);
     glGenerateMipmap(GL_TEXTURE_2D);
 }
 
+void Texture::SetLevelData(const uint32_t& level, const void* data, const uint32_t& size,
+                           const GLenum& dataFormat,
+                           const GLenum& dataType) const
+{
+    uint32_t width = std::max(m_width >> level, 1u);
+    uint32_t height = std::max(m_height >> level, 1u);
+
+    if (dataFormat)
+        glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, dataFormat, dataType, data);
+    else
+        glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, m_internalFormat, size, data);
+}
+
+void Texture::SetChannelSwizzle(const uint32_t& channels) const
+{
+    if (channels <= 2)
+    {
+        GLint swizzle[4] = {GL_RED, GL_RED, GL_RED, channels == 2 ? GL_GREEN : GL_ONE};
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+}
+
+void Texture::Swap(Texture& other)
+{
+    std::swap(m_id, other.m_id);
+    std::swap(m_width, other.m_width);
+    std::swap(m_height, other.m_height);
+    std::swap(m_internalFormat, other.m_internalFormat);
+    std::swap(m_mipCount, other.m_mipCount);
+}
+
 TexturePtr Texture::Create()
 {
     return TexturePtr();
 }
 
 TexturePtr Texture::Create(const uint32_t& width, const uint32_t& height,
-                           const GLenum& internalFormat)
+                           const GLenum& internalFormat, const uint32_t& mipCount)
 {
-    Texture* texture = new Texture(width, height, internalFormat);
+    Texture* texture = new Texture(width, height, internalFormat, std::max(mipCount, 1u));
     return TexturePtr(texture);
 }
 
@@ -141,24 +283,53 @@ TexturePtr Texture::Open(const std::string& path,
     return Texture::FromImage(Image::Read(path, colorSpace), internalFormat);
 }
 
+GLenum Texture::GetImageInternalFormat(const Image& image)
+{
+    // Indexed by component type and channel count
+    static const GLenum formats[4][4] = {
+        {GL_R8,   GL_RG8,   GL_RGB8,   GL_RGBA8},
+        {GL_R16,  GL_RG16,  GL_RGB16,  GL_RGBA16},
+        {GL_R16F, GL_RG16F, GL_RGB16F, GL_RGBA16F},
+        {GL_R32F, GL_RG32F, GL_RGB32F, GL_RGBA32F}
+    };
+
+    uint32_t channels = image.GetChannels();
+    if (image.GetComponentType() == ImageComponentType::UInt8 && image.GetColorSpace() == ColorSpace::sRGB)
+    {
+        if (channels == 3)
+            return GL_SRGB8;
+        if (channels == 4)
+            return GL_SRGB8_ALPHA8;
+    }
+
+    return formats[(uint32_t)image.GetComponentType()][channels - 1];
+}
+
 TexturePtr Texture::FromImage(const ImagePtr& image, const GLenum& internalFormat)
 {
     if (image) {
+        static const GLenum dataFormats[4] = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
+        static const GLenum dataTypes[4] = {GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_HALF_FLOAT, GL_FLOAT};
+
         Texture* texture = new Texture();
 
         glBindTexture(GL_TEXTURE_2D, texture->m_id);
+
+        // Rows of compact images are not always 4 bytes aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
         texture->SetData(image->GetWidth(), 
                          image->GetHeight(),
-                         (void*)image->GetPixels(),
-                         internalFormat,
-                         // dataFormat and dataType are fixed since we only consider images composed of glm::vec4. 
-                         // This should change in the future when the Image implementation will be improved.
-                         GL_RGBA,
-                         GL_FLOAT);  
+                         const_cast<void*>(image->GetData()),
+                         internalFormat ? internalFormat : GetImageInternalFormat(*image),
+                         dataFormats[image->GetChannels() - 1],
+                         dataTypes[(uint32_t)image->GetComponentType()]);  
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        texture->SetChannelSwizzle(image->GetChannels());
         glBindTexture(GL_TEXTURE_2D, 0);
 
         return TexturePtr(texture);
     }
 
     return TexturePtr();
-}
\ No newline at end of file
+}
@@ -7,6 +7,18 @@
 
 #include <glad/glad.h>
 
+
+// S3TC formats are provided by an extension that isn't part of the loaded GL profile
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT          0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT         0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT         0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT   0x8C4F
+#endif
+
+
 class Texture;
 
 
@@ -23,6 +35,13 @@ public:
     bool IsValid() const;
     inline GLuint GetId() const { return m_id; } 
 
+    inline uint32_t GetWidth() const { return m_width; }
+    inline uint32_t GetHeight() const { return m_height; }
+    inline GLenum GetInternalFormat() const { return m_internalFormat; }
+    inline uint32_t GetMipCount() const { return m_mipCount; }
+    // Video memory used by the whole mip chain
+    size_t GetGpuMemorySize() const;
+
     void SetData(void* data, const uint32_t& size, 
                  const GLenum& dataFormat = GL_RGBA,
                  const GLenum& dataType = GL_FLOAT) const;
@@ -30,28 +49,46 @@ public:
                  const GLenum& internalFormat = GL_RGBA8, 
                  const GLenum& dataFormat = GL_RGBA, 
                  const GLenum& dataType = GL_FLOAT);
+    // Fills a single mip level of a texture created with an immutable storage, 
+    // data is considered as compressed blocks when no dataFormat is given
+    void SetLevelData(const uint32_t& level, const void* data, const uint32_t& size,
+                      const GLenum& dataFormat = 0,
+                      const GLenum& dataType = 0) const;
+    // Grey textures are expanded to RGB when sampled, the texture has to be bound
+    void SetChannelSwizzle(const uint32_t& channels) const;
+
+    // Exchanges the GL textures of both objects, used to reload a texture in place
+    void Swap(Texture& other);
 
     static TexturePtr Create();
     static TexturePtr Create(const uint32_t &width, 
                              const uint32_t &height,
-                             const GLenum& internalFormat);
+                             const GLenum& internalFormat,
+                             const uint32_t& mipCount=1);
+    // Without an explicit internal format, the most compact format matching the image layout is used
     static TexturePtr Open(const std::string& path, 
                            const ColorSpace& colorSpace=ColorSpace::None,
-                           const GLenum& internalFormat = GL_RGBA8);
-    static TexturePtr FromImage(const ImagePtr& image, const GLenum& internalFormat = GL_RGBA8);
+                           const GLenum& internalFormat=0);
+    static TexturePtr FromImage(const ImagePtr& image, const GLenum& internalFormat=0);
+
+    static GLenum GetImageInternalFormat(const Image& image);
 
     static void BindFromId(const GLuint& id, const GLuint& unit);
 
+    static bool IsCompressedFormat(const GLenum& internalFormat);
+    static bool IsFormatSupported(const GLenum& internalFormat);
+
 private:
     Texture();
     Texture(const uint32_t &width, const uint32_t &height,
-            const GLenum& internalFormat);
+            const GLenum& internalFormat, const uint32_t& mipCount);
 
     GLuint m_id = 0;
     
     uint32_t m_width = 0;
     uint32_t m_height = 0;
-    GLenum m_internalFormat; 
+    GLenum m_internalFormat = 0; 
+    uint32_t m_mipCount = 1;
 };
 
 #endif  // TEXTURE_H
@@ -50,7 +50,7 @@ VertexBufferPtr VertexBuffer::Create()
     return VertexBufferPtr(buffer);
 }
 
-VertexBufferPtr VertexBuffer::Create(void* data, const GLuint& size)
+VertexBufferPtr VertexBuffer::Create(const void* data, const GLuint& size)
 {
     VertexBuffer* buffer = new VertexBuffer();
     buffer->Bind();
@@ -100,7 +100,7 @@ IndexBufferPtr IndexBuffer::Create()
     return IndexBufferPtr(buffer);
 }
 
-IndexBufferPtr IndexBuffer::Create(GLuint* indices, const uint32_t& count)
+IndexBufferPtr IndexBuffer::Create(const GLuint* indices, const uint32_t& count)
 {
     IndexBuffer* buffer = new IndexBuffer();
     buffer->Bind();
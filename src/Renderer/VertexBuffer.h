@@ -98,7 +98,7 @@ public:
     void SetData(const void* data, const GLuint& size) const;
 
     static VertexBufferPtr Create();
-    static VertexBufferPtr Create(void* data, const GLuint& size);
+    static VertexBufferPtr Create(const void* data, const GLuint& size);
 
 private:
     VertexBuffer();
@@ -123,7 +123,7 @@ public:
     inline GLuint GetCount() const { return m_count; }
 
     static IndexBufferPtr Create();
-    static IndexBufferPtr Create(GLuint* indices, const uint32_t& count);
+    static IndexBufferPtr Create(const GLuint* indices, const uint32_t& count);
 
 private:
     IndexBuffer();
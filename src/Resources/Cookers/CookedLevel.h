@@ -0,0 +1,113 @@
+#ifndef COOKEDLEVEL_H
+#define COOKEDLEVEL_H
+
+#include "CookerUtils.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+// Layout of the cooked levels. The level JSON is validated when cooking it, the cooked file only holds
+// flat arrays of spawn records: the monsters and rewards of each floor are stored contiguously and
+// referenced by ranges from their floor.
+
+#define COOKED_LEVEL_MAGIC 0x4c564d44  // "DMVL"
+#define COOKED_LEVEL_VERSION 1
+
+
+struct CookedLevelHeader
+{
+    uint32_t magic;
+    uint32_t version;
+
+    CookedString name;
+    uint32_t floorCount;
+    uint32_t monsterCount;
+    uint32_t rewardCount;
+    uint32_t padding;
+
+    uint64_t floorsOffset;
+    uint64_t monstersOffset;
+    uint64_t rewardsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct CookedFloor
+{
+    CookedString name;
+    // Path of the map image, relative to the level file
+    CookedString map;
+    uint32_t firstMonster;
+    uint32_t monsterCount;
+    uint32_t firstReward;
+    uint32_t rewardCount;
+};
+
+struct CookedMonster
+{
+    CookedString name;
+    CookedString model;
+    float origin[2];
+    int32_t health;
+    float strength;
+    float attackSpeed;
+    float speed;
+};
+
+enum CookedRewardType : uint32_t
+{
+    CookedReward_Unknown = 0,
+    CookedReward_Weapon,
+    CookedReward_Heal
+};
+
+struct CookedReward
+{
+    CookedString name;
+    CookedString model;
+    float origin[2];
+    uint32_t type;
+    // Weapons only
+    float damage;
+    float attackSpeed;
+    // Heals only
+    float healing;
+};
+
+
+// Validated content of a level, as parsed from its JSON or read from its cooked file
+struct LevelDescription
+{
+    CookedString name;
+    std::vector<CookedFloor> floors;
+    std::vector<CookedMonster> monsters;
+    std::vector<CookedReward> rewards;
+    std::string strings;
+
+    inline std::string GetString(const CookedString& string) const { return strings.substr(string.offset, string.size); }
+
+    CookedString AddString(const char* string, const size_t& size)
+    {
+        CookedString result{(uint32_t)strings.size(), (uint32_t)size};
+        strings.append(string, size);
+        return result;
+    }
+};
+
+
+// Path of the cooked version of a level, or an empty string if the source can't be read
+inline std::string GetCookedLevelPath(const std::string& sourcePath, const std::string& cacheDirectory)
+{
+    uint64_t hash;
+    if (!HashSourceFile(sourcePath, COOKED_LEVEL_VERSION, hash))
+    {
+        return "";
+    }
+
+    return GetCookedPath(cacheDirectory, "Levels", hash, ".dmlvl");
+}
+
+
+#endif // COOKEDLEVEL_H
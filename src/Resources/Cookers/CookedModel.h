@@ -0,0 +1,96 @@
+#ifndef COOKEDMODEL_H
+#define COOKEDMODEL_H
+
+#include "CookerUtils.h"
+
+#include <stdint.h>
+#include <string>
+
+
+// Layout of the cooked models. Everything is stored in flat arrays referenced by offsets from the
+// start of the file so that a model is read straight from a memory mapping: the nodes are stored
+// depth first (parents always come before their children) and the vertices match the Vertex layout.
+// Cooked models are named after the path of their source, the header keeps the hash of the source
+// content that the cooker checks to know whether the model has to be cooked again.
+
+#define COOKED_MODEL_MAGIC 0x444d4d44  // "DMMD"
+#define COOKED_MODEL_VERSION 2
+
+
+struct CookedModelHeader
+{
+    uint32_t magic;
+    uint32_t version;
+
+    uint32_t nodeCount;
+    uint32_t meshCount;
+    uint32_t materialCount;
+    uint32_t padding;
+
+    // See HashSourceFile()
+    uint64_t sourceHash;
+
+    uint64_t nodesOffset;
+    uint64_t meshesOffset;
+    uint64_t materialsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t vertexDataOffset;
+    uint64_t vertexDataSize;
+    uint64_t indexDataOffset;
+    uint64_t indexDataSize;
+};
+
+enum CookedNodeFlags : uint32_t
+{
+    CookedNode_HasTransform = 1 << 0
+};
+
+struct CookedNode
+{
+    // -1 for the root node
+    int32_t parent;
+    uint32_t flags;
+    CookedString name;
+    float transform[16];
+    // -1 for nodes without any mesh
+    int32_t mesh;
+};
+
+struct CookedMesh
+{
+    // Suffix of the identifier of the mesh, relative to the identifier of the model
+    CookedString identifier;
+    uint32_t material;
+    // Offsets in vertices and indices from the start of their data block
+    uint32_t firstVertex;
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+};
+
+enum CookedMaterialFlags : uint32_t
+{
+    CookedMaterial_HasBaseColor = 1 << 0,
+    CookedMaterial_HasEmissionColor = 1 << 1,
+    CookedMaterial_HasTransmissionColor = 1 << 2
+};
+
+struct CookedMaterial
+{
+    CookedString name;
+    uint32_t flags;
+    float baseColor[3];
+    float emissionColor[3];
+    float transmissionColor[3];
+};
+
+
+// Path of the cooked version of a model from its identifier (see Resolver::AsIdentifier), the source is not read
+inline std::string GetCookedModelPath(const std::string& identifier, const std::string& cacheDirectory)
+{
+    return GetCookedPath(cacheDirectory, "Models", HashIdentifier(identifier), ".dmmdl");
+}
+
+
+#endif // COOKEDMODEL_H
@@ -0,0 +1,38 @@
+#include "CookerUtils.h"
+
+#include "Utils/FileUtils.h"
+#include "Utils/TypeUtils.h"
+
+#include <filesystem>
+
+
+bool HashSourceFile(const std::string& sourcePath, const uint32_t& cookerVersion, uint64_t& outHash)
+{
+    MappedFile source;
+    if (!source.Open(sourcePath))
+    {
+        return false;
+    }
+
+    outHash = HashBytes(source.GetData(), source.GetSize());
+    outHash = HashBytes(&cookerVersion, sizeof(uint32_t), outHash);
+
+    return true;
+}
+
+uint64_t HashIdentifier(const std::string& identifier)
+{
+    std::string normalized = std::filesystem::path(identifier).lexically_normal().generic_string();
+    return HashBytes(normalized.data(), normalized.size());
+}
+
+std::string GetCookedPath(const std::string& cacheDirectory, 
+                          const std::string& category,
+                          const uint64_t& hash, 
+                          const std::string& extension)
+{
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)hash);
+
+    return (std::filesystem::path(cacheDirectory) / category / (name + extension)).string();
+}
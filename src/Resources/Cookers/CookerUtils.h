@@ -0,0 +1,44 @@
+#ifndef COOKERUTILS_H
+#define COOKERUTILS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+// Byte range of the string table of a cooked file
+struct CookedString
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+
+// Hashes the content of a source file along with the version of the cooker handling it, 
+// so that both editing the source and changing the cooked format invalidate the cached file
+bool HashSourceFile(const std::string& sourcePath, const uint32_t& cookerVersion, uint64_t& outHash);
+
+// Hashes the identifier of a resource (its path relative to the resources directory), to name its cooked file
+// without having to read the source. Unlike absolute paths, identifiers do not depend on where the game is installed.
+uint64_t HashIdentifier(const std::string& identifier);
+
+// Path of a cooked file in the cache, as <cacheDirectory>/<category>/<hash><extension>
+std::string GetCookedPath(const std::string& cacheDirectory, 
+                          const std::string& category,
+                          const uint64_t& hash, 
+                          const std::string& extension);
+
+// Appends an array to a cooked file, returning its offset from the start of the file
+template <typename T>
+void AppendBlock(std::vector<uint8_t>& output, const T* data, const size_t& count, uint64_t& outOffset)
+{
+    // Keeping every block 8 bytes aligned so that they can be read in place
+    output.resize((output.size() + 7) & ~(size_t)7);
+    outOffset = output.size();
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    output.insert(output.end(), bytes, bytes + count * sizeof(T));
+}
+
+
+#endif // COOKERUTILS_H
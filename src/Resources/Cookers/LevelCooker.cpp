@@ -0,0 +1,670 @@
+#include "LevelCooker.h"
+
+#include "Core/Logging.h"
+
+#include "Utils/FileUtils.h"
+
+#include <rapidjson/reader.h>
+#include <rapidjson/error/en.h>
+
+#include <filesystem>
+#include <cstring>
+#include <vector>
+
+
+// == SAX parsing ==
+
+// Receives the JSON events in order and validates them against the level schema on the fly.
+// Unknown members are skipped, whatever their content.
+class LevelParser : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, LevelParser>
+{
+public:
+    LevelParser(LevelDescription& description) : m_description(description) {}
+
+    bool Null()                 { return Scalar(); }
+    bool Bool(bool)             { return Scalar(); }
+    bool Int(int value)         { return Number(value, true); }
+    bool Uint(unsigned value)   { return Number(value, true); }
+    bool Int64(int64_t value)   { return Number((double)value, true); }
+    bool Uint64(uint64_t value) { return Number((double)value, true); }
+    bool Double(double value)   { return Number(value, false); }
+
+    bool String(const char* string, rapidjson::SizeType length, bool);
+    bool Key(const char* string, rapidjson::SizeType length, bool);
+    bool StartObject();
+    bool EndObject(rapidjson::SizeType);
+    bool StartArray();
+    bool EndArray(rapidjson::SizeType count);
+
+    // Checks that can only be done once the whole document has been read
+    bool Validate();
+
+    inline const std::string& GetError() const { return m_error; }
+
+private:
+    enum class Scope
+    {
+        Level, Floors, Floor, Monsters, Monster, Rewards, Reward, Origin
+    };
+
+    // Members found in the current object, as bits of their index in the member lists below
+    struct Object
+    {
+        Scope scope;
+        uint32_t members;
+    };
+
+    bool Scalar();
+    bool Number(const double& value, const bool& isInteger);
+    // Returns the index of the current key for the given scope, -1 if it is not part of the schema
+    int GetMember() const;
+    bool Fail(const char* error);
+
+    LevelDescription& m_description;
+    std::vector<Object> m_stack;
+    std::string m_key;
+    uint32_t m_originSize = 0;
+    // Depth inside an unknown member being skipped
+    uint32_t m_skipDepth = 0;
+    bool m_hasFloors = false;
+    std::string m_error;
+};
+
+
+static const std::vector<const char*> s_levelMembers = {"name", "floors"};
+static const std::vector<const char*> s_floorMembers = {"name", "map", "monsters", "rewards"};
+static const std::vector<const char*> s_monsterMembers = {"name", "origin", "model", "health", "strength", "attackSpeed", "speed"};
+static const std::vector<const char*> s_rewardMembers = {"name", "origin", "model", "type", "damage", "attackSpeed", "healing"};
+
+// Error reported for each member when it is missing or has the wrong type
+static const std::vector<const char*> s_monsterErrors = {"Invalid monster name.", "Invalid monster origin.", "Invalid monster model.",
+                                                        "Invalid monster health.", "Invalid monster strength.",
+                                                        "Invalid monster attack speed.", "Invalid monster speed."};
+static const std::vector<const char*> s_rewardErrors = {"Invalid reward name.", "Invalid reward origin.", "Invalid reward model.",
+                                                       "Invalid reward type.", "Invalid weapon damage.",
+                                                       "Invalid weapon attack speed.", "Invalid heal healing."};
+
+
+int LevelParser::GetMember() const
+{
+    const std::vector<const char*>* members = nullptr;
+    switch (m_stack.back().scope)
+    {
+        case Scope::Level:   members = &s_levelMembers; break;
+        case Scope::Floor:   members = &s_floorMembers; break;
+        case Scope::Monster: members = &s_monsterMembers; break;
+        case Scope::Reward:  members = &s_rewardMembers; break;
+        default: return -1;
+    }
+
+    for (size_t i = 0 ; i < members->size() ; ++i)
+    {
+        if (m_key == (*members)[i])
+        {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+bool LevelParser::Fail(const char* error)
+{
+    if (m_error.empty())
+    {
+        m_error = error;
+    }
+
+    return false;
+}
+
+bool LevelParser::Scalar()
+{
+    if (m_skipDepth || m_stack.empty())
+    {
+        return true;
+    }
+
+    Scope scope = m_stack.back().scope;
+    if (scope == Scope::Origin)
+    {
+        return Fail(m_stack[m_stack.size() - 2].scope == Scope::Monster ? s_monsterErrors[1] : s_rewardErrors[1]);
+    }
+    if (scope == Scope::Floors)
+    {
+        return Fail("Invalid floor data.");
+    }
+    if (scope == Scope::Monsters || scope == Scope::Rewards)
+    {
+        return Fail(scope == Scope::Monsters ? "Invalid monster data." : "Invalid reward data.");
+    }
+
+    // Only the monsters and rewards have non string members, the other members of the schema are strings
+    int member = GetMember();
+    if (member < 0 || (scope == Scope::Floor && member >= 2))
+    {
+        return true;
+    }
+    if (scope == Scope::Level)
+    {
+        return Fail(member == 0 ? "Invalid level name." : "Invalid floors data.");
+    }
+    if (scope == Scope::Floor)
+    {
+        return Fail("Invalid floor data.");
+    }
+
+    return Fail(scope == Scope::Monster ? s_monsterErrors[member] : s_rewardErrors[member]);
+}
+
+bool LevelParser::Number(const double& value, const bool& isInteger)
+{
+    if (m_skipDepth || m_stack.empty())
+    {
+        return true;
+    }
+
+    Object& object = m_stack.back();
+    if (object.scope == Scope::Origin)
+    {
+        if (m_originSize >= 2)
+        {
+            return Scalar();
+        }
+
+        bool isMonster = m_stack[m_stack.size() - 2].scope == Scope::Monster;
+        float* origin = isMonster ? m_description.monsters.back().origin : m_description.rewards.back().origin;
+        origin[m_originSize++] = (float)value;
+        return true;
+    }
+
+    int member = GetMember();
+    if (object.scope == Scope::Monster)
+    {
+        CookedMonster& monster = m_description.monsters.back();
+        switch (member)
+        {
+            case 3:
+                if (!isInteger)
+                {
+                    return Fail(s_monsterErrors[member]);
+                }
+                monster.health = (int32_t)value;
+                break;
+            case 4: monster.strength = (float)value; break;
+            case 5: monster.attackSpeed = (float)value; break;
+            case 6: monster.speed = (float)value; break;
+            default: return Scalar();
+        }
+    }
+    else if (object.scope == Scope::Reward)
+    {
+        CookedReward& reward = m_description.rewards.back();
+        switch (member)
+        {
+            case 4: reward.damage = (float)value; break;
+            case 5: reward.attackSpeed = (float)value; break;
+            case 6: reward.healing = (float)value; break;
+            default: return Scalar();
+        }
+    }
+    else
+    {
+        return Scalar();
+    }
+
+    object.members |= 1u << member;
+    return true;
+}
+
+bool LevelParser::String(const char* string, rapidjson::SizeType length, bool)
+{
+    if (m_skipDepth || m_stack.empty())
+    {
+        return true;
+    }
+
+    Object& object = m_stack.back();
+    int member = GetMember();
+    switch (object.scope)
+    {
+        case Scope::Level:
+            if (member != 0)
+            {
+                return Scalar();
+            }
+            m_description.name = m_description.AddString(string, length);
+            break;
+
+        case Scope::Floor:
+            if (member != 0 && member != 1)
+            {
+                return Scalar();
+            }
+            (member == 0 ? m_description.floors.back().name : m_description.floors.back().map) = m_description.AddString(string, length);
+            break;
+
+        case Scope::Monster:
+            if (member != 0 && member != 2)
+            {
+                return Scalar();
+            }
+            (member == 0 ? m_description.monsters.back().name : m_description.monsters.back().model) = m_description.AddString(string, length);
+            break;
+
+        case Scope::Reward:
+            if (member == 3)
+            {
+                CookedReward& reward = m_description.rewards.back();
+                reward.type = !strcmp(string, "weapon") ? CookedReward_Weapon :
+                              !strcmp(string, "heal") ? CookedReward_Heal : CookedReward_Unknown;
+                break;
+            }
+            if (member != 0 && member != 2)
+            {
+                return Scalar();
+            }
+            (member == 0 ? m_description.rewards.back().name : m_description.rewards.back().model) = m_description.AddString(string, length);
+            break;
+
+        default:
+            return Scalar();
+    }
+
+    object.members |= 1u << member;
+    return true;
+}
+
+bool LevelParser::Key(const char* string, rapidjson::SizeType length, bool)
+{
+    if (!m_skipDepth)
+    {
+        m_key.assign(string, length);
+    }
+
+    return true;
+}
+
+bool LevelParser::StartObject()
+{
+    if (m_skipDepth)
+    {
+        m_skipDepth++;
+        return true;
+    }
+    if (m_stack.empty())
+    {
+        m_stack.push_back({Scope::Level, 0});
+        return true;
+    }
+
+    switch (m_stack.back().scope)
+    {
+        case Scope::Floors:
+        {
+            CookedFloor floor{};
+            floor.firstMonster = m_description.monsters.size();
+            floor.firstReward = m_description.rewards.size();
+            m_description.floors.push_back(floor);
+            m_stack.push_back({Scope::Floor, 0});
+            return true;
+        }
+        case Scope::Monsters:
+            m_description.monsters.push_back(CookedMonster{});
+            m_stack.push_back({Scope::Monster, 0});
+            return true;
+
+        case Scope::Rewards:
+            m_description.rewards.push_back(CookedReward{});
+            m_stack.push_back({Scope::Reward, 0});
+            return true;
+
+        default:
+            break;
+    }
+
+    // Objects are only expected in arrays, any other object is either the wrong type for a member or skipped
+    Scope scope = m_stack.back().scope;
+    int member = GetMember();
+    bool isSkipped = scope != Scope::Origin && (member < 0 || (scope == Scope::Floor && member >= 2));
+    if (!isSkipped)
+    {
+        return Scalar();
+    }
+
+    m_skipDepth = 1;
+    return true;
+}
+
+bool LevelParser::EndObject(rapidjson::SizeType)
+{
+    if (m_skipDepth)
+    {
+        m_skipDepth--;
+        return true;
+    }
+
+    Object object = m_stack.back();
+    m_stack.pop_back();
+    switch (object.scope)
+    {
+        case Scope::Level:
+            if (!(object.members & (1 << 0)))
+            {
+                return Fail("Invalid level name.");
+            }
+            if (!m_hasFloors)
+            {
+                return Fail("Invalid floors data.");
+            }
+            return true;
+
+        case Scope::Floor:
+        {
+            if ((object.members & 0x3) != 0x3)
+            {
+                return Fail("Invalid floor data.");
+            }
+
+            CookedFloor& floor = m_description.floors.back();
+            floor.monsterCount = m_description.monsters.size() - floor.firstMonster;
+            floor.rewardCount = m_description.rewards.size() - floor.firstReward;
+            return true;
+        }
+
+        case Scope::Monster:
+            for (size_t i = 0 ; i < s_monsterMembers.size() ; ++i)
+            {
+                if (!(object.members & (1u << i)))
+                {
+                    return Fail(s_monsterErrors[i]);
+                }
+            }
+            return true;
+
+        case Scope::Reward:
+        {
+            for (size_t i = 0 ; i < 4 ; ++i)
+            {
+                if (!(object.members & (1u << i)))
+                {
+                    return Fail(s_rewardErrors[i]);
+                }
+            }
+
+            // The other members depend on the type of the reward, unknown types are ignored when building the level
+            uint32_t type = m_description.rewards.back().type;
+            std::vector<size_t> required = type == CookedReward_Weapon ? std::vector<size_t>{4, 5} :
+                                           type == CookedReward_Heal ? std::vector<size_t>{6} : std::vector<size_t>{};
+            for (size_t i : required)
+            {
+                if (!(object.members & (1u << i)))
+                {
+                    return Fail(s_rewardErrors[i]);
+                }
+            }
+            return true;
+        }
+
+        default:
+            return true;
+    }
+}
+
+bool LevelParser::StartArray()
+{
+    if (m_skipDepth)
+    {
+        m_skipDepth++;
+        return true;
+    }
+    if (m_stack.empty())
+    {
+        return Fail("Invalid level data.");
+    }
+
+    Object& object = m_stack.back();
+    int member = GetMember();
+    Scope scope;
+    if (object.scope == Scope::Level && member == 1)
+        scope = Scope::Floors;
+    else if (object.scope == Scope::Floor && member == 2)
+        scope = Scope::Monsters;
+    else if (object.scope == Scope::Floor && member == 3)
+        scope = Scope::Rewards;
+    else if ((object.scope == Scope::Monster || object.scope == Scope::Reward) && member == 1)
+        scope = Scope::Origin;
+    else if (member < 0 && (object.scope == Scope::Level || object.scope == Scope::Floor ||
+                            object.scope == Scope::Monster || object.scope == Scope::Reward))
+    {
+        m_skipDepth = 1;
+        return true;
+    }
+    else
+    {
+        return Scalar();
+    }
+
+    if (scope == Scope::Origin)
+    {
+        m_originSize = 0;
+    }
+    object.members |= 1u << member;
+    m_stack.push_back({scope, 0});
+    return true;
+}
+
+bool LevelParser::EndArray(rapidjson::SizeType count)
+{
+    if (m_skipDepth)
+    {
+        m_skipDepth--;
+        return true;
+    }
+
+    Scope scope = m_stack.back().scope;
+    m_stack.pop_back();
+    if (scope == Scope::Origin && count != 2)
+    {
+        return Fail(m_stack.back().scope == Scope::Monster ? s_monsterErrors[1] : s_rewardErrors[1]);
+    }
+    if (scope == Scope::Floors)
+    {
+        m_hasFloors = count > 0;
+    }
+
+    return true;
+}
+
+bool LevelParser::Validate()
+{
+    if (m_description.floors.empty())
+    {
+        return Fail("Invalid floors data.");
+    }
+
+    return true;
+}
+
+
+// == LevelCooker ==
+
+bool LevelCooker::Parse(const std::string& json, LevelDescription& outDescription, std::string& outError)
+{
+    outDescription = LevelDescription();
+
+    LevelParser parser(outDescription);
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(json.c_str());
+    rapidjson::ParseResult result = reader.Parse(stream, parser);
+    if (result.IsError() || !parser.Validate())
+    {
+        outError = !parser.GetError().empty() ? parser.GetError() :
+                   std::string("Invalid level data: ") + rapidjson::GetParseError_En(result.Code()) +
+                   " (offset " + std::to_string(result.Offset()) + ")";
+        return false;
+    }
+
+    return true;
+}
+
+bool LevelCooker::Write(const LevelDescription& description, const std::string& cookedPath)
+{
+    CookedLevelHeader header{};
+    header.magic = COOKED_LEVEL_MAGIC;
+    header.version = COOKED_LEVEL_VERSION;
+    header.name = description.name;
+    header.floorCount = description.floors.size();
+    header.monsterCount = description.monsters.size();
+    header.rewardCount = description.rewards.size();
+    header.stringsSize = description.strings.size();
+
+    std::vector<uint8_t> output(sizeof(CookedLevelHeader));
+    AppendBlock(output, description.floors.data(), description.floors.size(), header.floorsOffset);
+    AppendBlock(output, description.monsters.data(), description.monsters.size(), header.monstersOffset);
+    AppendBlock(output, description.rewards.data(), description.rewards.size(), header.rewardsOffset);
+    AppendBlock(output, description.strings.data(), description.strings.size(), header.stringsOffset);
+    memcpy(output.data(), &header, sizeof(CookedLevelHeader));
+
+    return WriteFile(cookedPath, output.data(), output.size());
+}
+
+bool LevelCooker::Load(const std::string& cookedPath, LevelDescription& outDescription)
+{
+    MappedFile file;
+    if (!file.Open(cookedPath) || file.GetSize() < sizeof(CookedLevelHeader))
+    {
+        return false;
+    }
+
+    CookedLevelHeader header;
+    memcpy(&header, file.GetData(), sizeof(CookedLevelHeader));
+    if (header.magic != COOKED_LEVEL_MAGIC || header.version != COOKED_LEVEL_VERSION || !header.floorCount)
+    {
+        return false;
+    }
+
+    auto isInFile = [&file](const uint64_t& offset, const uint64_t& size) {
+        return offset % 8 == 0 && offset <= file.GetSize() && size <= file.GetSize() - offset;
+    };
+    if (!isInFile(header.floorsOffset, (uint64_t)header.floorCount * sizeof(CookedFloor)) ||
+        !isInFile(header.monstersOffset, (uint64_t)header.monsterCount * sizeof(CookedMonster)) ||
+        !isInFile(header.rewardsOffset, (uint64_t)header.rewardCount * sizeof(CookedReward)) ||
+        !isInFile(header.stringsOffset, header.stringsSize))
+    {
+        return false;
+    }
+
+    auto read = [&file](auto& output, const uint64_t& offset, const uint32_t& count) {
+        output.resize(count);
+        memcpy(output.data(), file.GetData() + offset, count * sizeof(output[0]));
+    };
+
+    LevelDescription& description = outDescription;
+    description.name = header.name;
+    read(description.floors, header.floorsOffset, header.floorCount);
+    read(description.monsters, header.monstersOffset, header.monsterCount);
+    read(description.rewards, header.rewardsOffset, header.rewardCount);
+    description.strings.assign(reinterpret_cast<const char*>(file.GetData() + header.stringsOffset), header.stringsSize);
+
+    // The content has been validated when cooking it, only the references are checked
+    auto isValidString = [&header](const CookedString& string) {
+        return (uint64_t)string.offset + string.size <= header.stringsSize;
+    };
+    if (!isValidString(description.name))
+    {
+        return false;
+    }
+    for (const auto& floor : description.floors)
+    {
+        if (!isValidString(floor.name) || !isValidString(floor.map) ||
+            (uint64_t)floor.firstMonster + floor.monsterCount > header.monsterCount ||
+            (uint64_t)floor.firstReward + floor.rewardCount > header.rewardCount)
+        {
+            return false;
+        }
+    }
+    for (const auto& monster : description.monsters)
+    {
+        if (!isValidString(monster.name) || !isValidString(monster.model))
+        {
+            return false;
+        }
+    }
+    for (const auto& reward : description.rewards)
+    {
+        if (!isValidString(reward.name) || !isValidString(reward.model))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LevelCooker::Read(const std::string& sourcePath, const std::string& cacheDirectory, LevelDescription& outDescription)
+{
+    std::string cookedPath = GetCookedLevelPath(sourcePath, cacheDirectory);
+    if (cookedPath.empty())
+    {
+        LOG_ERROR("Could not load level %s", sourcePath.c_str());
+        return false;
+    }
+    if (std::filesystem::exists(cookedPath) && Load(cookedPath, outDescription))
+    {
+        return true;
+    }
+
+    std::string content;
+    std::string error;
+    if (!ReadFile(sourcePath, content))
+    {
+        LOG_ERROR("Could not load level %s", sourcePath.c_str());
+        return false;
+    }
+    if (!Parse(content, outDescription, error))
+    {
+        LOG_ERROR("%s", error.c_str());
+        return false;
+    }
+
+    // Failing to write the cache only means the level is parsed again next time
+    if (!Write(outDescription, cookedPath))
+    {
+        LOG_WARNING("Could not write the cooked level %s", cookedPath.c_str());
+    }
+
+    return true;
+}
+
+std::string LevelCooker::Cook(const std::string& sourcePath, const std::string& cacheDirectory)
+{
+    std::string cookedPath = GetCookedLevelPath(sourcePath, cacheDirectory);
+    if (cookedPath.empty())
+    {
+        LOG_ERROR("Could not cook level %s, the file could not be opened.", sourcePath.c_str());
+        return "";
+    }
+    if (std::filesystem::exists(cookedPath))
+    {
+        return cookedPath;
+    }
+
+    std::string content;
+    std::string error;
+    LevelDescription description;
+    if (!ReadFile(sourcePath, content) || !Parse(content, description, error))
+    {
+        LOG_ERROR("Could not cook level %s : %s", sourcePath.c_str(), error.c_str());
+        return "";
+    }
+    if (!Write(description, cookedPath))
+    {
+        LOG_ERROR("Could not write the cooked level %s", cookedPath.c_str());
+        return "";
+    }
+
+    LOG_INFO("Cooked level %s", sourcePath.c_str());
+
+    return cookedPath;
+}
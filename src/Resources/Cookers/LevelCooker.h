@@ -0,0 +1,30 @@
+#ifndef LEVELCOOKER_H
+#define LEVELCOOKER_H
+
+#include "CookedLevel.h"
+
+#include <string>
+
+
+// Levels are described in JSON, parsed with a streaming (SAX) reader that validates the schema as it goes
+// and fills flat spawn records without building any document. The records are written as is in the cache
+// so that loading a level that has not been edited since it was cooked skips the parsing altogether.
+class LevelCooker
+{
+public:
+    // Returns the path to the cooked level, cooking it when the cache doesn't hold it yet
+    static std::string Cook(const std::string& sourcePath, const std::string& cacheDirectory);
+
+    // Parses and validates a level JSON, outError describes the first invalid value
+    static bool Parse(const std::string& json, LevelDescription& outDescription, std::string& outError);
+    static bool Write(const LevelDescription& description, const std::string& cookedPath);
+
+    // Returns false if the file is invalid
+    static bool Load(const std::string& cookedPath, LevelDescription& outDescription);
+
+    // Reads a level from the cache, cooking it first if needed
+    static bool Read(const std::string& sourcePath, const std::string& cacheDirectory, LevelDescription& outDescription);
+};
+
+
+#endif // LEVELCOOKER_H
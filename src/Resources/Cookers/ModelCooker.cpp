@@ -0,0 +1,270 @@
+#include "ModelCooker.h"
+#include "CookedModel.h"
+
+#include "Core/Logging.h"
+#include "Core/Resolver.h"
+
+#include "Renderer/Mesh.h"
+
+#include "Utils/FileUtils.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#include <assimp/material.h>
+
+#include <filesystem>
+#include <cstring>
+#include <vector>
+
+
+// Flat version of the model, written as is in the cooked file
+struct ModelCookerData
+{
+    std::vector<CookedNode> nodes;
+    std::vector<CookedMesh> meshes;
+    std::vector<CookedMaterial> materials;
+    std::string strings;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    // Vertex and index ranges of each assimp mesh, meshes used by several nodes share their data
+    std::vector<CookedMesh> meshData;
+
+    CookedString AddString(const std::string& string)
+    {
+        CookedString result{(uint32_t)strings.size(), (uint32_t)string.size()};
+        strings += string;
+        return result;
+    }
+};
+
+
+static void ProcessMeshData(const aiMesh* aiMesh, ModelCookerData& data, CookedMesh& meshData)
+{
+    meshData.material = aiMesh->mMaterialIndex;
+    meshData.firstVertex = data.vertices.size();
+    meshData.vertexCount = aiMesh->mNumVertices;
+    for (size_t i = 0; i < aiMesh->mNumVertices; i++)
+    {
+        Vertex vertex;
+        vertex.position = {aiMesh->mVertices[i].x,
+                           aiMesh->mVertices[i].y,
+                           aiMesh->mVertices[i].z};
+
+        if (aiMesh->HasNormals())
+        {
+            vertex.normal = {aiMesh->mNormals[i].x,
+                             aiMesh->mNormals[i].y,
+                             aiMesh->mNormals[i].z};
+            vertex.normal = glm::normalize(vertex.normal);
+        }
+        else
+            vertex.normal = {0.0f, 0.0f, 0.0f};
+
+        if (aiMesh->HasTextureCoords(0))
+            vertex.texCoords = {aiMesh->mTextureCoords[0][i].x,
+                                aiMesh->mTextureCoords[0][i].y};
+        else
+            vertex.texCoords = {0.0f, 0.0f};
+
+        data.vertices.push_back(vertex);
+    }
+
+    meshData.firstIndex = data.indices.size();
+    for (size_t f = 0; f < aiMesh->mNumFaces; f++)
+    {
+        for (size_t i = 0; i < aiMesh->mFaces[f].mNumIndices; i++)
+        {
+            data.indices.push_back(aiMesh->mFaces[f].mIndices[i]);
+        }
+    }
+    meshData.indexCount = data.indices.size() - meshData.firstIndex;
+}
+
+static int32_t AddNode(const std::string& name, const int32_t& parent, ModelCookerData& data)
+{
+    CookedNode node{};
+    node.parent = parent;
+    node.name = data.AddString(name);
+    node.mesh = -1;
+    data.nodes.push_back(node);
+
+    return data.nodes.size() - 1;
+}
+
+static void AddMesh(const uint32_t& meshIndex, const std::string& identifier, const int32_t& node, ModelCookerData& data)
+{
+    CookedMesh mesh = data.meshData[meshIndex];
+    mesh.identifier = data.AddString(identifier);
+    data.meshes.push_back(mesh);
+    data.nodes[node].mesh = data.meshes.size() - 1;
+}
+
+// Mirrors the hierarchy the model used to be loaded as, nodes holding several meshes get a child per mesh
+static void ProcessNode(const aiNode* node, const int32_t& nodeIndex, const std::string& identifier, ModelCookerData& data)
+{
+    std::string nodeName = node->mName.C_Str();
+    std::string currentIdentifier = identifier + "/" + nodeName;
+
+    CookedNode& cookedNode = data.nodes[nodeIndex];
+    cookedNode.flags |= CookedNode_HasTransform;
+    glm::mat4 transform = glm::transpose(glm::make_mat4(&node->mTransformation.a1));
+    memcpy(cookedNode.transform, &transform[0][0], sizeof(cookedNode.transform));
+
+    // One mesh, adding its info to the current node
+    if (node->mNumMeshes == 1)
+    {
+        AddMesh(node->mMeshes[0], currentIdentifier, nodeIndex, data);
+    }
+    // Multiple meshes, adding them as children
+    else if (node->mNumMeshes)
+    {
+        std::string meshName = nodeName + "_msh";
+        AddMesh(node->mMeshes[0], currentIdentifier, AddNode(meshName, nodeIndex, data), data);
+        for (size_t i = 1; i < node->mNumMeshes; i++)
+        {
+            AddMesh(node->mMeshes[i],
+                    currentIdentifier + "_" + std::to_string(i),
+                    AddNode(meshName + std::to_string(i), nodeIndex, data),
+                    data);
+        }
+    }
+
+    for (size_t i = 0; i < node->mNumChildren; i++)
+    {
+        int32_t child = AddNode(node->mChildren[i]->mName.C_Str(), nodeIndex, data);
+        ProcessNode(node->mChildren[i], child, currentIdentifier, data);
+    }
+}
+
+static void CopyColor(const aiColor3D& color, float* outColor)
+{
+    outColor[0] = color.r;
+    outColor[1] = color.g;
+    outColor[2] = color.b;
+}
+
+static void ProcessMaterials(const aiScene* scene, ModelCookerData& data)
+{
+    data.materials.reserve(scene->mNumMaterials);
+    for (size_t i = 0; i < scene->mNumMaterials; i++)
+    {
+        auto aiMaterial = scene->mMaterials[i];
+
+        CookedMaterial material{};
+        material.name = data.AddString(aiMaterial->GetName().C_Str());
+        material.flags = CookedMaterial_HasBaseColor;
+
+        aiColor3D color;
+        // Should sample the pbr material but assimp has some issues with it.
+        // Using the Blinn/Phong keys instead
+        if (aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, color) != AI_FAILURE)
+            CopyColor(color, material.baseColor);
+        else
+            material.baseColor[1] = 1.0f;
+
+        if (aiMaterial->Get(AI_MATKEY_COLOR_AMBIENT, color) != AI_FAILURE)
+        {
+            material.flags |= CookedMaterial_HasEmissionColor;
+            CopyColor(color, material.emissionColor);
+        }
+
+        if (aiMaterial->Get(AI_MATKEY_COLOR_TRANSPARENT, color) != AI_FAILURE)
+        {
+            material.flags |= CookedMaterial_HasTransmissionColor;
+            CopyColor(color, material.transmissionColor);
+        }
+
+        data.materials.push_back(material);
+    }
+}
+
+// The cooked file is reused when it was cooked from the same source content by the same version of the cooker
+static bool IsUpToDate(const std::string& cookedPath, const uint64_t& sourceHash)
+{
+    MappedFile file;
+    if (!file.Open(cookedPath) || file.GetSize() < sizeof(CookedModelHeader))
+    {
+        return false;
+    }
+
+    CookedModelHeader header;
+    memcpy(&header, file.GetData(), sizeof(CookedModelHeader));
+    return header.magic == COOKED_MODEL_MAGIC && header.version == COOKED_MODEL_VERSION && header.sourceHash == sourceHash;
+}
+
+std::string ModelCooker::Cook(const std::string& sourcePath, const std::string& cacheDirectory)
+{
+    uint64_t sourceHash;
+    if (!HashSourceFile(sourcePath, COOKED_MODEL_VERSION, sourceHash))
+    {
+        LOG_ERROR("Could not cook model %s, the file could not be opened.", sourcePath.c_str());
+        return "";
+    }
+
+    std::string cookedPath = GetCookedModelPath(Resolver::Get().AsIdentifier(sourcePath), cacheDirectory);
+    if (IsUpToDate(cookedPath, sourceHash))
+    {
+        return cookedPath;
+    }
+
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(
+        sourcePath,
+        aiProcess_Triangulate | aiProcess_GenSmoothNormals);
+
+    if (!scene || !scene->mRootNode)
+    {
+        LOG_ERROR("Could not load model %s : %s", sourcePath.c_str(), importer.GetErrorString());
+        return "";
+    }
+    if (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)
+    {
+        LOG_ERROR("Model %s is empty, not loading anything...", sourcePath.c_str());
+        return "";
+    }
+
+    ModelCookerData data;
+    ProcessMaterials(scene, data);
+
+    data.meshData.resize(scene->mNumMeshes);
+    for (size_t i = 0; i < scene->mNumMeshes; i++)
+    {
+        ProcessMeshData(scene->mMeshes[i], data, data.meshData[i]);
+    }
+
+    ProcessNode(scene->mRootNode, AddNode(scene->mRootNode->mName.C_Str(), -1, data), ":", data);
+
+    CookedModelHeader header{};
+    header.magic = COOKED_MODEL_MAGIC;
+    header.version = COOKED_MODEL_VERSION;
+    header.nodeCount = data.nodes.size();
+    header.meshCount = data.meshes.size();
+    header.materialCount = data.materials.size();
+    header.sourceHash = sourceHash;
+    header.stringsSize = data.strings.size();
+    header.vertexDataSize = data.vertices.size() * sizeof(Vertex);
+    header.indexDataSize = data.indices.size() * sizeof(uint32_t);
+
+    std::vector<uint8_t> output(sizeof(CookedModelHeader));
+    AppendBlock(output, data.nodes.data(), data.nodes.size(), header.nodesOffset);
+    AppendBlock(output, data.meshes.data(), data.meshes.size(), header.meshesOffset);
+    AppendBlock(output, data.materials.data(), data.materials.size(), header.materialsOffset);
+    AppendBlock(output, data.strings.data(), data.strings.size(), header.stringsOffset);
+    AppendBlock(output, data.vertices.data(), data.vertices.size(), header.vertexDataOffset);
+    AppendBlock(output, data.indices.data(), data.indices.size(), header.indexDataOffset);
+    memcpy(output.data(), &header, sizeof(CookedModelHeader));
+
+    if (!WriteFile(cookedPath, output.data(), output.size()))
+    {
+        LOG_ERROR("Could not write the cooked model %s", cookedPath.c_str());
+        return "";
+    }
+
+    LOG_INFO("Cooked model %s", sourcePath.c_str());
+
+    return cookedPath;
+}
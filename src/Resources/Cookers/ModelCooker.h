@@ -0,0 +1,18 @@
+#ifndef MODELCOOKER_H
+#define MODELCOOKER_H
+
+#include <string>
+
+
+// Imports models with Assimp and writes them in the cooked layout described in CookedModel.h.
+// Only the cooker tool (and the game when built with runtime cooking) depends on Assimp,
+// the ModelLoader reads the cooked files.
+class ModelCooker
+{
+public:
+    // Returns the path to the cooked model, cooking it when the cache doesn't hold it yet or when its source changed
+    static std::string Cook(const std::string& sourcePath, const std::string& cacheDirectory);
+};
+
+
+#endif // MODELCOOKER_H
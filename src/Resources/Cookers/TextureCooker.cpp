@@ -0,0 +1,392 @@
+#include "TextureCooker.h"
+#include "CookerUtils.h"
+
+#include "Core/Logging.h"
+
+#include "Utils/FileUtils.h"
+#include "Utils/TypeUtils.h"
+
+#include <glm/gtc/packing.hpp>
+
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+#include <algorithm>
+#include <limits>
+#include <filesystem>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+
+// == Mip generation ==
+
+// Mips are computed on linear RGBA values, grey images only use the red and alpha components
+struct MipLevel
+{
+    uint32_t width;
+    uint32_t height;
+    std::vector<glm::vec4> pixels;
+};
+
+static uint32_t GetMipCount(const uint32_t& width, const uint32_t& height)
+{
+    uint32_t count = 1;
+    while ((width >> count) || (height >> count))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+static MipLevel DecodeImage(const Image& image, const bool& sRGB)
+{
+    MipLevel level{image.GetWidth(), image.GetHeight()};
+    level.pixels.resize((size_t)level.width * level.height);
+    for (uint32_t y = 0 ; y < level.height ; ++y)
+    {
+        for (uint32_t x = 0 ; x < level.width ; ++x)
+        {
+            glm::vec4 pixel = image.GetPixel(x, y);
+            if (sRGB)
+            {
+                pixel = glm::vec4(glm::pow(glm::vec3(pixel), glm::vec3(2.2f)), pixel.w);
+            }
+            level.pixels[(size_t)y * level.width + x] = pixel;
+        }
+    }
+
+    return level;
+}
+
+// Simple box filter, the last row and column are repeated on odd sizes
+static MipLevel Downsample(const MipLevel& source)
+{
+    MipLevel level{std::max(source.width >> 1, 1u), std::max(source.height >> 1, 1u)};
+    level.pixels.resize((size_t)level.width * level.height);
+    for (uint32_t y = 0 ; y < level.height ; ++y)
+    {
+        uint32_t y0 = std::min(y * 2, source.height - 1);
+        uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+        for (uint32_t x = 0 ; x < level.width ; ++x)
+        {
+            uint32_t x0 = std::min(x * 2, source.width - 1);
+            uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+            level.pixels[(size_t)y * level.width + x] = (source.pixels[(size_t)y0 * source.width + x0] +
+                                                         source.pixels[(size_t)y0 * source.width + x1] +
+                                                         source.pixels[(size_t)y1 * source.width + x0] +
+                                                         source.pixels[(size_t)y1 * source.width + x1]) * 0.25f;
+        }
+    }
+
+    return level;
+}
+
+static uint8_t EncodeUInt8(const float& value, const bool& sRGB)
+{
+    float encoded = sRGB ? std::pow(std::max(value, 0.0f), 1.0f / 2.2f) : value;
+    return (uint8_t)std::round(glm::clamp(encoded, 0.0f, 1.0f) * 255.0f);
+}
+
+// Writes the level in the given layout, alpha is always linear
+static void EncodeLevel(const MipLevel& level,
+                        const uint32_t& channels,
+                        const ImageComponentType& componentType,
+                        const bool& sRGB,
+                        std::vector<uint8_t>& output)
+{
+    size_t offset = output.size();
+    size_t componentCount = level.pixels.size() * channels;
+    output.resize(offset + componentCount * Image::GetComponentSize(componentType));
+
+    uint8_t* data = output.data() + offset;
+    for (size_t i = 0 ; i < level.pixels.size() ; ++i)
+    {
+        const glm::vec4& pixel = level.pixels[i];
+        float values[4] = {pixel.x, pixel.y, pixel.z, pixel.w};
+        if (channels == 2)
+        {
+            values[1] = pixel.w;
+        }
+
+        for (uint32_t c = 0 ; c < channels ; ++c)
+        {
+            size_t index = i * channels + c;
+            bool isAlpha = (channels == 2 && c == 1) || c == 3;
+            switch (componentType)
+            {
+                case ImageComponentType::UInt8:
+                    data[index] = EncodeUInt8(values[c], sRGB && !isAlpha);
+                    break;
+                case ImageComponentType::UInt16:
+                    reinterpret_cast<uint16_t*>(data)[index] = (uint16_t)std::round(glm::clamp(values[c], 0.0f, 1.0f) * 65535.0f);
+                    break;
+                case ImageComponentType::Float16:
+                    reinterpret_cast<uint16_t*>(data)[index] = glm::packHalf1x16(values[c]);
+                    break;
+                case ImageComponentType::Float32:
+                    reinterpret_cast<float*>(data)[index] = values[c];
+                    break;
+            }
+        }
+    }
+}
+
+// Compresses RGBA8 pixels into BC1 (8 bytes) or BC3 (16 bytes) 4x4 blocks
+static void CompressLevel(const uint8_t* pixels,
+                          const uint32_t& width,
+                          const uint32_t& height,
+                          const bool& alpha,
+                          std::vector<uint8_t>& output)
+{
+    uint32_t blockSize = alpha ? 16 : 8;
+    uint32_t blocksX = (width + 3) / 4;
+    uint32_t blocksY = (height + 3) / 4;
+
+    size_t offset = output.size();
+    output.resize(offset + (size_t)blocksX * blocksY * blockSize);
+
+    uint8_t block[64];
+    for (uint32_t by = 0 ; by < blocksY ; ++by)
+    {
+        for (uint32_t bx = 0 ; bx < blocksX ; ++bx)
+        {
+            // Blocks overlapping the border repeat the last pixels
+            for (uint32_t y = 0 ; y < 4 ; ++y)
+            {
+                uint32_t py = std::min(by * 4 + y, height - 1);
+                for (uint32_t x = 0 ; x < 4 ; ++x)
+                {
+                    uint32_t px = std::min(bx * 4 + x, width - 1);
+                    memcpy(block + (y * 4 + x) * 4, pixels + ((size_t)py * width + px) * 4, 4);
+                }
+            }
+
+            stb_compress_dxt_block(output.data() + offset, block, alpha, STB_DXT_HIGHQUAL);
+            offset += blockSize;
+        }
+    }
+}
+
+
+// == Cooker ==
+
+std::string TextureCooker::Cook(const std::string& sourcePath,
+                                const std::string& cacheDirectory,
+                                const TextureCookSettings& settings)
+{
+    uint64_t hash;
+    if (!HashSourceFile(sourcePath, COOKED_TEXTURE_VERSION, hash))
+    {
+        LOG_ERROR("Could not cook texture %s, the file could not be opened.", sourcePath.c_str());
+        return "";
+    }
+
+    // The extension drives the color space the image is read with
+    std::string extension = std::filesystem::path(sourcePath).extension().string();
+    hash = HashBytes(extension.data(), extension.size(), hash);
+    hash = HashBytes(&settings.generateMips, sizeof(bool), hash);
+    hash = HashBytes(&settings.compress, sizeof(bool), hash);
+
+    std::string cookedPath = GetCookedPath(cacheDirectory, "Textures", hash, ".dmtex");
+    if (std::filesystem::exists(cookedPath))
+    {
+        return cookedPath;
+    }
+
+    ImagePtr image = Image::Read(sourcePath);
+    if (!image || !Write(*image, cookedPath, settings))
+    {
+        LOG_ERROR("Could not cook texture %s", sourcePath.c_str());
+        return "";
+    }
+
+    LOG_INFO("Cooked texture %s", sourcePath.c_str());
+
+    return cookedPath;
+}
+
+bool TextureCooker::Write(const Image& image,
+                          const std::string& cookedPath,
+                          const TextureCookSettings& settings)
+{
+    static const GLenum dataFormats[4] = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
+    static const GLenum dataTypes[4] = {GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_HALF_FLOAT, GL_FLOAT};
+
+    const uint32_t channels = image.GetChannels();
+    const ImageComponentType componentType = image.GetComponentType();
+    const bool sRGB = image.GetColorSpace() == ColorSpace::sRGB &&
+                      componentType == ImageComponentType::UInt8 &&
+                      channels >= 3;
+    const bool compress = settings.compress && componentType == ImageComponentType::UInt8 && channels >= 3;
+
+    bool alpha = false;
+    if (compress && channels == 4)
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(image.GetData());
+        for (size_t i = 3 ; i < image.GetDataSize() && !alpha ; i += 4)
+        {
+            alpha = data[i] != 255;
+        }
+    }
+
+    CookedTextureHeader header{};
+    header.magic = COOKED_TEXTURE_MAGIC;
+    header.version = COOKED_TEXTURE_VERSION;
+    header.width = image.GetWidth();
+    header.height = image.GetHeight();
+    header.channels = channels;
+    header.mipCount = settings.generateMips ? GetMipCount(header.width, header.height) : 1;
+    if (compress)
+    {
+        if (alpha)
+            header.internalFormat = sRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        else
+            header.internalFormat = sRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+    else
+    {
+        header.internalFormat = Texture::GetImageInternalFormat(image);
+        header.dataFormat = dataFormats[channels - 1];
+        header.dataType = dataTypes[(uint32_t)componentType];
+    }
+
+    std::vector<CookedTextureLevel> levels(header.mipCount);
+    std::vector<uint8_t> levelData;
+    std::vector<uint8_t> rgba;
+
+    MipLevel mip;
+    if (header.mipCount > 1 || compress)
+    {
+        mip = DecodeImage(image, sRGB);
+    }
+
+    for (uint32_t i = 0 ; i < header.mipCount ; ++i)
+    {
+        if (i > 0)
+        {
+            mip = Downsample(mip);
+        }
+
+        levels[i].offset = levelData.size();
+        if (compress)
+        {
+            rgba.clear();
+            EncodeLevel(mip, 4, ImageComponentType::UInt8, sRGB, rgba);
+            CompressLevel(rgba.data(), mip.width, mip.height, alpha, levelData);
+        }
+        else if (i == 0)
+        {
+            // The first level is stored as decoded to avoid any precision loss
+            const uint8_t* data = static_cast<const uint8_t*>(image.GetData());
+            levelData.insert(levelData.end(), data, data + image.GetDataSize());
+        }
+        else
+        {
+            EncodeLevel(mip, channels, componentType, sRGB, levelData);
+        }
+        levels[i].size = levelData.size() - levels[i].offset;
+    }
+
+    // Offsets are written relative to the start of the file
+    size_t dataOffset = sizeof(CookedTextureHeader) + levels.size() * sizeof(CookedTextureLevel);
+    for (auto& level : levels)
+    {
+        level.offset += dataOffset;
+    }
+
+    std::vector<uint8_t> output(dataOffset);
+    memcpy(output.data(), &header, sizeof(CookedTextureHeader));
+    memcpy(output.data() + sizeof(CookedTextureHeader), levels.data(), levels.size() * sizeof(CookedTextureLevel));
+    output.insert(output.end(), levelData.begin(), levelData.end());
+
+    return WriteFile(cookedPath, output.data(), output.size());
+}
+
+TexturePtr TextureCooker::Load(const std::string& cookedPath)
+{
+    CookedTexture cookedTexture;
+    if (!cookedTexture.Open(cookedPath))
+    {
+        return TexturePtr();
+    }
+
+    size_t budget = std::numeric_limits<size_t>::max();
+    cookedTexture.Upload(budget);
+
+    return cookedTexture.GetTexture();
+}
+
+TextureCookSettings TextureCooker::GetDefaultSettings()
+{
+    TextureCookSettings settings;
+    settings.compress = Texture::IsFormatSupported(GL_COMPRESSED_RGB_S3TC_DXT1_EXT) &&
+                        Texture::IsFormatSupported(GL_COMPRESSED_SRGB_S3TC_DXT1_EXT);
+
+    return settings;
+}
+
+
+// == CookedTexture ==
+
+bool CookedTexture::Open(const std::string& cookedPath)
+{
+    if (!m_file.Open(cookedPath))
+    {
+        return false;
+    }
+
+    ASSERT_OR_RETURN(m_file.GetSize() >= sizeof(CookedTextureHeader), false,
+                     "Invalid cooked texture %s", cookedPath.c_str())
+    memcpy(&m_header, m_file.GetData(), sizeof(CookedTextureHeader));
+
+    size_t tableEnd = sizeof(CookedTextureHeader) + (size_t)m_header.mipCount * sizeof(CookedTextureLevel);
+    ASSERT_OR_RETURN(m_header.magic == COOKED_TEXTURE_MAGIC &&
+                     m_header.version == COOKED_TEXTURE_VERSION &&
+                     m_header.mipCount > 0 && m_header.mipCount <= 32 &&
+                     m_header.channels > 0 && m_header.channels <= 4 &&
+                     m_file.GetSize() >= tableEnd,
+                     false,
+                     "Invalid cooked texture %s", cookedPath.c_str())
+
+    m_levels.resize(m_header.mipCount);
+    memcpy(m_levels.data(), m_file.GetData() + sizeof(CookedTextureHeader), m_levels.size() * sizeof(CookedTextureLevel));
+    for (const auto& level : m_levels)
+    {
+        ASSERT_OR_RETURN(level.offset >= tableEnd && level.offset + level.size <= m_file.GetSize(), false,
+                         "Invalid cooked texture %s", cookedPath.c_str())
+    }
+
+    // The supported formats are queried once on the main thread by GetDefaultSettings()
+    return Texture::IsFormatSupported(m_header.internalFormat);
+}
+
+bool CookedTexture::Upload(size_t& budget)
+{
+    if (!m_texture)
+    {
+        m_texture = Texture::Create(m_header.width, m_header.height, m_header.internalFormat, m_header.mipCount);
+    }
+
+    m_texture->Bind(0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    do
+    {
+        const CookedTextureLevel& level = m_levels[m_nextLevel];
+        m_texture->SetLevelData(m_nextLevel, m_file.GetData() + level.offset, level.size, m_header.dataFormat, m_header.dataType);
+        budget -= std::min<size_t>(budget, level.size);
+        m_nextLevel++;
+    } while (budget && m_nextLevel < m_levels.size());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    bool uploaded = m_nextLevel == m_levels.size();
+    if (uploaded)
+    {
+        m_texture->SetChannelSwizzle(m_header.channels);
+        m_file.Close();
+    }
+    m_texture->Unbind();
+
+    return uploaded;
+}
@@ -0,0 +1,91 @@
+#ifndef TEXTURECOOKER_H
+#define TEXTURECOOKER_H
+
+#include "Renderer/Texture.h"
+
+#include "Core/Image.h"
+
+#include "Utils/FileUtils.h"
+
+#include <string>
+#include <vector>
+
+
+#define COOKED_TEXTURE_MAGIC 0x58544d44  // "DMTX"
+#define COOKED_TEXTURE_VERSION 1
+
+
+struct CookedTextureHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint32_t mipCount;
+    uint32_t internalFormat;
+    // Compressed levels have no data format
+    uint32_t dataFormat;
+    uint32_t dataType;
+};
+
+struct CookedTextureLevel
+{
+    uint64_t offset;
+    uint64_t size;
+};
+
+
+struct TextureCookSettings
+{
+    bool generateMips = true;
+    // 8 bits RGB(A) images are block compressed (BC1 when opaque, BC3 otherwise)
+    bool compress = true;
+};
+
+
+// Textures are cooked once into a cache file holding the whole mip chain in its final GPU
+// format, so that loading them is a memory mapping and a copy of each level to the GPU.
+// Cooked files are named after a hash of the source content and of the cook settings,
+// editing a source texture therefore cooks a new file instead of reusing a stale one.
+class TextureCooker
+{
+public:
+    // Returns the path to the cooked texture, cooking it when the cache doesn't hold it yet
+    static std::string Cook(const std::string& sourcePath,
+                            const std::string& cacheDirectory,
+                            const TextureCookSettings& settings=TextureCookSettings());
+    static bool Write(const Image& image,
+                      const std::string& cookedPath,
+                      const TextureCookSettings& settings=TextureCookSettings());
+
+    // Returns nullptr if the file is invalid or uses a format the GPU doesn't support
+    static TexturePtr Load(const std::string& cookedPath);
+
+    // Settings matching the formats supported by the current GL context
+    static TextureCookSettings GetDefaultSettings();
+};
+
+
+// Cooked texture mapped in memory, it can be opened on any thread and uploaded over several frames
+class CookedTexture
+{
+public:
+    // Returns false if the file is invalid or uses a format the GPU doesn't support
+    bool Open(const std::string& cookedPath);
+    // Uploads the next mip levels, consuming the budget (in bytes). Returns true once every level has been uploaded
+    bool Upload(size_t& budget);
+
+    inline TexturePtr GetTexture() const { return m_texture; }
+
+private:
+    MappedFile m_file;
+    CookedTextureHeader m_header;
+    std::vector<CookedTextureLevel> m_levels;
+    uint32_t m_nextLevel = 0;
+
+    TexturePtr m_texture;
+};
+
+
+#endif // TEXTURECOOKER_H
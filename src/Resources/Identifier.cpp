@@ -0,0 +1,76 @@
+#include "Identifier.h"
+
+#include "Utils/TypeUtils.h"
+
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+
+// Strings are never removed from the table, the references given out stay valid.
+// Function statics so that ids can be interned during static initialization.
+static std::unordered_map<uint64_t, std::string>& GetIdentifiers()
+{
+    static std::unordered_map<uint64_t, std::string> identifiers;
+    return identifiers;
+}
+
+static std::shared_mutex& GetIdentifiersMutex()
+{
+    static std::shared_mutex mutex;
+    return mutex;
+}
+
+
+uint64_t ResourceId::Intern(const std::string& identifier)
+{
+    if (identifier.empty())
+    {
+        return 0;
+    }
+
+    auto& identifiers = GetIdentifiers();
+    uint64_t value = HashBytes(identifier.data(), identifier.size());
+    value = value ? value : 1;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(GetIdentifiersMutex());
+        auto it = identifiers.find(value);
+        if (it != identifiers.end() && it->second == identifier)
+        {
+            return value;
+        }
+    }
+
+    // Colliding identifiers are moved to the next free value, in the order they are interned
+    std::unique_lock<std::shared_mutex> lock(GetIdentifiersMutex());
+    while (true)
+    {
+        auto it = identifiers.find(value);
+        if (it == identifiers.end())
+        {
+            identifiers.emplace(value, identifier);
+            return value;
+        }
+        if (it->second == identifier)
+        {
+            return value;
+        }
+
+        value = value + 1 ? value + 1 : 1;
+    }
+}
+
+const std::string& ResourceId::GetString() const
+{
+    static const std::string empty;
+    if (!m_value)
+    {
+        return empty;
+    }
+
+    auto& identifiers = GetIdentifiers();
+    std::shared_lock<std::shared_mutex> lock(GetIdentifiersMutex());
+    auto it = identifiers.find(m_value);
+    return it != identifiers.end() ? it->second : empty;
+}
@@ -0,0 +1,46 @@
+#ifndef IDENTIFIER_H
+#define IDENTIFIER_H
+
+#include <cstdint>
+#include <string>
+
+
+// Resource identifiers are interned into 64 bits ids the first time they are seen,
+// comparing or hashing them is then an integer operation. The identifier strings are
+// kept in a global table so that they can be retrieved from the ids.
+class ResourceId
+{
+public:
+    ResourceId() = default;
+    ResourceId(const std::string& identifier) : m_value(Intern(identifier)) {}
+    ResourceId(const char* identifier) : m_value(Intern(identifier)) {}
+
+    // Empty string for invalid ids
+    const std::string& GetString() const;
+    inline uint64_t GetValue() const { return m_value; }
+    inline bool IsValid() const { return m_value; }
+
+    inline bool operator==(const ResourceId& other) const { return m_value == other.m_value; }
+    inline bool operator!=(const ResourceId& other) const { return m_value != other.m_value; }
+    inline bool operator<(const ResourceId& other) const { return m_value < other.m_value; }
+
+private:
+    // Thread safe
+    static uint64_t Intern(const std::string& identifier);
+
+    uint64_t m_value = 0;
+};
+
+
+namespace std
+{
+    template <>
+    struct hash<ResourceId>
+    {
+        // Ids are already hashes
+        inline size_t operator()(const ResourceId& id) const { return id.GetValue(); }
+    };
+}
+
+
+#endif // IDENTIFIER_H
@@ -5,14 +5,17 @@
 #include "Core/Resolver.h"
 
 #include "Renderer/Mesh.h"
+#include "Renderer/ShaderLibrary.h"
 
 #include "Scene/Entity.h"
+#include "Scene/Components/Lights.h"
 
 #include "Navigation/Components.h"
 #include "Game/Components.h"
 #include "Scripting/Trigger.h"
 
 #include "Resources/Manager.h"
+#include "Resources/Cookers/LevelCooker.h"
 
 #include "Utils/FileUtils.h"
 
@@ -20,27 +23,23 @@
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
-#include <rapidjson/document.h>
+#include <limits>
 
 
-#define ASSERT_LEVEL_DATA(condition, ...)   if (!(condition)) { LOG_ERROR(__VA_ARGS__); return ResourceHandle<Level>(); }
-#define ASSERT_AND_FREE_LEVEL_DATA(condition, path, ...)   if (!(condition)) {                                         \
-                                                                          ResourceManager::FreeResource<Level>(path);  \
-                                                                          LOG_ERROR(__VA_ARGS__);                                 \
-                                                                          return ResourceHandle<Level>(); }
+#define ASSERT_LEVEL_DATA(condition, ...)   if (!(condition)) { LOG_ERROR(__VA_ARGS__); return false; }
 
 
-glm::vec4 GetPixel(const glm::vec4* map, const int& x, const int& y, const int& width, const int& height) {
-    if (x < 0 || x >= width || y < 0 || y >= height)
-        return glm::vec4(0, 0, 0, 1);
-
-    return map[y * width + x];
-}
+// Resources used by every level, whatever its content
+static const char* s_swordModel = "Models/BasicSword.fbx";
+static const char* s_armModel = "Models/arm.fbx";
+static const char* s_floorTexture = "Textures/Cobblestone/Albedo.jpg";
+static const char* s_wallTexture = "Textures/Castle_Wall/Albedo.jpg";
+static const char* s_doorTexture = "Textures/Metal_Door/Albedo.jpg";
 
 
 Entity LevelLoader::BuildPlayer()
 {
-    ScenePtr scene = m_levelHandle.Get()->scene;
+    const ScenePtr& scene = m_scene;
 
     // Main Components
     Entity player = scene->CreateEntity("Player");
@@ -59,6 +58,10 @@ Entity LevelLoader::BuildPlayer()
     Entity camera = player.AddChild("Camera");
     auto& cam = camera.EmplaceComponent<Components::Camera>();
     scene->SetMainCamera(camera);
+
+    // Torch carried by the player, lighting its surroundings
+    camera.EmplaceComponent<Components::PointLight>(glm::vec3(1.0f), 10.0f, 2.0f);
+    camera.EmplaceComponent<Components::Scriptable>(Components::CreateTorchLogic(camera));
     
     // Weapon
     Entity weapon = player.AddChild("Weapon");
@@ -67,13 +70,13 @@ Entity LevelLoader::BuildPlayer()
         glm::eulerAngleXYZ(0.0f, -(float)M_PI * 0.33f, (float)M_PI * 0.1f));
     weapon.EmplaceComponent<Components::WeaponData>(1.0, 1.0, "");
 
-    auto basicSword = ResourceManager::LoadModel("Models/BasicSword.fbx");
+    auto basicSword = FindModel(s_swordModel);
     scene->CopyEntity(basicSword.Get()->GetRootEntity(), "model", weapon);
 
-    auto arm = ResourceManager::LoadModel("Models/arm.fbx");
+    auto arm = FindModel(s_armModel);
     Entity armEntity = scene->CopyEntity(arm.Get()->GetRootEntity(), "Arm", player);
-    armEntity.GetComponent<Components::Transform>().transform =
-        glm::translate(glm::mat4(1.0f), glm::vec3(0.0, 0.0, 0.05));
+    armEntity.GetComponent<Components::Transform>().Teleport(
+        glm::translate(glm::mat4(1.0f), glm::vec3(0.0, 0.0, 0.05)));
 
     return player;
 }
@@ -86,7 +89,7 @@ Entity LevelLoader::BuildExit()
         m_exitPos = glm::vec2(1.0f);
     }
 
-    ScenePtr scene = m_levelHandle.Get()->scene;
+    const ScenePtr& scene = m_scene;
 
     // Main Components
     Entity exit = scene->CreateEntity("Exit");
@@ -105,7 +108,7 @@ Entity LevelLoader::BuildMonster(const std::string& name,
                                  const float& attackSpeed,
                                  const float& speed)
 {
-    ScenePtr scene = m_levelHandle.Get()->scene;
+    const ScenePtr& scene = m_scene;
 
     // Character controller
     Entity monster = scene->CreateEntity(name);
@@ -119,7 +122,7 @@ Entity LevelLoader::BuildMonster(const std::string& name,
     auto& logic = monster.EmplaceComponent<Components::Scriptable>(Components::CreateMonsterLogic(monster));
     monster.EmplaceComponent<Components::CharacterData>(health);
 
-    ResourceHandle<Prefab> model = ResourceManager::LoadModel(modelIdentifier);
+    ResourceHandle<Prefab> model = FindModel(modelIdentifier);
     if (model)
     {
         Entity modelEntity = scene->CopyEntity(model.Get()->GetRootEntity(), "model", monster);
@@ -138,7 +141,7 @@ Entity LevelLoader::BuildHeal(const std::string& name,
                     const std::string& modelIdentifier,
                     const float& healing)
 {
-    ScenePtr scene = m_levelHandle.Get()->scene;
+    const ScenePtr& scene = m_scene;
 
     // Create entity & components
     Entity entity = scene->CreateEntity(name);
@@ -149,7 +152,7 @@ Entity LevelLoader::BuildHeal(const std::string& name,
     logic.GetDataBlock<Components::HealData>().healing = healing;
 
     // Load model
-    ResourceHandle<Prefab> model = ResourceManager::LoadModel(modelIdentifier);
+    ResourceHandle<Prefab> model = FindModel(modelIdentifier);
     if (model)
     {
         Entity modelEntity = scene->CopyEntity(model.Get()->GetRootEntity(), "model", entity);
@@ -169,7 +172,7 @@ Entity LevelLoader::BuildWeapon(const std::string& name,
                     const float& damage,
                     const float& attackSpeed)
 {
-    ScenePtr scene = m_levelHandle.Get()->scene;
+    const ScenePtr& scene = m_scene;
 
     // Create entity & components
     Entity entity = scene->CreateEntity(name);
@@ -179,7 +182,7 @@ Entity LevelLoader::BuildWeapon(const std::string& name,
     entity.EmplaceComponent<Components::Scriptable>(Components::CreateWeaponLogic(entity));
 
     // Load model
-    ResourceHandle<Prefab> model = ResourceManager::LoadModel(modelIdentifier);
+    ResourceHandle<Prefab> model = FindModel(modelIdentifier);
     if (model)
     {
         Entity modelEntity = scene->CopyEntity(model.Get()->GetRootEntity(), "model", entity);
@@ -199,28 +202,28 @@ void LevelLoader::BuildMaterials()
 {
     Resolver& resolver = Resolver::Get();
 
-    auto defaultShader = Shader::Open(resolver.Resolve("Shaders/default.vert"),
+    auto defaultShader = ShaderLibrary::Open(resolver.Resolve("Shaders/default.vert"),
                                       resolver.Resolve("Shaders/pbrMaterial.frag"));
 
     // Floor
     if(!(m_floorMat = ResourceManager::GetResource<Material>("floorMaterial")))
     {
         m_floorMat = ResourceManager::CreateResource<Material>("floorMaterial", Material::Create(defaultShader), false);
-        m_floorMat.Get()->SetInputTexture("baseColor", ResourceManager::LoadTexture("Textures/Cobblestone/Albedo.jpg").Get());
+        m_floorMat.Get()->SetInputTexture("baseColor", ResourceManager::LoadTexture(s_floorTexture).Get());
     }
 
     // Wall
     if(!(m_wallMat = ResourceManager::GetResource<Material>("wallMaterial")))
     {
         m_wallMat = ResourceManager::CreateResource<Material>("wallMaterial", Material::Create(defaultShader), false);
-        m_wallMat.Get()->SetInputTexture("baseColor", ResourceManager::LoadTexture("Textures/Castle_Wall/Albedo.jpg").Get());
+        m_wallMat.Get()->SetInputTexture("baseColor", ResourceManager::LoadTexture(s_wallTexture).Get());
     }
 
     // Door
     if(!(m_doorMat = ResourceManager::GetResource<Material>("doorMaterial")))
     {
         m_doorMat = ResourceManager::CreateResource<Material>("doorMaterial", Material::Create(defaultShader), false);
-        m_doorMat.Get()->SetInputTexture("baseColor", ResourceManager::LoadTexture("Textures/Metal_Door/Albedo.jpg").Get());
+        m_doorMat.Get()->SetInputTexture("baseColor", ResourceManager::LoadTexture(s_doorTexture).Get());
     }
 
     // Water
@@ -228,7 +231,7 @@ void LevelLoader::BuildMaterials()
     {
         m_waterMat = ResourceManager::CreateResource<Material>(
             "waterMaterial",
-            Material::Create(Shader::Open(resolver.Resolve("Shaders/default.vert"),
+            Material::Create(ShaderLibrary::Open(resolver.Resolve("Shaders/default.vert"),
                                           resolver.Resolve("Shaders/water.frag"))), false);
         m_waterMat.Get()->SetInputValue("surfaceColor", glm::vec3(0.0, 0.05, 0.1));
         m_waterMat.Get()->SetInputValue("deepColor", glm::vec3(0.0, 0.12, 0.25));
@@ -236,183 +239,118 @@ void LevelLoader::BuildMaterials()
 }
 
 
-ResourceHandle<Prefab> LevelLoader::ProcessAndBuildLevelMap(const ImagePtr& map, const std::string& mapPath)
+bool LevelLoader::ReadCells()
 {
-    Resolver& resolver = Resolver::Get();
+    const CellGrid& grid = *m_grid;
+    const int width = grid.GetWidth();
+    const int height = grid.GetHeight();
 
-    std::string identifier = resolver.AsIdentifier(mapPath);
-    ResourceHandle<Prefab> prefab = ResourceManager::GetResource<Prefab>(identifier);
-    if (prefab)
+    // Gathering the doors, the entrance and the exit, whether the level prefab already exists or not
+    const uint8_t* cells = grid.GetCells();
+    for (int y=0 ; y < height ; y++)
     {
-        const glm::vec4* pixels = map->GetPixels();
-        const uint32_t width = map->GetWidth();
-        const uint32_t height = map->GetHeight();
-
-        // The level prefab already exists, just gather the data for the rest of the level building
-        for (int y=0 ; y < height ; y++)
+        for (int x=0 ; x < width ; x++)
         {
-            for (size_t x=0 ; x < width ; x++)
+            CellType cell = (CellType)cells[(size_t)y * width + x];
+            if (cell == CellType::Wall || cell == CellType::Floor)
+                continue;
+
+            if (cell == CellType::Door)
             {
-                glm::vec4 pixel = GetPixel(pixels, x, y, width, height);
-                if (pixel == LevelCell::Door)
+                bool verticalDoor = grid.GetWallNeighbours(x, y) & WallTop;
+                m_doors.emplace_back(glm::vec2(x, -y), verticalDoor);
+            }
+
+            else if (cell == CellType::Entrance)
+            {
+                if (m_entrancePos != glm::vec2(-1.0f))
                 {
-                    bool verticalDoor = (GetPixel(pixels, x, y + 1, width, height) == LevelCell::Wall);
-                    m_doors.emplace_back(glm::vec2(x, -y), verticalDoor);
+                    LOG_ERROR("Multiple entrances have been specified.");
+                    return false;
                 }
 
-                else if (pixel == LevelCell::Entrance)
+                bool xBorder = x == 0 || x == width - 1;
+                bool yBorder = y == 0 || y == height - 1;
+                if (!(xBorder ^ yBorder))
                 {
-                    if (m_entrancePos != glm::vec2(-1.0f))
-                    {
-                        LOG_ERROR("Multiple entrances have been specified.");
-                        return ResourceHandle<Prefab>();
-                    }
-
-                    bool xBorder = x == 0 || x == width - 1;
-                    bool yBorder = y == 0 || y == height - 1;
-                    if (!(xBorder ^ yBorder))
-                    {
-                        LOG_ERROR("The entrance has to be on a border of the level and not in a corner.");
-                        return ResourceHandle<Prefab>();
-                    }
-                    
-                    m_entrancePos = glm::vec2(x, -y);
-
-                    if (x == 0)
-                    {
-                        m_entranceOrientation = -M_PI_2;
-                    }
-                    else if (x == width - 1)
-                    {
-                        m_entranceOrientation = M_PI_2;
-                    }
-                    else if (y == height - 1)
-                    {
-                        m_entranceOrientation = M_PI;
-                    }
+                    LOG_ERROR("The entrance has to be on a border of the level and not in a corner.");
+                    return false;
                 }
 
-                else if (pixel == LevelCell::Exit)
+                m_entrancePos = glm::vec2(x, -y);
+
+                if (x == 0)
                 {
-                    if (m_exitPos != glm::vec2(-1.0f))
-                    {
-                        LOG_ERROR("Multiple exits have been specified.");
-                        return ResourceHandle<Prefab>();
-                    }
-
-                    bool xBorder = x == 0 || x == width - 1;
-                    bool yBorder = y == 0 || y == height - 1;
-                    if (!(xBorder ^ yBorder))
-                    {
-                        LOG_ERROR("The exit has to be on a border of the level and not in a corner.");
-                        return ResourceHandle<Prefab>();
-                    }
-                    else
-                        m_exitPos = glm::vec2(x, -y);
+                    m_entranceOrientation = -M_PI_2;
+                }
+                else if (x == width - 1)
+                {
+                    m_entranceOrientation = M_PI_2;
+                }
+                else if (y == height - 1)
+                {
+                    m_entranceOrientation = M_PI;
                 }
             }
-        }
 
-        return prefab;
+            else if (cell == CellType::Exit)
+            {
+                if (m_exitPos != glm::vec2(-1.0f))
+                {
+                    LOG_ERROR("Multiple exits have been specified.");
+                    return false;
+                }
+
+                bool xBorder = x == 0 || x == width - 1;
+                bool yBorder = y == 0 || y == height - 1;
+                if (!(xBorder ^ yBorder))
+                {
+                    LOG_ERROR("The exit has to be on a border of the level and not in a corner.");
+                    return false;
+                }
+                else
+                    m_exitPos = glm::vec2(x, -y);
+            }
+        }
     }
 
-    prefab = ResourceManager::CreateResource<Prefab>(identifier);
-    ScenePtr prefabScene = prefab.Get()->GetInternalScene().lock();
+    ASSERT_LEVEL_DATA(m_entrancePos != glm::vec2(-1.0f), "Invalid level, you need an entrance to the dungeon !");
+    ASSERT_LEVEL_DATA(m_exitPos != glm::vec2(-1.0f), "Invalid level, you need an exit to the dungeon !");
+
+    return true;
+}
+
+PrefabPtr LevelLoader::BuildLevelMap()
+{
+    const CellGrid& grid = *m_grid;
+    const int width = grid.GetWidth();
+    const int height = grid.GetHeight();
+    const uint8_t* cells = grid.GetCells();
+
+    PrefabPtr prefab = Prefab::Create();
+    ScenePtr prefabScene = prefab->GetInternalScene().lock();
     
     // A single mesh is used since all the level is only composed of quads
     // Keeping each one separated to allow us to use separated materials and culling 
-    std::string quadIdentifier = identifier + "QuadMesh";
-    ResourceHandle<Mesh> mesh = ResourceManager::GetResource<Mesh>(quadIdentifier);
-    if (!mesh)
-    {
-        std::vector<Vertex> vertices = {{{ 0.5f, 0.0f,  0.5f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
-                                        {{ 0.5f, 0.0f, -0.5f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}},
-                                        {{-0.5f, 0.0f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}},
-                                        {{-0.5f, 0.0f,  0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}}};
-        std::vector<uint32_t> indices = {0, 1, 3, 1, 2, 3};
-        mesh = ResourceManager::CreateResource<Mesh>(quadIdentifier,
-                                                    Mesh::Create(vertices, indices),
-                                                    true);
-    }
-
-    const glm::vec4* pixels = map->GetPixels();
-    const uint32_t width = map->GetWidth();
-    const uint32_t height = map->GetHeight();
+    const ResourceHandle<Mesh>& mesh = m_quadMesh;
 
-    // Processing the image to generate the level
+    // Processing the map to generate the level
     for (int y=0 ; y < height ; y++)
     {
-        for (size_t x=0 ; x < width ; x++)
+        for (int x=0 ; x < width ; x++)
         {
-            glm::vec4 pixel = GetPixel(pixels, x, y, width, height);
-            if (pixel == LevelCell::Wall)
+            CellType cellType = (CellType)cells[(size_t)y * width + x];
+            if (cellType == CellType::Wall)
                 continue;
 
-            // Skip the most common case as quickly as possible to avoid having to process too many if statements
-            if (pixel != LevelCell::Floor) {
-                if (pixel == LevelCell::Door)
-                {
-                    bool verticalDoor = (GetPixel(pixels, x, y + 1, width, height) == LevelCell::Wall);
-                    m_doors.emplace_back(glm::vec2(x, -y), verticalDoor);
-                }
-
-                else if (pixel == LevelCell::Entrance)
-                {
-                    if (m_entrancePos != glm::vec2(-1.0f))
-                    {
-                        LOG_ERROR("Multiple entrances have been specified.");
-                        return ResourceHandle<Prefab>();
-                    }
-
-                    bool xBorder = x == 0 || x == width - 1;
-                    bool yBorder = y == 0 || y == height - 1;
-                    if (!(xBorder ^ yBorder))
-                    {
-                        LOG_ERROR("The entrance has to be on a border of the level and not in a corner.");
-                        return ResourceHandle<Prefab>();
-                    }
-
-                    m_entrancePos = glm::vec2(x, -y);
-
-                    if (x == 0)
-                    {
-                        m_entranceOrientation = -M_PI_2;
-                    }
-                    else if (x == width - 1)
-                    {
-                        m_entranceOrientation = M_PI_2;
-                    }
-                    else if (y == height - 1)
-                    {
-                        m_entranceOrientation = M_PI;
-                    }
-                }
-
-                else if (pixel == LevelCell::Exit)
-                {
-                    if (m_exitPos != glm::vec2(-1.0f))
-                    {
-                        LOG_ERROR("Multiple exits have been specified.");
-                        return ResourceHandle<Prefab>();
-                    }
-
-                    bool xBorder = x == 0 || x == width - 1;
-                    bool yBorder = y == 0 || y == height - 1;
-                    if (!(xBorder ^ yBorder))
-                    {
-                        LOG_ERROR("The exit has to be on a border of the level and not in a corner.");
-                        return ResourceHandle<Prefab>();
-                    }
-                    else
-                        m_exitPos = glm::vec2(x, -y);
-                }
-            }
+            // Wall entities are added on the sides of the cell facing walls
+            uint8_t walls = grid.GetWallNeighbours(x, y);
 
             // Floor entity
             Entity cell = prefabScene->CreateEntity(std::string("Cell") + std::to_string(x) + std::to_string(y));
             cell.EmplaceComponent<Components::Transform>(glm::translate(glm::mat4(1.0f), glm::vec3(x, 0, -y)));
             cell.EmplaceComponent<Components::Mesh>(mesh);
-            if (pixel == LevelCell::Water)
+            if (cellType == CellType::Water)
                 cell.EmplaceComponent<Components::RenderMesh>(m_waterMat);
             else
                 cell.EmplaceComponent<Components::RenderMesh>(m_floorMat);
@@ -431,7 +369,7 @@ ResourceHandle<Prefab> LevelLoader::ProcessAndBuildLevelMap(const ImagePtr& map,
             ceiling.EmplaceComponent<Components::RenderMesh>(m_floorMat);
 
             // Wall entity(ies)
-            if (GetPixel(pixels, x-1, y, width, height) == LevelCell::Wall)
+            if (walls & WallLeft)
             {
                 Entity wall = prefabScene->CreateEntity("leftWall", cell);
                 wall.EmplaceComponent<Components::Transform>(
@@ -449,7 +387,7 @@ ResourceHandle<Prefab> LevelLoader::ProcessAndBuildLevelMap(const ImagePtr& map,
                 wall.EmplaceComponent<Components::RenderMesh>(m_wallMat);
             }
             
-            if (GetPixel(pixels, x+1, y, width, height) == LevelCell::Wall)
+            if (walls & WallRight)
             {
                 Entity wall = prefabScene->CreateEntity("rightWall", cell);
                 wall.EmplaceComponent<Components::Transform>(
@@ -467,7 +405,7 @@ ResourceHandle<Prefab> LevelLoader::ProcessAndBuildLevelMap(const ImagePtr& map,
                 wall.EmplaceComponent<Components::RenderMesh>(m_wallMat);
             }
 
-            if (GetPixel(pixels, x, y+1, width, height) == LevelCell::Wall)
+            if (walls & WallTop)
             {
                 Entity wall = prefabScene->CreateEntity("topWall", cell);
                 wall.EmplaceComponent<Components::Transform>(
@@ -482,7 +420,7 @@ ResourceHandle<Prefab> LevelLoader::ProcessAndBuildLevelMap(const ImagePtr& map,
                 wall.EmplaceComponent<Components::RenderMesh>(m_wallMat);
             }
 
-            if (GetPixel(pixels, x, y-1, width, height) == LevelCell::Wall)
+            if (walls & WallBottom)
             {
                 Entity wall = prefabScene->CreateEntity("bottomWall", cell);
                 wall.EmplaceComponent<Components::Transform>(
@@ -510,7 +448,7 @@ Entity LevelLoader::BuildDoor(const std::string& name,
                               const glm::vec2& origin,
                               const bool& verticalDoor) 
 {
-    ScenePtr scene = m_levelHandle.Get()->scene;
+    const ScenePtr& scene = m_scene;
 
     // Create entity & components
     Entity door = scene->CreateEntity(name);
@@ -525,88 +463,110 @@ Entity LevelLoader::BuildDoor(const std::string& name,
     door.EmplaceComponent<Components::Scriptable>(Components::CreateDoorLogic(door));
 
     // A door is a simple quad for now, should be replaced by a proper model
-    std::string identifier = "DoorMesh";
-    ResourceHandle<Mesh> mesh = ResourceManager::GetResource<Mesh>(identifier);
-    if (!mesh)
-    {
-        std::vector<Vertex> vertices = {{{ 0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
-                                        {{ 0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
-                                        {{-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
-                                        {{-0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}}};
-        std::vector<uint32_t> indices = {0, 1, 3, 1, 2, 3};
-        mesh = ResourceManager::CreateResource<Mesh>(identifier,
-                                                    Mesh::Create(vertices, indices),
-                                                    true);
-    }
-
     Entity model = door.AddChild("model");
     model.EmplaceComponent<Components::Transform>();
-    model.EmplaceComponent<Components::Mesh>(mesh);
+    model.EmplaceComponent<Components::Mesh>(m_doorMesh);
     model.EmplaceComponent<Components::RenderMesh>(m_doorMat, true);
 
     return door;
 }
 
-ResourceHandle<Level> LevelLoader::Load(const std::string& path)
+ResourceHandle<Prefab> LevelLoader::FindModel(const std::string& path) const
+{
+    auto it = m_modelHandles.find(path);
+    return it != m_modelHandles.end() ? it->second : ResourceHandle<Prefab>();
+}
+
+bool LevelLoader::Read(const std::string& path, const uint32_t& floor)
 {
     Resolver& resolver = Resolver::Get();
     std::string resolvedPath = resolver.Resolve(path);
-
-    std::string content;
-    if (!ReadFile(resolvedPath, content))
+    m_path = path;
+    m_floor = floor;
+
+    // The description is validated while being parsed, or was validated when it has been cooked
+    ASSERT_LEVEL_DATA(LevelCooker::Read(resolvedPath, resolver.GetCachePath(), m_description), "Could not load level %s", path.c_str());
+    ASSERT_LEVEL_DATA(floor < m_description.floors.size(), "Level %s has no floor %u", path.c_str(), floor);
+    LOG_DEBUG("LevelLoader : Loading level %s floor %u (%s)", m_description.GetString(m_description.name).c_str(), floor, path.c_str());
+
+    const CookedFloor& cookedFloor = m_description.floors[floor];
+    m_models = {s_swordModel, s_armModel};
+    m_textures = {s_floorTexture, s_wallTexture, s_doorTexture};
+    for (uint32_t i = 0 ; i < cookedFloor.monsterCount ; ++i)
+    {
+        m_models.push_back(m_description.GetString(m_description.monsters[cookedFloor.firstMonster + i].model));
+    }
+    for (uint32_t i = 0 ; i < cookedFloor.rewardCount ; ++i)
     {
-        LOG_ERROR("Could not load level %s", path.c_str());
-        return m_levelHandle;
+        m_models.push_back(m_description.GetString(m_description.rewards[cookedFloor.firstReward + i].model));
     }
 
-    rapidjson::Document document;
-    document.Parse(content.c_str());
+    // Reading the map
+    m_mapPath = std::filesystem::path(resolvedPath).replace_filename(m_description.GetString(cookedFloor.map)).string();
+    m_map = Image::Read(m_mapPath);
+    ASSERT_LEVEL_DATA(m_map, "Could not open the level map");
+    m_grid = CellGrid::Create(*m_map);
 
-    ASSERT_LEVEL_DATA(document.HasMember("name"), "Invalid level name.");
-    ASSERT_LEVEL_DATA(document["name"].IsString(), "Invalid level name.");
-    LOG_DEBUG("LevelLoader : Loading level %s (%s)", document["name"].GetString(), path);
-    
-    ASSERT_LEVEL_DATA(document.HasMember("floors"), "Invalid floors data.");
-    ASSERT_LEVEL_DATA(document["floors"].IsArray(), "Invalid floors data.");
-    ASSERT_LEVEL_DATA(document["floors"].Capacity() > 0, "Invalid floors data.");
-    const auto& firstFloor = document["floors"][0];
-
-    ASSERT_LEVEL_DATA(firstFloor.HasMember("name"), "Invalid floor data.");
-    ASSERT_LEVEL_DATA(firstFloor["name"].IsString(), "Invalid floor data.");
-    ASSERT_LEVEL_DATA(firstFloor.HasMember("map"), "Invalid floor data.");
-    ASSERT_LEVEL_DATA(firstFloor["map"].IsString(), "Invalid floor data.");
-
-    // Initialize the resource
-    m_levelHandle = ResourceManager::CreateResource<Level>(path, false);
-    auto level = m_levelHandle.Get();
-    level->scene = Scene::Create();
-    level->floorName = firstFloor["name"].GetString();
+    return ReadCells();
+}
 
-    // Reading the map
-    std::string mapPath = std::filesystem::path(resolvedPath).replace_filename(firstFloor["map"].GetString());
-    level->map = Image::Read(mapPath);
-    ASSERT_LEVEL_DATA(level->map, "Could not open the level map");
+bool LevelLoader::IsBuilt() const
+{
+    LevelPtr level = ResourceManager::GetResource<Level>(m_path).Get();
+    return level && level->floors[m_floor].IsBuilt();
+}
 
-    // Build level map
-    BuildMaterials();
-    auto floorPrefab = ProcessAndBuildLevelMap(level->map, mapPath);
-    if (!floorPrefab)
+void LevelLoader::Prepare(size_t& budget)
+{
+    for (const auto& model : m_models)
     {
-        LOG_ERROR("Invalid level !");
-        return ResourceHandle<Level>();
+        m_modelHandles[model] = ResourceManager::LoadModel(model);
     }
-    if (m_entrancePos == glm::vec2(-1.0f))
+    BuildMaterials();
+
+    // Quads are used for the map and the doors
+    auto createQuad = [&budget](const std::string& identifier, const std::vector<Vertex>& vertices)
     {
-        LOG_ERROR("Invalid level, you need an entrance to the dungeon !");
-        return ResourceHandle<Level>();
-    }
-    if (m_exitPos == glm::vec2(-1.0f))
+        ResourceHandle<Mesh> mesh = ResourceManager::GetResource<Mesh>(identifier);
+        if (!mesh)
+        {
+            std::vector<uint32_t> indices = {0, 1, 3, 1, 2, 3};
+            mesh = ResourceManager::CreateResource<Mesh>(identifier, Mesh::Create(vertices, indices), true);
+            budget -= std::min(budget, vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t));
+        }
+        return mesh;
+    };
+
+    m_mapIdentifier = Resolver::Get().AsIdentifier(m_mapPath);
+    m_mapPrefab = ResourceManager::GetResource<Prefab>(m_mapIdentifier).Get();
+    if (!m_mapPrefab)
     {
-        LOG_ERROR("Invalid level, you need an exit to the dungeon !");
-        return ResourceHandle<Level>();
+        m_quadMesh = createQuad(m_mapIdentifier + "QuadMesh",
+                                {{{ 0.5f, 0.0f,  0.5f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
+                                 {{ 0.5f, 0.0f, -0.5f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}},
+                                 {{-0.5f, 0.0f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}},
+                                 {{-0.5f, 0.0f,  0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}}});
     }
 
-    level->scene->CopyEntity(floorPrefab.Get()->GetRootEntity(), "Floor");
+    m_doorMesh = createQuad("DoorMesh",
+                            {{{ 0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
+                             {{ 0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
+                             {{-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
+                             {{-0.5f,  0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}}});
+}
+
+void LevelLoader::Build()
+{
+    const CookedFloor& cookedFloor = m_description.floors[m_floor];
+    m_scene = Scene::Create();
+
+    // Build level map
+    m_isNewMap = !m_mapPrefab;
+    if (m_isNewMap)
+    {
+        m_mapPrefab = BuildLevelMap();
+    }
+    m_scene->CopyEntity(m_mapPrefab->GetRootEntity(), "Floor");
 
     // Build the player
     m_player = BuildPlayer();
@@ -620,92 +580,89 @@ ResourceHandle<Level> LevelLoader::Load(const std::string& path)
     }
 
     // Build the monsters
-    if (firstFloor.HasMember("monsters") && firstFloor["monsters"].IsArray())
+    for (uint32_t i = 0 ; i < cookedFloor.monsterCount ; ++i)
     {
-        for (const auto& monster : firstFloor["monsters"].GetArray())
-        {
-            ASSERT_AND_FREE_LEVEL_DATA(monster.HasMember("name"), path, "Invalid monster name.");
-            ASSERT_AND_FREE_LEVEL_DATA(monster["name"].IsString(), path, "Invalid monster name.");
-            
-            ASSERT_AND_FREE_LEVEL_DATA(monster.HasMember("origin"), path, "Invalid monster origin.");
-            ASSERT_AND_FREE_LEVEL_DATA(monster["origin"].IsArray(), path, "Invalid monster origin.");
-            ASSERT_AND_FREE_LEVEL_DATA(monster["origin"].Capacity() == 2, path, "Invalid monster origin.");
-            
-            ASSERT_AND_FREE_LEVEL_DATA(monster.HasMember("model"), path, "Invalid monster model.");
-            ASSERT_AND_FREE_LEVEL_DATA(monster["model"].IsString(), path, "Invalid monster model.");
-            
-            ASSERT_AND_FREE_LEVEL_DATA(monster.HasMember("health"), path, "Invalid monster health.");
-            ASSERT_AND_FREE_LEVEL_DATA(monster["health"].IsInt(), path, "Invalid monster health.");
-
-            ASSERT_AND_FREE_LEVEL_DATA(monster.HasMember("strength"), path, "Invalid monster strength.");
-            ASSERT_AND_FREE_LEVEL_DATA(monster["strength"].IsFloat(), path, "Invalid monster strength.");
-
-            ASSERT_AND_FREE_LEVEL_DATA(monster.HasMember("attackSpeed"), path, "Invalid monster attack speed.");
-            ASSERT_AND_FREE_LEVEL_DATA(monster["attackSpeed"].IsFloat(), path, "Invalid monster attack speed.");
-
-            ASSERT_AND_FREE_LEVEL_DATA(monster.HasMember("speed"), path, "Invalid monster speed.");
-            ASSERT_AND_FREE_LEVEL_DATA(monster["speed"].IsFloat(), path, "Invalid monster speed.");
-
-            auto origin = monster["origin"].GetArray();
-            BuildMonster(monster["name"].GetString(),
-                        glm::vec2(origin[0].GetFloat(), origin[1].GetFloat()),
-                        monster["model"].GetString(),
-                        monster["health"].GetInt(),
-                        monster["strength"].GetFloat(),
-                        monster["attackSpeed"].GetFloat(),
-                        monster["speed"].GetFloat());
-        }
+        const CookedMonster& monster = m_description.monsters[cookedFloor.firstMonster + i];
+        BuildMonster(m_description.GetString(monster.name),
+                     glm::vec2(monster.origin[0], monster.origin[1]),
+                     m_description.GetString(monster.model),
+                     monster.health,
+                     monster.strength,
+                     monster.attackSpeed,
+                     monster.speed);
     }
 
-    if(firstFloor.HasMember("rewards") && firstFloor["rewards"].IsArray())
+    for (uint32_t i = 0 ; i < cookedFloor.rewardCount ; ++i)
     {
-        for (const auto& reward : firstFloor["rewards"].GetArray())
+        const CookedReward& reward = m_description.rewards[cookedFloor.firstReward + i];
+        if (reward.type == CookedReward_Weapon)
         {
-            ASSERT_AND_FREE_LEVEL_DATA(reward.HasMember("name"), path, "Invalid reward name.");
-            ASSERT_AND_FREE_LEVEL_DATA(reward["name"].IsString(), path, "Invalid reward name.");
-            
-            ASSERT_AND_FREE_LEVEL_DATA(reward.HasMember("origin"), path, "Invalid reward origin.");
-            ASSERT_AND_FREE_LEVEL_DATA(reward["origin"].IsArray(), path, "Invalid reward origin.");
-            ASSERT_AND_FREE_LEVEL_DATA(reward["origin"].Capacity() == 2, path, "Invalid reward origin.");
-            
-            ASSERT_AND_FREE_LEVEL_DATA(reward.HasMember("model"), path, "Invalid reward model.");
-            ASSERT_AND_FREE_LEVEL_DATA(reward["model"].IsString(), path, "Invalid reward model.");
-            
-            ASSERT_AND_FREE_LEVEL_DATA(reward.HasMember("type"), path, "Invalid reward type.");
-            ASSERT_AND_FREE_LEVEL_DATA(reward["type"].IsString(), path, "Invalid reward type.");
-
-            std::string type = reward["type"].GetString();
-            if (type == "weapon")
-            {
-                ASSERT_AND_FREE_LEVEL_DATA(reward.HasMember("damage"), path, "Invalid weapon damage.");
-                ASSERT_AND_FREE_LEVEL_DATA(reward["damage"].IsFloat(), path, "Invalid weapon damage.");
-
-                ASSERT_AND_FREE_LEVEL_DATA(reward.HasMember("attackSpeed"), path, "Invalid weapon attack speed.");
-                ASSERT_AND_FREE_LEVEL_DATA(reward["attackSpeed"].IsFloat(), path, "Invalid weapon attack speed.");
-
-                auto origin = reward["origin"].GetArray();
-                BuildWeapon(reward["name"].GetString(),
-                            glm::vec2(origin[0].GetFloat(), origin[1].GetFloat()),
-                            reward["model"].GetString(),
-                            reward["damage"].GetFloat(),
-                            reward["attackSpeed"].GetFloat());
-            }
+            BuildWeapon(m_description.GetString(reward.name),
+                        glm::vec2(reward.origin[0], reward.origin[1]),
+                        m_description.GetString(reward.model),
+                        reward.damage,
+                        reward.attackSpeed);
+        }
 
-            else if (type == "heal")
-            {
-                ASSERT_AND_FREE_LEVEL_DATA(reward.HasMember("healing"), path, "Invalid heal healing.");
-                ASSERT_AND_FREE_LEVEL_DATA(reward["healing"].IsFloat(), path, "Invalid heal healing.");
-
-                auto origin = reward["origin"].GetArray();
-                BuildHeal(reward["name"].GetString(),
-                        glm::vec2(origin[0].GetFloat(), origin[1].GetFloat()),
-                        reward["model"].GetString(),
-                        reward["healing"].GetFloat());
-            }
+        else if (reward.type == CookedReward_Heal)
+        {
+            BuildHeal(m_description.GetString(reward.name),
+                      glm::vec2(reward.origin[0], reward.origin[1]),
+                      m_description.GetString(reward.model),
+                      reward.healing);
         }
     }
 
     BuildExit();
+}
+
+ResourceHandle<Level> LevelLoader::Publish()
+{
+    if (m_isNewMap)
+    {
+        ResourceManager::CreateResource<Prefab>(m_mapIdentifier, m_mapPrefab);
+    }
+
+    // Floors are built into the existing level when another one has already been loaded
+    LevelPtr level = ResourceManager::GetResource<Level>(m_path).Get();
+    if (!level)
+    {
+        level = Level::Create();
+        level->name = m_description.GetString(m_description.name);
+        for (const auto& cookedFloor : m_description.floors)
+        {
+            level->floors.push_back({m_description.GetString(cookedFloor.name)});
+        }
+    }
+    if (level->floors[m_floor].IsBuilt())
+    {
+        return ResourceManager::GetResource<Level>(m_path);
+    }
+
+    // Publishing the level once the floor is complete, this also completes a pending level
+    // and accounts for the new map in its footprint
+    level->floors[m_floor].map = m_map;
+    level->floors[m_floor].grid = m_grid;
+    level->floors[m_floor].scene = m_scene;
+    m_levelHandle = ResourceManager::CreateResource<Level>(m_path, level, false);
 
     return m_levelHandle;
 }
+
+ResourceHandle<Level> LevelLoader::Load(const std::string& path, const uint32_t& floor)
+{
+    if (!Read(path, floor))
+    {
+        return ResourceHandle<Level>();
+    }
+    if (IsBuilt())
+    {
+        return ResourceManager::GetResource<Level>(path);
+    }
+
+    size_t budget = std::numeric_limits<size_t>::max();
+    Prepare(budget);
+    Build();
+
+    return Publish();
+}
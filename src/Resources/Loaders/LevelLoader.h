@@ -6,14 +6,18 @@
 #include "Scene/Entity.h"
 
 #include "Renderer/Material.h"
+#include "Renderer/Mesh.h"
 
 #include "Resources/Resource.h"
 #include "Resources/Prefab.h"
+#include "Resources/Cookers/CookedLevel.h"
 
 #include "Core/Foundations.h"
 
 #include <glm/glm.hpp>
 
+#include <unordered_map>
+
 
 namespace LevelCell
 {
@@ -31,7 +35,23 @@ public:
     LevelLoader() = default;
     ~LevelLoader() = default;
 
-    ResourceHandle<Level> Load(const std::string& path);
+    // Builds a floor of the level, the level itself is created along with the first floor built
+    ResourceHandle<Level> Load(const std::string& path, const uint32_t& floor=0);
+
+    // Load() in steps, for the floors streamed in. Read() and Build() touch neither GL nor the ResourceManager,
+    // they can run on any thread. The other steps run on the main thread, once the models and textures listed
+    // are loaded.
+    bool Read(const std::string& path, const uint32_t& floor);
+    inline const std::vector<std::string>& GetModels() const { return m_models; }
+    inline const std::vector<std::string>& GetTextures() const { return m_textures; }
+    // Whether the floor read has already been published
+    bool IsBuilt() const;
+    // Creates the materials and meshes of the floor, consuming the upload budget
+    void Prepare(size_t& budget);
+    // Builds the scene of the floor, along with the prefab of its map when it is not cached yet
+    void Build();
+    // Publishes the map prefab and the floor, this also completes a pending level
+    ResourceHandle<Level> Publish();
 
     inline ResourceHandle<Level> GetLevel() const { return m_levelHandle; }
 
@@ -55,13 +75,34 @@ private:
                        const float& damage,
                        const float& attackSpeed);
 
-    ResourceHandle<Prefab> ProcessAndBuildLevelMap(const ImagePtr& map, const std::string& mapPath);
+    // Gathers the doors, the entrance and the exit of the map
+    bool ReadCells();
+    PrefabPtr BuildLevelMap();
     Entity BuildDoor(const std::string& name,
                      const glm::vec2& origin,
                      const bool& verticalDoor);
     void BuildMaterials();
+    // Models loaded by Prepare(), building the floor only looks them up
+    ResourceHandle<Prefab> FindModel(const std::string& path) const;
 
     ResourceHandle<Level> m_levelHandle;
+    std::string m_path;
+    uint32_t m_floor = 0;
+    LevelDescription m_description;
+    std::vector<std::string> m_models;
+    std::vector<std::string> m_textures;
+    std::unordered_map<std::string, ResourceHandle<Prefab>> m_modelHandles;
+
+    std::string m_mapPath;
+    ImagePtr m_map;
+    CellGridPtr m_grid;
+    // The prefab of the map is cached under the path of its image, it is only built when missing
+    std::string m_mapIdentifier;
+    PrefabPtr m_mapPrefab;
+    bool m_isNewMap = false;
+
+    // Scene of the floor being built
+    ScenePtr m_scene;
 
     Entity m_player;
     glm::vec2 m_entrancePos{-1.0f};
@@ -74,6 +115,8 @@ private:
     ResourceHandle<Material> m_wallMat;
     ResourceHandle<Material> m_doorMat;
     ResourceHandle<Material> m_waterMat;
+    ResourceHandle<Mesh> m_quadMesh;
+    ResourceHandle<Mesh> m_doorMesh;
 };
 
 #endif  // LEVELLOADER_H
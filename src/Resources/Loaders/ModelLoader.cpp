@@ -6,164 +6,217 @@
 
 #include "Resources/Model.h"
 #include "Renderer/Mesh.h"
+#include "Renderer/ShaderLibrary.h"
 #include "Resources/Manager.h"
 
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
-#include <assimp/material.h>
+#ifdef ENABLE_RUNTIME_COOKING
+#include "Resources/Cookers/ModelCooker.h"
+#endif
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+#include <limits>
 
 // Model Loader
 
 ResourceHandle<Prefab> ModelLoader::Load(const std::string &path)
+{
+    if (!Open(path))
+    {
+        return {};
+    }
+
+    size_t budget = std::numeric_limits<size_t>::max();
+    Upload(budget);
+
+    return ResourceManager::CreateResource<Prefab>(m_loadedIdentifier, m_prefab);
+}
+
+bool ModelLoader::Open(const std::string &path)
 {
     const auto &resolver = Resolver::Get();
-    Assimp::Importer importer;
-    const aiScene *scene = importer.ReadFile(
-        resolver.Resolve(path),
-        aiProcess_Triangulate | aiProcess_GenSmoothNormals);
+    std::string sourcePath = resolver.Resolve(path);
+
+#ifdef ENABLE_RUNTIME_COOKING
+    std::string cookedPath = ModelCooker::Cook(sourcePath, resolver.GetCachePath());
+#else
+    std::string cookedPath = GetCookedModelPath(resolver.AsIdentifier(sourcePath), resolver.GetCachePath());
+#endif
 
-    if (!scene || !scene->mRootNode)
+    if (cookedPath.empty() || !m_file.Open(cookedPath))
     {
-        LOG_ERROR("Could not load model %s : %s", path.c_str(), importer.GetErrorString());
-        return {};
+        LOG_ERROR("Could not load model %s, it has not been cooked (see DungeonMasterCooker).", path.c_str());
+        return false;
     }
-    if (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)
+    if (!ReadHeader())
     {
-        LOG_ERROR("Model %s is empty, not loading anything...", path.c_str());
-        return {};
+        LOG_ERROR("Could not load model %s, its cooked file %s is invalid.", path.c_str(), cookedPath.c_str());
+        return false;
     }
 
     m_loadedIdentifier = resolver.AsIdentifier(path);
-    m_prefab = ResourceManager::CreateResource<Prefab>(m_loadedIdentifier);
-
-    ProcessMaterials(scene);
-    ProcessNode(scene->mRootNode, scene, m_prefab.Get()->GetRootEntity(), m_loadedIdentifier + ":");
 
-    return m_prefab;
+    return true;
 }
 
-void ModelLoader::ProcessMesh(const aiMesh *aiMesh,
-                              const Entity &entity,
-                              const std::string &identifier)
+bool ModelLoader::Upload(size_t& budget)
 {
-    ResourceHandle<Mesh> meshHandle = ResourceManager::CreateResource<Mesh>(identifier);
+    const CookedNode* nodes = reinterpret_cast<const CookedNode*>(m_file.GetData() + m_header.nodesOffset);
+    const CookedMesh* meshes = reinterpret_cast<const CookedMesh*>(m_file.GetData() + m_header.meshesOffset);
 
-    std::vector<Vertex> vertices;
-    vertices.reserve(aiMesh->mNumVertices);
-    for (size_t i = 0; i < aiMesh->mNumVertices; i++)
+    if (!m_prefab)
     {
-        Vertex vertex;
-        vertex.position = {aiMesh->mVertices[i].x,
-                           aiMesh->mVertices[i].y,
-                           aiMesh->mVertices[i].z};
+        m_prefab = Prefab::Create();
+        ProcessMaterials();
 
-        if (aiMesh->HasNormals())
+        // Nodes are stored depth first, parents are always created before their children
+        m_entities.reserve(m_header.nodeCount);
+        m_entities.push_back(m_prefab->GetRootEntity());
+        for (uint32_t i = 1 ; i < m_header.nodeCount ; ++i)
         {
-            vertex.normal = {aiMesh->mNormals[i].x,
-                             aiMesh->mNormals[i].y,
-                             aiMesh->mNormals[i].z};
-            vertex.normal = glm::normalize(vertex.normal);
+            m_entities.push_back(m_entities[nodes[i].parent].AddChild(GetString(nodes[i].name)));
         }
-        else
-            vertex.normal = {0.0f, 0.0f, 0.0f};
-
-        if (aiMesh->HasTextureCoords(0))
-            vertex.texCoords = {aiMesh->mTextureCoords[0][i].x,
-                                aiMesh->mTextureCoords[0][i].y};
-        else
-            vertex.texCoords = {0.0f, 0.0f};
-
-        vertices.push_back(vertex);
     }
 
-    std::vector<uint32_t> indices;
-    for (size_t f = 0; f < aiMesh->mNumFaces; f++)
+    for ( ; m_nextNode < m_header.nodeCount && budget ; ++m_nextNode)
     {
-        for (size_t i = 0; i < aiMesh->mFaces[f].mNumIndices; i++)
+        const CookedNode& node = nodes[m_nextNode];
+        const Entity& entity = m_entities[m_nextNode];
+        if (node.flags & CookedNode_HasTransform)
+        {
+            entity.EmplaceComponent<Components::Transform>(glm::make_mat4(node.transform));
+        }
+        if (node.mesh >= 0)
         {
-            indices.push_back(aiMesh->mFaces[f].mIndices[i]);
+            const CookedMesh& mesh = meshes[node.mesh];
+            ProcessMesh(mesh, entity);
+            budget -= std::min<size_t>(budget, mesh.vertexCount * sizeof(Vertex) + mesh.indexCount * sizeof(uint32_t));
         }
     }
 
-    MeshPtr mesh = meshHandle.Get();
-    mesh->SetVertices(vertices);
-    mesh->SetIndices(indices);
-    entity.EmplaceComponent<Components::Mesh>(meshHandle);
-    entity.EmplaceComponent<Components::RenderMesh>(m_materials[aiMesh->mMaterialIndex]);
+    if (m_nextNode < m_header.nodeCount)
+    {
+        return false;
+    }
+
+    m_entities.clear();
+    m_file.Close();
+
+    return true;
 }
 
-void ModelLoader::ProcessNode(const aiNode *node,
-                              const aiScene *scene,
-                              const Entity &entity,
-                              const std::string &identifier)
+bool ModelLoader::ReadHeader()
 {
-    std::string currentIdentifier = identifier + "/" + node->mName.C_Str();
-    entity.EmplaceComponent<Components::Transform>(glm::transpose(glm::make_mat4(&node->mTransformation.a1)));
+    if (m_file.GetSize() < sizeof(CookedModelHeader))
+    {
+        return false;
+    }
+
+    memcpy(&m_header, m_file.GetData(), sizeof(CookedModelHeader));
+    const CookedModelHeader& header = m_header;
+    if (header.magic != COOKED_MODEL_MAGIC || header.version != COOKED_MODEL_VERSION || !header.nodeCount)
+    {
+        return false;
+    }
 
-    // One mesh, adding its info to the current Entity
-    if (node->mNumMeshes == 1)
+    auto isInFile = [this](const uint64_t& offset, const uint64_t& size) {
+        return offset % 8 == 0 && offset <= m_file.GetSize() && size <= m_file.GetSize() - offset;
+    };
+    if (!isInFile(header.nodesOffset, (uint64_t)header.nodeCount * sizeof(CookedNode)) ||
+        !isInFile(header.meshesOffset, (uint64_t)header.meshCount * sizeof(CookedMesh)) ||
+        !isInFile(header.materialsOffset, (uint64_t)header.materialCount * sizeof(CookedMaterial)) ||
+        !isInFile(header.stringsOffset, header.stringsSize) ||
+        !isInFile(header.vertexDataOffset, header.vertexDataSize) ||
+        !isInFile(header.indexDataOffset, header.indexDataSize))
     {
-        ProcessMesh(scene->mMeshes[node->mMeshes[0]],
-                    entity,
-                    currentIdentifier);
+        return false;
     }
-    // Multiple meshes, adding them as children
-    else if (node->mNumMeshes)
+
+    // Only checking the references between the blocks, the vertex data is used as is
+    auto isValidString = [&header](const CookedString& string) {
+        return (uint64_t)string.offset + string.size <= header.stringsSize;
+    };
+
+    const CookedMesh* meshes = reinterpret_cast<const CookedMesh*>(m_file.GetData() + header.meshesOffset);
+    for (uint32_t i = 0 ; i < header.meshCount ; ++i)
     {
-        std::string meshName = entity.GetName() + "_msh";
-        Entity child = entity.AddChild(meshName);
-        ProcessMesh(scene->mMeshes[node->mMeshes[0]],
-            child,
-            currentIdentifier);
-
-        // TODO: We're loading other meshes with a suffix. These should potentially be loaded as "sub meshes" (sub parts of a Mesh)
-        //       to load them into a single resource instead of one resource per mesh.
-        for (size_t i = 1; i < node->mNumMeshes; i++)
+        const CookedMesh& mesh = meshes[i];
+        if (!isValidString(mesh.identifier) || mesh.material >= header.materialCount ||
+            ((uint64_t)mesh.firstVertex + mesh.vertexCount) * sizeof(Vertex) > header.vertexDataSize ||
+            ((uint64_t)mesh.firstIndex + mesh.indexCount) * sizeof(uint32_t) > header.indexDataSize)
         {
-            child = entity.AddChild(meshName + std::to_string(i));
-            ProcessMesh(scene->mMeshes[node->mMeshes[i]],
-                        child,
-                        currentIdentifier + "_" + std::to_string(i));
+            return false;
         }
     }
 
-    for (size_t i = 0; i < node->mNumChildren; i++)
+    const CookedNode* nodes = reinterpret_cast<const CookedNode*>(m_file.GetData() + header.nodesOffset);
+    for (uint32_t i = 0 ; i < header.nodeCount ; ++i)
     {
-        Entity child = entity.AddChild(node->mChildren[i]->mName.C_Str());
-        ProcessNode(node->mChildren[i],
-                    scene,
-                    child,
-                    currentIdentifier);
+        const CookedNode& node = nodes[i];
+        if (!isValidString(node.name) || 
+            (i == 0) != (node.parent < 0) || node.parent >= (int32_t)i ||
+            node.mesh >= (int32_t)header.meshCount)
+        {
+            return false;
+        }
     }
+
+    const CookedMaterial* materials = reinterpret_cast<const CookedMaterial*>(m_file.GetData() + header.materialsOffset);
+    for (uint32_t i = 0 ; i < header.materialCount ; ++i)
+    {
+        if (!isValidString(materials[i].name))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string ModelLoader::GetString(const CookedString& string) const
+{
+    const char* strings = reinterpret_cast<const char*>(m_file.GetData() + m_header.stringsOffset);
+    return std::string(strings + string.offset, string.size);
+}
+
+void ModelLoader::ProcessMesh(const CookedMesh& cookedMesh,
+                              const Entity &entity)
+{
+    const Vertex* vertices = reinterpret_cast<const Vertex*>(m_file.GetData() + m_header.vertexDataOffset);
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(m_file.GetData() + m_header.indexDataOffset);
+
+    ResourceHandle<Mesh> meshHandle = ResourceManager::CreateResource<Mesh>(
+        m_loadedIdentifier + GetString(cookedMesh.identifier),
+        Mesh::Create(vertices + cookedMesh.firstVertex, cookedMesh.vertexCount,
+                     indices + cookedMesh.firstIndex, cookedMesh.indexCount));
+
+    entity.EmplaceComponent<Components::Mesh>(meshHandle);
+    entity.EmplaceComponent<Components::RenderMesh>(m_materials[cookedMesh.material]);
 }
 
-void ModelLoader::ProcessMaterials(const aiScene *scene)
+void ModelLoader::ProcessMaterials()
 {
     const auto &resolver = Resolver::Get();
+    const CookedMaterial* materials = reinterpret_cast<const CookedMaterial*>(m_file.GetData() + m_header.materialsOffset);
 
-    m_materials.reserve(scene->mNumMaterials);
-    for (size_t i = 0; i < scene->mNumMaterials; i++)
+    m_materials.reserve(m_header.materialCount);
+    for (size_t i = 0; i < m_header.materialCount; i++)
     {
-        auto aiMaterial = scene->mMaterials[i];
-        MaterialPtr material = Material::Create(Shader::Open(resolver.Resolve("Shaders/default.vert"),
+        const CookedMaterial& cookedMaterial = materials[i];
+        MaterialPtr material = Material::Create(ShaderLibrary::Open(resolver.Resolve("Shaders/default.vert"),
                                                              resolver.Resolve("Shaders/pbrMaterial.frag")));
-        aiColor3D color;
-        // Should sample the pbr material but assimp has some issues with it.
-        // Using the Blinn/Phong keys instead
-        if (aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, color) != AI_FAILURE)
-            material->SetInputValue("baseColor", glm::vec3(color.r, color.g, color.b));
-        else
-            material->SetInputValue("baseColor", glm::vec3(0.0, 1.0, 0.0));
+        if (cookedMaterial.flags & CookedMaterial_HasBaseColor)
+            material->SetInputValue("baseColor", glm::make_vec3(cookedMaterial.baseColor));
         
-        if (aiMaterial->Get(AI_MATKEY_COLOR_AMBIENT, color) != AI_FAILURE)
-            material->SetInputValue("emissionColor", glm::vec3(color.r, color.g, color.b));
+        if (cookedMaterial.flags & CookedMaterial_HasEmissionColor)
+            material->SetInputValue("emissionColor", glm::make_vec3(cookedMaterial.emissionColor));
 
-        if (aiMaterial->Get(AI_MATKEY_COLOR_TRANSPARENT, color) != AI_FAILURE)
-            material->SetInputValue("transmissionColor", glm::vec3(color.r, color.g, color.b));
+        if (cookedMaterial.flags & CookedMaterial_HasTransmissionColor)
+            material->SetInputValue("transmissionColor", glm::make_vec3(cookedMaterial.transmissionColor));
 
         ResourceHandle<Material> handle = ResourceManager::CreateResource<Material>(
-            m_loadedIdentifier + ":" + aiMaterial->GetName().C_Str(),
+            m_loadedIdentifier + ":" + GetString(cookedMaterial.name),
             material);
 
         m_materials.push_back(handle);
@@ -3,14 +3,14 @@
 
 #include "Resources/Resource.h"
 #include "Resources/Prefab.h"
+#include "Resources/Cookers/CookedModel.h"
 
-class Material;
+#include "Utils/FileUtils.h"
 
-class aiScene;
-class aiNode;
-class aiMesh;
+class Material;
 
 
+// Builds Prefabs from cooked models, reading the vertex and index data straight from a memory mapping
 class ModelLoader 
 {
 public:
@@ -19,20 +19,33 @@ public:
 
     ResourceHandle<Prefab> Load(const std::string& path);
 
+    // Loading can also be split between a worker thread opening the cooked model (cooking it if needed)
+    // and the main thread building the prefab, uploading the meshes within the given budget (in bytes).
+    // Upload returns true once the whole prefab has been built.
+    bool Open(const std::string& path);
+    bool Upload(size_t& budget);
+
+    inline const std::string& GetIdentifier() const { return m_loadedIdentifier; }
+    inline PrefabPtr GetPrefab() const { return m_prefab; }
+
 private:
-    void ProcessNode(const aiNode* node, 
-                           const aiScene* scene, 
-                           const Entity& entity,
-                           const std::string& identifier);
-    void ProcessMesh(const aiMesh* aiMesh, 
-                           const Entity& entity,
-                           const std::string& identifier);
-    void ProcessMaterials(const aiScene* scene);
+    // Reads the header and checks that every block and reference stays within the file
+    bool ReadHeader();
+    std::string GetString(const CookedString& string) const;
+
+    void ProcessMesh(const CookedMesh& cookedMesh, 
+                     const Entity& entity);
+    void ProcessMaterials();
+
+    MappedFile m_file;
+    CookedModelHeader m_header;
 
     std::string m_loadedIdentifier;
-    ResourceHandle<Prefab> m_prefab;
+    PrefabPtr m_prefab;
     std::vector<ResourceHandle<Material>> m_materials;
-    // std::vector<MaterialPtr> m_materials;
+
+    std::vector<Entity> m_entities;
+    uint32_t m_nextNode = 0;
 };
 
 
@@ -2,57 +2,499 @@
 
 #include "Loaders/ModelLoader.h"
 #include "Loaders/LevelLoader.h"
+#include "Cookers/TextureCooker.h"
+
+#include "Renderer/ShaderLibrary.h"
 
 #include "Core/Application.h"
+#include "Core/JobSystem.h"
+#include "Core/Logging.h"
 #include "Core/Resolver.h"
 
+#include <algorithm>
 #include <filesystem>
 
 
-ResourceHandle<Prefab> ResourceManager::LoadModel(const std::string& path) 
+static const TextureCookSettings& GetTextureCookSettings()
 {
-    auto& resolver = Resolver::Get();
+    // Queried on the main thread as it depends on the GL context
+    static const TextureCookSettings settings = TextureCooker::GetDefaultSettings();
+    return settings;
+}
+
+static bool IsModelFile(const std::string& path)
+{
+    static const std::vector<std::string> extensions = {".fbx", ".obj", ".gltf", ".glb"};
+    std::string extension = std::filesystem::path(path).extension().string();
+    return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+}
+
+
+// == Streaming requests ==
+
+class ModelStreamRequest : public StreamRequest
+{
+public:
+    ModelStreamRequest(const ResourceId& identifier) : 
+            StreamRequest(identifier, typeid(Prefab)) {}
+
+    bool Decode() override
+    {
+        return m_loader.Open(GetIdentifier().GetString());
+    }
+
+    bool Upload(size_t& budget) override
+    {
+        return m_loader.Upload(budget);
+    }
+
+    void Finish(const bool& success) override
+    {
+        if (success)
+            ResourceManager::CreateResource<Prefab>(GetIdentifier(), m_loader.GetPrefab());
+        else
+            ResourceManager::FreePendingResource<Prefab>(GetIdentifier());
+    }
+
+private:
+    ModelLoader m_loader;
+};
+
+
+class TextureStreamRequest : public StreamRequest
+{
+public:
+    TextureStreamRequest(const ResourceId& identifier) : 
+            StreamRequest(identifier, typeid(Texture)),
+            m_sourcePath(Resolver::Get().Resolve(identifier.GetString())),
+            m_cacheDirectory(Resolver::Get().GetCachePath()),
+            m_settings(GetTextureCookSettings()) {}
+
+    bool Decode() override
+    {
+        std::string cookedPath = TextureCooker::Cook(m_sourcePath, m_cacheDirectory, m_settings);
+        if (!cookedPath.empty() && m_cookedTexture.Open(cookedPath))
+        {
+            m_isCooked = true;
+            return true;
+        }
+
+        // Falling back on the source image when the cooked texture can't be used
+        m_image = Image::Read(m_sourcePath);
+        return (bool)m_image;
+    }
+
+    bool Upload(size_t& budget) override
+    {
+        if (m_isCooked)
+        {
+            return m_cookedTexture.Upload(budget);
+        }
+
+        m_texture = Texture::FromImage(m_image);
+        budget -= std::min(budget, m_image->GetDataSize());
+        m_image.reset();
+
+        return true;
+    }
+
+    void Finish(const bool& success) override
+    {
+        if (success)
+            ResourceManager::CreateResource<Texture>(GetIdentifier(), m_isCooked ? m_cookedTexture.GetTexture() : m_texture);
+        else
+            ResourceManager::FreePendingResource<Texture>(GetIdentifier());
+    }
+
+private:
+    std::string m_sourcePath;
+    std::string m_cacheDirectory;
+    TextureCookSettings m_settings;
+
+    bool m_isCooked = false;
+    CookedTexture m_cookedTexture;
+    ImagePtr m_image;
+    TexturePtr m_texture;
+};
+
+
+// Streams the models and textures of a floor in before building it in a single step.
+// Floors preloaded into an existing level use a request identifier of their own, the level is not pending.
+class LevelStreamRequest : public StreamRequest
+{
+public:
+    LevelStreamRequest(const ResourceId& identifier, const uint32_t& floor) : 
+            StreamRequest(identifier, typeid(Level)), m_levelIdentifier(identifier), m_floor(floor), m_isPreload(false) {}
+    LevelStreamRequest(const ResourceId& requestIdentifier, const ResourceId& levelIdentifier, const uint32_t& floor) : 
+            StreamRequest(requestIdentifier, typeid(Level)), m_levelIdentifier(levelIdentifier), m_floor(floor), m_isPreload(true) {}
+    ~LevelStreamRequest()
+    {
+        if (m_buildJob.IsValid())
+        {
+            JobSystem::Get().Wait(m_buildJob);
+        }
+    }
+
+    bool Decode() override
+    {
+        return m_loader.Read(m_levelIdentifier.GetString(), m_floor);
+    }
+
+    bool Upload(size_t& budget) override
+    {
+        if (!m_dependenciesRequested)
+        {
+            for (const auto& model : m_loader.GetModels())
+            {
+                m_modelHandles.push_back(ResourceManager::LoadModelAsync(model));
+            }
+            for (const auto& texture : m_loader.GetTextures())
+            {
+                m_textureHandles.push_back(ResourceManager::LoadTextureAsync(texture));
+            }
+            m_dependenciesRequested = true;
+        }
+
+        for (const auto& handle : m_modelHandles)
+        {
+            if (handle.IsPending())
+                return false;
+        }
+        for (const auto& handle : m_textureHandles)
+        {
+            if (handle.IsPending())
+                return false;
+        }
+
+        // Only the GL resources are created here, the floor was read on a worker and is built on the job system
+        if (!m_buildJob.IsValid())
+        {
+            // The level may have been released while its next floor was being preloaded
+            if ((m_isPreload && !ResourceManager::GetResource<Level>(m_levelIdentifier)) || m_loader.IsBuilt())
+            {
+                return true;
+            }
+
+            m_loader.Prepare(budget);
+            m_buildJob = JobSystem::Get().ScheduleBackground([this]() { m_loader.Build(); }, {}, "BuildFloor");
+            return false;
+        }
+
+        if (!m_buildJob.IsDone())
+        {
+            return false;
+        }
+
+        m_loader.Publish();
+        return true;
+    }
+
+    bool WaitForWork() override
+    {
+        if (!m_buildJob.IsValid() || m_buildJob.IsDone())
+        {
+            return false;
+        }
+
+        JobSystem::Get().Wait(m_buildJob);
+        return true;
+    }
+
+    void Finish(const bool& success) override
+    {
+        // The level loader completes the pending resource unless the level is invalid
+        if (!m_isPreload)
+        {
+            ResourceManager::FreePendingResource<Level>(m_levelIdentifier);
+        }
+    }
+
+private:
+    ResourceId m_levelIdentifier;
+    uint32_t m_floor;
+    bool m_isPreload;
+
+    LevelLoader m_loader;
+    JobHandle m_buildJob;
+
+    bool m_dependenciesRequested = false;
+    std::vector<ResourceHandle<Prefab>> m_modelHandles;
+    std::vector<ResourceHandle<Texture>> m_textureHandles;
+};
+
+
+// == Loading ==
 
-    std::string identifier = resolver.AsIdentifier(path);
-    if (auto handle = GetResource<Prefab>(identifier)) 
+ResourceId ResourceManager::ResolveIdentifier(const std::string& path)
+{
+    static std::unordered_map<std::string, ResourceId> s_identifiers;
+    static std::shared_mutex s_identifiersMutex;
+
+    {
+        std::shared_lock<std::shared_mutex> lock(s_identifiersMutex);
+        auto it = s_identifiers.find(path);
+        if (it != s_identifiers.end())
+        {
+            return it->second;
+        }
+    }
+
+    ResourceId identifier = Resolver::Get().AsIdentifier(path);
+
+    std::unique_lock<std::shared_mutex> lock(s_identifiersMutex);
+    s_identifiers.insert({ path, identifier });
+
+    return identifier;
+}
+
+ResourceHandle<Prefab> ResourceManager::LoadModel(const std::string& path) 
+{
+    ResourceId identifier = ResolveIdentifier(path);
+    if (auto handle = CompleteResource<Prefab>(identifier)) 
     {
         return handle;
     }
 
     ModelLoader loader;
-    return loader.Load(identifier);
+    return loader.Load(identifier.GetString());
 }
 
 ResourceHandle<Texture> ResourceManager::LoadTexture(const std::string& path) 
 {
-    auto& resolver = Resolver::Get();
-
-    std::string identifier = resolver.AsIdentifier(path);
-    if (auto handle = GetResource<Texture>(identifier)) 
+    ResourceId identifier = ResolveIdentifier(path);
+    if (auto handle = CompleteResource<Texture>(identifier)) 
     {
         return handle;
     }
 
-    ImagePtr image = Image::Read(resolver.Resolve(path));
-    if (!image)
+    TexturePtr texture = ReadTexture(path);
+    if (!texture)
     {
         return ResourceHandle<Texture>();
     }
 
-    return CreateResource<Texture>(identifier, Texture::FromImage(image, GL_RGBA32F));
+    return CreateResource<Texture>(identifier, texture);
 }
 
-
-ResourceHandle<Level> ResourceManager::LoadLevel(const std::string& path) 
+TexturePtr ResourceManager::ReadTexture(const std::string& path)
 {
     auto& resolver = Resolver::Get();
+    std::string sourcePath = resolver.Resolve(path);
 
-    std::string identifier = resolver.AsIdentifier(path);
-    if (auto handle = GetResource<Level>(identifier)) 
+    // Textures are loaded from their cooked version, cooked on first use
+    std::string cookedPath = TextureCooker::Cook(sourcePath, resolver.GetCachePath(), GetTextureCookSettings());
+    if (!cookedPath.empty())
+    {
+        if (TexturePtr texture = TextureCooker::Load(cookedPath))
+        {
+            return texture;
+        }
+    }
+
+    // Falling back on the source image when the cooked texture can't be used
+    ImagePtr image = Image::Read(sourcePath);
+    if (!image)
+    {
+        return nullptr;
+    }
+
+    return Texture::FromImage(image);
+}
+
+ResourceHandle<Level> ResourceManager::LoadLevel(const std::string& path, const uint32_t& floor) 
+{
+    ResourceId identifier = ResolveIdentifier(path);
+    ResourceHandle<Level> handle = CompleteResource<Level>(identifier);
+    if (handle && floor < handle.Get()->floors.size() && handle.Get()->floors[floor].IsBuilt()) 
     {
         return handle;
     }
 
     LevelLoader loader;
-    return loader.Load(identifier);
+    return loader.Load(identifier.GetString(), floor);
+}
+
+
+// == Reloading ==
+
+bool ResourceManager::Reload(const std::string& path)
+{
+    std::string sourcePath = Resolver::Get().Resolve(path);
+    ResourceId identifier = ResolveIdentifier(path);
+    bool reloaded = false;
+
+    if (uint32_t count = ShaderLibrary::ReloadFile(sourcePath))
+    {
+        LOG_INFO("Reloaded %u shader(s) using %s", count, identifier.GetString().c_str());
+        reloaded = true;
+    }
+
+    // The texture object is kept so that the materials holding it see the new data
+    if (TexturePtr texture = GetResource<Texture>(identifier).Get())
+    {
+        if (TexturePtr newTexture = ReadTexture(path))
+        {
+            texture->Swap(*newTexture);
+            CreateResource<Texture>(identifier, texture);
+            LOG_INFO("Reloaded texture %s", identifier.GetString().c_str());
+            reloaded = true;
+        }
+    }
+
+    // Levels also cache the prefab of their map under the path of its image, it is rebuilt along with the level
+    if (IsModelFile(sourcePath) && GetResource<Prefab>(identifier))
+    {
+        // The meshes and materials of the model are replaced in place, the scenes using them see the new data
+        ModelLoader loader;
+        if (loader.Load(identifier.GetString()))
+        {
+            LOG_INFO("Reloaded model %s", identifier.GetString().c_str());
+            reloaded = true;
+        }
+    }
+
+    return reloaded;
+}
+
+
+// == Asynchronous loading ==
+
+ResourceHandle<Prefab> ResourceManager::LoadModelAsync(const std::string& path, const StreamCallback& callback)
+{
+    ResourceId identifier = ResolveIdentifier(path);
+    ResourceHandle<Prefab> handle = FindAsyncResource<Prefab>(identifier, callback);
+    if (handle || handle.IsPending())
+    {
+        return handle;
+    }
+
+    handle = CreatePendingResource<Prefab>(identifier);
+    ResourceStreamer::Get().Submit(std::make_shared<ModelStreamRequest>(identifier), callback);
+
+    return handle;
+}
+
+ResourceHandle<Texture> ResourceManager::LoadTextureAsync(const std::string& path, const StreamCallback& callback)
+{
+    ResourceId identifier = ResolveIdentifier(path);
+    ResourceHandle<Texture> handle = FindAsyncResource<Texture>(identifier, callback);
+    if (handle || handle.IsPending())
+    {
+        return handle;
+    }
+
+    handle = CreatePendingResource<Texture>(identifier);
+    ResourceStreamer::Get().Submit(std::make_shared<TextureStreamRequest>(identifier), callback);
+
+    return handle;
+}
+
+ResourceHandle<Level> ResourceManager::LoadLevelAsync(const std::string& path, const uint32_t& floor, const StreamCallback& callback)
+{
+    ResourceId identifier = ResolveIdentifier(path);
+    ResourceHandle<Level> handle = GetResource<Level>(identifier);
+    if (handle)
+    {
+        PreloadLevelFloor(path, floor, callback);
+        return handle;
+    }
+
+    handle = FindAsyncResource<Level>(identifier, callback);
+    if (handle.IsPending())
+    {
+        return handle;
+    }
+
+    handle = CreatePendingResource<Level>(identifier);
+    ResourceStreamer::Get().Submit(std::make_shared<LevelStreamRequest>(identifier, floor), callback);
+
+    return handle;
+}
+
+void ResourceManager::PreloadLevelFloor(const std::string& path, const uint32_t& floor, const StreamCallback& callback)
+{
+    ResourceId identifier = ResolveIdentifier(path);
+    ResourceHandle<Level> handle = GetResource<Level>(identifier);
+    if (!handle || floor >= handle.Get()->floors.size() || handle.Get()->floors[floor].IsBuilt())
+    {
+        if (callback)
+        {
+            callback();
+        }
+        return;
+    }
+
+    // Preloading the same floor twice only waits for the first request
+    ResourceId requestIdentifier = identifier.GetString() + ":" + std::to_string(floor);
+    if (ResourceStreamer::Get().AddCallback(typeid(Level), requestIdentifier, callback))
+    {
+        return;
+    }
+
+    ResourceStreamer::Get().Submit(std::make_shared<LevelStreamRequest>(requestIdentifier, identifier, floor), callback);
+}
+
+
+// == Memory budget ==
+
+std::atomic<uint64_t> ResourceManager::s_frame{0};
+
+
+void ResourceManager::OnUpdate()
+{
+    s_frame++;
+
+    // Owners first, evicting them releases the resources they reference
+    CollectGarbage<Level>();
+    CollectGarbage<Prefab>();
+    CollectGarbage<Material>();
+    CollectGarbage<Mesh>();
+    CollectGarbage<Texture>();
+}
+
+void ResourceManager::LogFootprint()
+{
+    auto logFootprint = [](const char* name, const ResourceFootprint& footprint) {
+        LOG_INFO("%-10s %5zu resources, CPU %8.2f MB, GPU %8.2f MB", name, footprint.count,
+                 footprint.cpuBytes / (1024.0 * 1024.0), footprint.gpuBytes / (1024.0 * 1024.0));
+    };
+
+    logFootprint("Levels", GetFootprint<Level>());
+    logFootprint("Prefabs", GetFootprint<Prefab>());
+    logFootprint("Materials", GetFootprint<Material>());
+    logFootprint("Meshes", GetFootprint<Mesh>());
+    logFootprint("Textures", GetFootprint<Texture>());
+}
+
+ResourceFootprint ResourceManager::ComputeFootprint(const Prefab& prefab)
+{
+    // The meshes and materials of the prefab are accounted for on their own
+    return {};
+}
+
+ResourceFootprint ResourceManager::ComputeFootprint(const Texture& texture)
+{
+    return { 0, texture.GetGpuMemorySize() };
+}
+
+ResourceFootprint ResourceManager::ComputeFootprint(const Mesh& mesh)
+{
+    return { mesh.GetCpuMemorySize(), mesh.GetGpuMemorySize() };
+}
+
+ResourceFootprint ResourceManager::ComputeFootprint(const Material& material)
+{
+    return { 0, material.GetGpuMemorySize() };
+}
+
+ResourceFootprint ResourceManager::ComputeFootprint(const Level& level)
+{
+    size_t size = 0;
+    for (const auto& floor : level.floors)
+    {
+        size += floor.map ? floor.map->GetDataSize() : 0;
+        size += floor.grid ? 2 * (size_t)floor.grid->GetWidth() * floor.grid->GetHeight() : 0;
+    }
+
+    return { size, 0 };
 }
@@ -3,86 +3,364 @@
 
 #include "Resource.h"
 #include "Prefab.h"
+#include "Streamer.h"
 
 #include "Renderer/Material.h"
 #include "Renderer/Mesh.h"
 #include "Renderer/Texture.h"
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
 #include <memory>
 #include <vector>
 
 
 class Level;
 
+
+struct ResourceFootprint
+{
+    size_t cpuBytes = 0;
+    size_t gpuBytes = 0;
+    size_t count = 0;
+};
+
+struct ResourceBudget
+{
+    size_t cpuBytes = 0;
+    size_t gpuBytes = 0;
+};
+
+
 class ResourceManager {
 public:
+    // Every function is thread safe, the resources being looked up under a per type read lock.
+    // Identifiers can be given as strings, they are interned into ResourceIds on the fly.
+
     template <typename T>
-    static ResourceHandle<T> CreateResource(const std::string& identifier, 
+    static ResourceHandle<T> CreateResource(const ResourceId& identifier, 
                                             const bool& hasOwner = false)
     {
-        // TODO: Generate properly unique identifiers
-        Resource<T>* resource = new Resource<T>{T::Create(), hasOwner};
+        return CreateResource<T>(identifier, T::Create(), hasOwner);
+    }
+
+    template <typename T>
+    static ResourceHandle<T> CreateResource(const ResourceId& identifier, 
+                                            const std::shared_ptr<T>& data, 
+                                            const bool& hasOwner = false)
+    {
+        std::unique_lock<std::shared_mutex> lock(s_mutexes<T>);
+
+        // Creating an existing resource replaces its data in place (completing it if it was pending),
+        // the handles already given out see the new data
+        auto it = s_resources<T>.find(identifier);
+        if (it != s_resources<T>.end())
+        {
+            Untrack(*it->second);
+            Publish(*it->second, data);
+            it->second->hasOwner = hasOwner;
+            it->second->pending = false;
+            Track(*it->second);
+            return { identifier, it->second };
+        }
+
+        Resource<T>* resource = new Resource<T>{data, nullptr, {}, hasOwner};
+        resource->published.store(data.get(), std::memory_order_release);
         std::shared_ptr<Resource<T>> resourcePtr(resource);
 
         s_resources<T>.insert({ identifier, resourcePtr });
+        Track(*resourcePtr);
 
         return { identifier, resourcePtr };
     }
 
+    // Placeholder for a resource being streamed in, completed by CreateResource()
     template <typename T>
-    static ResourceHandle<T> CreateResource(const std::string& identifier, 
-                                            const std::shared_ptr<T>& data, 
-                                            const bool& hasOwner = false)
+    static ResourceHandle<T> CreatePendingResource(const ResourceId& identifier)
     {
-        // TODO: Generate properly unique identifiers
-        Resource<T>* resource = new Resource<T>{data, hasOwner};
+        Resource<T>* resource = new Resource<T>{nullptr, nullptr, {}, false, true};
         std::shared_ptr<Resource<T>> resourcePtr(resource);
 
+        std::unique_lock<std::shared_mutex> lock(s_mutexes<T>);
+        auto it = s_resources<T>.find(identifier);
+        if (it != s_resources<T>.end())
+        {
+            Release<T>(it);
+        }
         s_resources<T>.insert({ identifier, resourcePtr });
 
         return { identifier, resourcePtr };
     }
 
     template <typename T>
-    static ResourceHandle<T> GetResource(const std::string& identifier) 
+    static ResourceHandle<T> GetResource(const ResourceId& identifier) 
     {
+        std::shared_lock<std::shared_mutex> lock(s_mutexes<T>);
         auto it = s_resources<T>.find(identifier);
         if (it == s_resources<T>.end()) 
             return {identifier};
     
+        it->second->lastUsed.store(s_frame, std::memory_order_relaxed);
         return { identifier, it->second };
     }
 
+    // Handles to a freed resource become invalid, its data is released along with the last reference to it
     template <typename T>
-    static void FreeResource(const std::string& identifier)
+    static void FreeResource(const ResourceId& identifier)
     {
+        std::unique_lock<std::shared_mutex> lock(s_mutexes<T>);
         auto it = s_resources<T>.find(identifier);
         if (it != s_resources<T>.end()) 
-            s_resources<T>.erase(it);
+            Release<T>(it);
     }
 
+    // Releases a resource that is still pending, when its load failed
+    template <typename T>
+    static void FreePendingResource(const ResourceId& identifier)
+    {
+        std::unique_lock<std::shared_mutex> lock(s_mutexes<T>);
+        auto it = s_resources<T>.find(identifier);
+        if (it != s_resources<T>.end() && it->second->pending) 
+            Release<T>(it);
+    }
+
+    // Points the handle to the resource currently registered under its identifier
     template <typename T>
     static void UpdateHandle(ResourceHandle<T>& handle)
     {
-        auto it = s_resources<T>.find(handle.identifier);
-        if (it != s_resources<T>.end()) 
-            handle.m_resource = it->second;
+        handle = GetResource<T>(handle.GetId());
+    }
+
+    // Memory budget of a resource type, 0 meaning unlimited. Resources that are not referenced anymore
+    // are kept in cache until their type goes over budget, the least recently used ones being evicted first.
+    template <typename T>
+    static void SetBudget(const ResourceBudget& budget) 
+    { 
+        std::unique_lock<std::shared_mutex> lock(s_mutexes<T>);
+        s_budgets<T> = budget; 
     }
+    template <typename T>
+    static ResourceBudget GetBudget() 
+    { 
+        std::shared_lock<std::shared_mutex> lock(s_mutexes<T>);
+        return s_budgets<T>; 
+    }
+
+    // Memory currently used by the resources of a type that are held by the manager
+    template <typename T>
+    static ResourceFootprint GetFootprint() 
+    { 
+        std::shared_lock<std::shared_mutex> lock(s_mutexes<T>);
+        return s_footprints<T>; 
+    }
+    static void LogFootprint();
+
+    // Evicts the unreferenced resources of the types that are over budget, to be called once per frame
+    static void OnUpdate();
 
     static ResourceHandle<Prefab> LoadModel(const std::string& path);
     static ResourceHandle<Texture> LoadTexture(const std::string& path);
-    static ResourceHandle<Level> LoadLevel(const std::string& path);
+    static ResourceHandle<Level> LoadLevel(const std::string& path, const uint32_t& floor=0);
+
+    // Reloads the shaders, textures and models built from the given file in place, the existing handles
+    // see the new data. Levels are rebuilt by the GameManager. Returns false if nothing uses the file.
+    static bool Reload(const std::string& path);
+
+    // Asynchronous versions of the loads, the handles are returned in a pending state and become valid
+    // once the resource has been decoded on a worker thread and uploaded by the ResourceStreamer.
+    // The callback is called on the main thread when the load is over, whether it succeeded or not.
+    static ResourceHandle<Prefab> LoadModelAsync(const std::string& path, const StreamCallback& callback=StreamCallback());
+    static ResourceHandle<Texture> LoadTextureAsync(const std::string& path, const StreamCallback& callback=StreamCallback());
+    static ResourceHandle<Level> LoadLevelAsync(const std::string& path, 
+                                                const uint32_t& floor=0, 
+                                                const StreamCallback& callback=StreamCallback());
+    // Builds another floor of a loaded level in the background, while the current floor is being played
+    static void PreloadLevelFloor(const std::string& path, 
+                                  const uint32_t& floor, 
+                                  const StreamCallback& callback=StreamCallback());
 
 private:
 
     template <typename T>
-    static std::unordered_map<std::string, std::shared_ptr<Resource<T>>> s_resources;
+    using ResourceMap = std::unordered_map<ResourceId, std::shared_ptr<Resource<T>>>;
+
+    template <typename T>
+    static ResourceMap<T> s_resources;
+    // Guards the resources, budget and footprint of each type
+    template <typename T>
+    static std::shared_mutex s_mutexes;
+    template <typename T>
+    static ResourceBudget s_budgets;
+    template <typename T>
+    static ResourceFootprint s_footprints;
+    static std::atomic<uint64_t> s_frame;
+
+    // Interns the identifier of a path, caching the result as resolving it is quite slow
+    static ResourceId ResolveIdentifier(const std::string& path);
+    // Reads a texture from its cooked version, or from the source image when it can't be cooked
+    static TexturePtr ReadTexture(const std::string& path);
+
+    static ResourceFootprint ComputeFootprint(const Prefab& prefab);
+    static ResourceFootprint ComputeFootprint(const Texture& texture);
+    static ResourceFootprint ComputeFootprint(const Mesh& mesh);
+    static ResourceFootprint ComputeFootprint(const Material& material);
+    static ResourceFootprint ComputeFootprint(const Level& level);
+
+    template <typename T>
+    static void Track(Resource<T>& resource)
+    {
+        ResourceFootprint footprint;
+        if (resource.data)
+        {
+            footprint = ComputeFootprint(*resource.data);
+        }
+
+        resource.cpuSize = footprint.cpuBytes;
+        resource.gpuSize = footprint.gpuBytes;
+        resource.lastUsed.store(s_frame, std::memory_order_relaxed);
+        s_footprints<T>.cpuBytes += resource.cpuSize;
+        s_footprints<T>.gpuBytes += resource.gpuSize;
+        s_footprints<T>.count++;
+    }
+
+    template <typename T>
+    static void Untrack(const Resource<T>& resource)
+    {
+        if (resource.pending)
+        {
+            return;
+        }
+
+        s_footprints<T>.cpuBytes -= resource.cpuSize;
+        s_footprints<T>.gpuBytes -= resource.gpuSize;
+        s_footprints<T>.count--;
+    }
+
+    // Changes the data of a resource, the type must be locked. The handles may still be reading the previous data,
+    // it is retired until the garbage collection finds the slot unreferenced.
+    template <typename T>
+    static void Publish(Resource<T>& resource, const std::shared_ptr<T>& data)
+    {
+        if (resource.data && resource.data != data)
+        {
+            resource.retired.push_back(resource.data);
+        }
+
+        resource.data = data;
+        resource.published.store(data.get(), std::memory_order_release);
+    }
+
+    // Removes a resource from the manager and invalidates its handles, the type must be locked
+    template <typename T>
+    static void Release(const typename ResourceMap<T>::iterator& it)
+    {
+        Resource<T>& resource = *it->second;
+        Untrack(resource);
+        resource.generation++;
+        Publish(resource, std::shared_ptr<T>());
+        s_resources<T>.erase(it);
+    }
+
+    template <typename T>
+    static bool IsOverBudget()
+    {
+        const ResourceBudget& budget = s_budgets<T>;
+        const ResourceFootprint& footprint = s_footprints<T>;
+        return (budget.cpuBytes && footprint.cpuBytes > budget.cpuBytes) ||
+               (budget.gpuBytes && footprint.gpuBytes > budget.gpuBytes);
+    }
+
+    template <typename T>
+    static void CollectGarbage()
+    {
+        typedef typename ResourceMap<T>::iterator Iterator;
+
+        std::unique_lock<std::shared_mutex> lock(s_mutexes<T>);
+        bool overBudget = IsOverBudget<T>();
+        std::vector<Iterator> candidates;
+        for (auto it = s_resources<T>.begin() ; it != s_resources<T>.end() ; ++it)
+        {
+            Resource<T>& resource = *it->second;
+
+            // Nothing can be reading the retired data anymore once the slot is only referenced by the manager
+            if (it->second.use_count() == 1)
+            {
+                resource.retired.clear();
+            }
+
+            if (resource.pending || resource.hasOwner)
+            {
+                continue;
+            }
+
+            // Still referenced by a handle or by an other object
+            if (it->second.use_count() > 1 || resource.data.use_count() > 1)
+            {
+                resource.lastUsed.store(s_frame, std::memory_order_relaxed);
+            }
+            else if (overBudget)
+            {
+                candidates.push_back(it);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](const Iterator& a, const Iterator& b) {
+            return a->second->lastUsed < b->second->lastUsed;
+        });
+        for (const auto& it : candidates)
+        {
+            if (!IsOverBudget<T>())
+            {
+                break;
+            }
+
+            Release<T>(it);
+        }
+    }
+
+    // Returns the handle of the resource if it is loaded or already being loaded, an empty one otherwise
+    template <typename T>
+    static ResourceHandle<T> FindAsyncResource(const ResourceId& identifier, const StreamCallback& callback)
+    {
+        ResourceHandle<T> handle = GetResource<T>(identifier);
+        if (handle.IsPending())
+        {
+            ResourceStreamer::Get().AddCallback(typeid(T), identifier, callback);
+        }
+        else if (handle && callback)
+        {
+            callback();
+        }
+
+        return handle;
+    }
+
+    // Finishes the pending load of a resource before it is loaded synchronously
+    template <typename T>
+    static ResourceHandle<T> CompleteResource(const ResourceId& identifier)
+    {
+        ResourceHandle<T> handle = GetResource<T>(identifier);
+        if (handle.IsPending())
+        {
+            ResourceStreamer::Get().Complete(typeid(T), identifier);
+        }
+
+        return handle;
+    }
 };
 
 template<typename T>
-std::unordered_map<std::string, std::shared_ptr<Resource<T>>> ResourceManager::s_resources;
+ResourceManager::ResourceMap<T> ResourceManager::s_resources;
+template<typename T>
+std::shared_mutex ResourceManager::s_mutexes;
+template<typename T>
+ResourceBudget ResourceManager::s_budgets;
+template<typename T>
+ResourceFootprint ResourceManager::s_footprints;
 
 
 #endif  // RESOURCEMANAGER_H
@@ -1,38 +1,65 @@
 #ifndef RESOURCE_H
 #define RESOURCE_H
 
+#include "Identifier.h"
+
+#include <cstdint>
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 
 class ResourceManager;
 
 
+// The data is owned by the ResourceManager and only changed under its lock. The handles read it without locking,
+// through the raw pointer published along with it.
 template <typename T>
 struct Resource {
     std::shared_ptr<T> data;
+    std::atomic<T*> published{nullptr};
+    // Data replaced or released while handles could still be reading it, kept as long as the slot
+    std::vector<std::shared_ptr<T>> retired;
     bool hasOwner = false;  // Define whether this ressource can be removed on its own or if an other object will take care of it.
+    std::atomic<bool> pending{false};   // Still being streamed in, the data is only set once it has been fully loaded
+
+    // Incremented when the resource is freed, invalidating the handles still pointing to it
+    std::atomic<uint32_t> generation{0};
+
+    // Memory accounting, used by the ResourceManager to evict the least recently used resources
+    size_t cpuSize = 0;
+    size_t gpuSize = 0;
+    std::atomic<uint64_t> lastUsed{0};
 };
 
 
+// Handles point straight to the slot of their resource, accessing it doesn't go through the ResourceManager.
+// They keep the slot alive, a resource no handle points to can be evicted by the ResourceManager.
 template <typename T>
 class ResourceHandle {
 public:
     ResourceHandle() = default;
     
     std::shared_ptr<T> Get() const;
-    inline const std::string& GetIdentifier() const { return m_identifier; }
+    inline const ResourceId& GetId() const { return m_identifier; }
+    inline const std::string& GetIdentifier() const { return m_identifier.GetString(); }
 
-    inline operator bool() const { return !m_resource.expired(); }
+    // Pending handles are not valid until the resource has finished loading
+    inline operator bool() const { return IsAlive() && !m_resource->pending; }
+    inline bool IsPending() const { return IsAlive() && m_resource->pending; }
 
 private:
-    ResourceHandle(const std::string& identifier) :
+    ResourceHandle(const ResourceId& identifier) :
             m_identifier(identifier) {}
-    ResourceHandle(const std::string& identifier, const  std::weak_ptr<Resource<T>>& resource) :
-            m_resource(resource), m_identifier(identifier) {}
+    ResourceHandle(const ResourceId& identifier, const std::shared_ptr<Resource<T>>& resource) :
+            m_identifier(identifier), m_resource(resource), m_generation(resource->generation) {}
+
+    inline bool IsAlive() const { return m_resource && m_resource->generation == m_generation; }
 
-    std::string m_identifier;
-    std::weak_ptr<Resource<T>> m_resource;
+    ResourceId m_identifier;
+    std::shared_ptr<Resource<T>> m_resource;
+    uint32_t m_generation = 0;
 
     friend ResourceManager;
 };
@@ -41,9 +68,14 @@ private:
 template <typename T>
 std::shared_ptr<T> ResourceHandle<T>::Get() const
 {
-    if (auto resource = m_resource.lock())
+    if (IsAlive())
     {
-        return resource->data;
+        // The pointer returned shares the ownership of the slot, which keeps the data alive if it is replaced
+        T* data = m_resource->published.load(std::memory_order_acquire);
+        if (data)
+        {
+            return std::shared_ptr<T>(m_resource, data);
+        }
     }
 
     return nullptr;
@@ -0,0 +1,269 @@
+#include "Streamer.h"
+
+#include "Core/Logging.h"
+
+#include <algorithm>
+#include <limits>
+
+
+ResourceStreamer* ResourceStreamer::s_instance = nullptr;
+
+
+ResourceStreamer& ResourceStreamer::Init(const uint32_t& workerCount)
+{
+    if (ResourceStreamer::s_instance) {
+        LOG_WARNING("ResourceStreamer already exists, cannot Init() it twice.");
+        return *s_instance;
+    }
+
+    s_instance = new ResourceStreamer(workerCount);
+    return *s_instance;
+}
+
+ResourceStreamer::ResourceStreamer(const uint32_t& workerCount)
+{
+    for (uint32_t i = 0 ; i < workerCount ; ++i)
+    {
+        m_workers.emplace_back(&ResourceStreamer::WorkerLoop, this);
+    }
+}
+
+ResourceStreamer::~ResourceStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_decodeCondition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void ResourceStreamer::Submit(const StreamRequestPtr& request, const StreamCallback& callback)
+{
+    if (callback)
+    {
+        request->m_callbacks.push_back(callback);
+    }
+    m_requests.push_back(request);
+
+    // Without any worker the requests are decoded right away
+    if (m_workers.empty())
+    {
+        request->m_decodeSucceeded = request->Decode();
+        request->m_decoded = true;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decodeQueue.push_back(request);
+    }
+    m_decodeCondition.notify_one();
+}
+
+bool ResourceStreamer::AddCallback(const std::type_index& type, const ResourceId& identifier, const StreamCallback& callback)
+{
+    StreamRequestPtr request = FindRequest(type, identifier);
+    if (!request)
+    {
+        return false;
+    }
+
+    if (callback)
+    {
+        request->m_callbacks.push_back(callback);
+    }
+
+    return true;
+}
+
+void ResourceStreamer::OnUpdate()
+{
+    size_t budget = m_uploadBudget;
+
+    // Iterating over a copy since finishing a request can submit or complete other ones
+    std::vector<StreamRequestPtr> requests = m_requests;
+    for (const auto& request : requests)
+    {
+        if (!budget)
+        {
+            break;
+        }
+        if (request->m_finished)
+        {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!request->m_decoded)
+            {
+                continue;
+            }
+        }
+
+        Process(request, budget);
+    }
+}
+
+void ResourceStreamer::Complete(const std::type_index& type, const ResourceId& identifier)
+{
+    StreamRequestPtr request = FindRequest(type, identifier);
+    if (!request)
+    {
+        return;
+    }
+
+    WaitForDecode(request);
+    size_t budget = std::numeric_limits<size_t>::max();
+    if (Process(request, budget))
+    {
+        return;
+    }
+
+    // The request is waiting for other resources
+    Flush();
+}
+
+void ResourceStreamer::Flush()
+{
+    while (!m_requests.empty())
+    {
+        // A pass makes progress if a request finishes, uploads something or submits other requests
+        bool progress = false;
+        std::vector<StreamRequestPtr> requests = m_requests;
+        for (const auto& request : requests)
+        {
+            if (request->m_finished)
+            {
+                continue;
+            }
+
+            WaitForDecode(request);
+            size_t budget = std::numeric_limits<size_t>::max();
+            if (Process(request, budget) || budget != std::numeric_limits<size_t>::max())
+            {
+                progress = true;
+            }
+        }
+
+        for (const auto& request : m_requests)
+        {
+            if (std::find(requests.begin(), requests.end(), request) == requests.end() || request->WaitForWork())
+            {
+                progress = true;
+            }
+        }
+
+        // The remaining requests are waiting for resources that are still pending without being streamed in,
+        // or that failed to load
+        if (!progress)
+        {
+            requests = m_requests;
+            for (const auto& request : requests)
+            {
+                if (request->m_finished)
+                {
+                    continue;
+                }
+
+                LOG_ERROR("ResourceStreamer : Request %s is stuck waiting for its dependencies, dropping it.",
+                          request->m_identifier.GetString().c_str());
+                Retire(request, false);
+            }
+        }
+    }
+}
+
+void ResourceStreamer::WorkerLoop()
+{
+    while (true)
+    {
+        StreamRequestPtr request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_decodeCondition.wait(lock, [this]() { return m_stopping || !m_decodeQueue.empty(); });
+            if (m_stopping)
+            {
+                return;
+            }
+
+            request = m_decodeQueue.front();
+            m_decodeQueue.pop_front();
+        }
+
+        bool success = request->Decode();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            request->m_decoded = true;
+            request->m_decodeSucceeded = success;
+        }
+        m_decodedCondition.notify_all();
+    }
+}
+
+StreamRequestPtr ResourceStreamer::FindRequest(const std::type_index& type, const ResourceId& identifier) const
+{
+    for (const auto& request : m_requests)
+    {
+        if (request->m_type == type && request->m_identifier == identifier)
+        {
+            return request;
+        }
+    }
+
+    return nullptr;
+}
+
+void ResourceStreamer::WaitForDecode(const StreamRequestPtr& request)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (request->m_decoded)
+    {
+        return;
+    }
+
+    // Decoding the request on the calling thread rather than waiting for a worker to pick it up
+    auto it = std::find(m_decodeQueue.begin(), m_decodeQueue.end(), request);
+    if (it != m_decodeQueue.end())
+    {
+        m_decodeQueue.erase(it);
+        lock.unlock();
+        bool success = request->Decode();
+        lock.lock();
+
+        request->m_decoded = true;
+        request->m_decodeSucceeded = success;
+        return;
+    }
+
+    m_decodedCondition.wait(lock, [&request]() { return request->m_decoded; });
+}
+
+bool ResourceStreamer::Process(const StreamRequestPtr& request, size_t& budget)
+{
+    bool success = request->m_decodeSucceeded;
+    if (success && !request->Upload(budget))
+    {
+        return false;
+    }
+
+    Retire(request, success);
+    return true;
+}
+
+void ResourceStreamer::Retire(const StreamRequestPtr& request, const bool& success)
+{
+    request->m_finished = true;
+    m_requests.erase(std::remove(m_requests.begin(), m_requests.end(), request), m_requests.end());
+
+    request->Finish(success);
+    for (const auto& callback : request->m_callbacks)
+    {
+        callback();
+    }
+}
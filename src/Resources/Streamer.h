@@ -0,0 +1,113 @@
+#ifndef STREAMER_H
+#define STREAMER_H
+
+#include "Identifier.h"
+
+#include <condition_variable>
+#include <functional>
+#include <typeindex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+
+typedef std::function<void()> StreamCallback;
+
+
+// A resource being streamed in. The file I/O and decoding are done by Decode() on a worker thread
+// while everything touching OpenGL or the ResourceManager happens on the main thread.
+class StreamRequest
+{
+public:
+    StreamRequest(const ResourceId& identifier, const std::type_index& type) :
+            m_identifier(identifier), m_type(type) {}
+    virtual ~StreamRequest() = default;
+
+    // Worker thread, returns false if the resource could not be read
+    virtual bool Decode() = 0;
+    // Main thread, uploads the decoded data, consuming the given budget (in bytes).
+    // Called every frame until it returns true, at least one step is done if any budget is left.
+    virtual bool Upload(size_t& budget) = 0;
+    // Main thread, publishes the resource (or releases it if the request failed)
+    virtual void Finish(const bool& success) = 0;
+    // Main thread, blocks until the work started by Upload() outside of the streamer (jobs) is done.
+    // Returns false if there is none, a request that can't upload anything is then stuck (see Flush()).
+    virtual bool WaitForWork() { return false; }
+
+    inline const ResourceId& GetIdentifier() const { return m_identifier; }
+    inline const std::type_index& GetType() const { return m_type; }
+
+private:
+    ResourceId m_identifier;
+    std::type_index m_type;
+
+    // Guarded by the streamer mutex
+    bool m_decoded = false;
+    bool m_decodeSucceeded = false;
+
+    // Main thread only
+    bool m_finished = false;
+    std::vector<StreamCallback> m_callbacks;
+
+    friend class ResourceStreamer;
+};
+
+typedef std::shared_ptr<StreamRequest> StreamRequestPtr;
+
+
+class ResourceStreamer
+{
+public:
+    static ResourceStreamer& Init(const uint32_t& workerCount=2);
+    inline static ResourceStreamer& Get() { return *s_instance; }
+
+    void Submit(const StreamRequestPtr& request, const StreamCallback& callback=StreamCallback());
+    // Returns false if no request is pending for this resource
+    bool AddCallback(const std::type_index& type, const ResourceId& identifier, const StreamCallback& callback);
+
+    // Processes the decoded requests within the upload budget, to be called once per frame on the main thread
+    void OnUpdate();
+
+    // Blocks until the given resource has been fully loaded, regardless of the upload budget
+    void Complete(const std::type_index& type, const ResourceId& identifier);
+    // Blocks until every pending request has been fully loaded, the requests that stop making progress
+    // (waiting for resources that will never be loaded) are failed
+    void Flush();
+
+    inline bool IsIdle() const { return m_requests.empty(); }
+    inline size_t GetPendingCount() const { return m_requests.size(); }
+
+    // Amount of bytes uploaded to the GPU per frame
+    inline void SetUploadBudget(const size_t& budget) { m_uploadBudget = budget; }
+    inline size_t GetUploadBudget() const { return m_uploadBudget; }
+
+private:
+    ResourceStreamer(const uint32_t& workerCount);
+    ~ResourceStreamer();
+    ResourceStreamer(const ResourceStreamer&) = delete;
+
+    void WorkerLoop();
+    StreamRequestPtr FindRequest(const std::type_index& type, const ResourceId& identifier) const;
+    void WaitForDecode(const StreamRequestPtr& request);
+    bool Process(const StreamRequestPtr& request, size_t& budget);
+    void Retire(const StreamRequestPtr& request, const bool& success);
+
+    // Main thread only, in submission order
+    std::vector<StreamRequestPtr> m_requests;
+    size_t m_uploadBudget = 8 * 1024 * 1024;
+
+    std::vector<std::thread> m_workers;
+    std::deque<StreamRequestPtr> m_decodeQueue;
+    std::mutex m_mutex;
+    std::condition_variable m_decodeCondition;
+    std::condition_variable m_decodedCondition;
+    bool m_stopping = false;
+
+    static ResourceStreamer* s_instance;
+};
+
+
+#endif // STREAMER_H
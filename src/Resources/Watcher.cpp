@@ -0,0 +1,156 @@
+#include "Watcher.h"
+
+#include "Manager.h"
+
+#include "Core/Resolver.h"
+#include "Core/Logging.h"
+#include "Core/Time.h"
+
+#include <filesystem>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+
+ResourceWatcher* ResourceWatcher::s_instance = nullptr;
+
+
+ResourceWatcher& ResourceWatcher::Init(const std::string& directory, const double& debounceDelay)
+{
+    if (ResourceWatcher::s_instance) {
+        LOG_WARNING("ResourceWatcher already exists, cannot Init() it twice.");
+        return *s_instance;
+    }
+
+    s_instance = new ResourceWatcher(directory, debounceDelay);
+    return *s_instance;
+}
+
+ResourceWatcher::ResourceWatcher(const std::string& directory, const double& debounceDelay) :
+        m_debounceDelay(debounceDelay)
+{
+#ifdef __linux__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0)
+    {
+        LOG_ERROR("Could not initialize inotify, resources will not be reloaded when modified.");
+        return;
+    }
+
+    AddWatches(directory);
+#else
+    LOG_WARNING("Resource hot reloading is only supported on Linux.");
+#endif
+}
+
+ResourceWatcher::~ResourceWatcher()
+{
+#ifdef __linux__
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+    }
+#endif
+}
+
+void ResourceWatcher::AddCallback(const ReloadCallback& callback)
+{
+    m_callbacks.push_back(callback);
+}
+
+void ResourceWatcher::AddWatches(const std::string& directory)
+{
+#ifdef __linux__
+    int wd = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd < 0)
+    {
+        LOG_WARNING("Could not watch %s for modifications.", directory.c_str());
+        return;
+    }
+    m_directories[wd] = directory;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.is_directory())
+        {
+            AddWatches(entry.path().string());
+        }
+    }
+#endif
+}
+
+void ResourceWatcher::ReadEvents()
+{
+#ifdef __linux__
+    alignas(inotify_event) char buffer[4096];
+    while (true)
+    {
+        ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            return;
+        }
+
+        for (char* ptr = buffer ; ptr < buffer + length ; ptr += sizeof(inotify_event) + reinterpret_cast<inotify_event*>(ptr)->len)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+            if (event->mask & IN_IGNORED)
+            {
+                m_directories.erase(event->wd);
+                continue;
+            }
+
+            auto directory = m_directories.find(event->wd);
+            if (directory == m_directories.end() || !event->len)
+            {
+                continue;
+            }
+
+            std::string path = (std::filesystem::path(directory->second) / event->name).string();
+            if (event->mask & IN_ISDIR)
+            {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    AddWatches(path);
+                }
+            }
+            else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+            {
+                m_changes[path] = Time::GetTime();
+            }
+        }
+    }
+#endif
+}
+
+void ResourceWatcher::OnUpdate()
+{
+    if (!IsWatching())
+    {
+        return;
+    }
+
+    ReadEvents();
+
+    double time = Time::GetTime();
+    for (auto it = m_changes.begin() ; it != m_changes.end() ; )
+    {
+        if (time - it->second < m_debounceDelay)
+        {
+            ++it;
+            continue;
+        }
+
+        std::string identifier = Resolver::Get().AsIdentifier(it->first);
+        it = m_changes.erase(it);
+
+        ResourceManager::Reload(identifier);
+        for (const auto& callback : m_callbacks)
+        {
+            callback(identifier);
+        }
+    }
+}
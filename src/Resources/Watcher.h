@@ -0,0 +1,50 @@
+#ifndef WATCHER_H
+#define WATCHER_H
+
+#include <functional>
+#include <unordered_map>
+#include <string>
+#include <vector>
+
+
+// Called with the identifier of the modified files once the ResourceManager had a chance to reload them
+typedef std::function<void(const std::string&)> ReloadCallback;
+
+
+// Watches the resources directory (with inotify, only available on Linux) and reloads the resources
+// whose files have been modified. Changes are debounced so that saving a file several times in a row,
+// or writing it in several steps, only reloads it once.
+class ResourceWatcher
+{
+public:
+    static ResourceWatcher& Init(const std::string& directory, const double& debounceDelay=0.25);
+    inline static ResourceWatcher& Get() { return *s_instance; }
+
+    void AddCallback(const ReloadCallback& callback);
+
+    // Polls the file changes and reloads the files left untouched for the debounce delay, main thread only
+    void OnUpdate();
+
+    inline bool IsWatching() const { return m_fd >= 0; }
+
+private:
+    ResourceWatcher(const std::string& directory, const double& debounceDelay);
+    ~ResourceWatcher();
+    ResourceWatcher(const ResourceWatcher&) = delete;
+
+    void AddWatches(const std::string& directory);
+    void ReadEvents();
+
+    int m_fd = -1;
+    double m_debounceDelay;
+    // Watched directories by watch descriptor
+    std::unordered_map<int, std::string> m_directories;
+    // Time of the last change of each modified file
+    std::unordered_map<std::string, double> m_changes;
+    std::vector<ReloadCallback> m_callbacks;
+
+    static ResourceWatcher* s_instance;
+};
+
+
+#endif // WATCHER_H
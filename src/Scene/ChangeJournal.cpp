@@ -0,0 +1,77 @@
+#include "ChangeJournal.h"
+
+#include <algorithm>
+
+
+ChangeJournal::ChangeJournal(const size_t& capacity) :
+        m_entries(std::max(capacity, (size_t)1))
+{
+
+}
+
+ChangeJournal::~ChangeJournal()
+{
+
+}
+
+void ChangeJournal::NextTick()
+{
+    m_tick++;
+    m_writtenComponents.clear();
+}
+
+void ChangeJournal::ForEachChange(const uint64_t& tick, const std::function<void(const ChangeEntry&)>& callback) const
+{
+    for (size_t i = 0 ; i < m_count ; ++i)
+    {
+        const ChangeEntry& entry = m_entries[(m_head + i) % m_entries.size()];
+        if (entry.tick == tick)
+        {
+            callback(entry);
+        }
+        else if (entry.tick > tick)
+        {
+            break;
+        }
+    }
+}
+
+void ChangeJournal::Record(ChangeEntry&& entry)
+{
+    entry.tick = m_tick;
+    if (entry.type == ChangeType::WriteComponent || entry.type == ChangeType::AddComponent)
+    {
+        m_writtenComponents.insert(entry.after.get());
+    }
+
+    // Full, the oldest change is overwritten and its tick can't be rolled back anymore
+    if (m_count == m_entries.size())
+    {
+        ChangeEntry& oldest = m_entries[m_head];
+        m_oldestTick = std::max(m_oldestTick, oldest.tick + 1);
+        if (oldest.tick == m_tick)
+        {
+            // Its copy may be released and its address reused
+            m_writtenComponents.erase(oldest.after.get());
+        }
+        oldest = std::move(entry);
+        m_head = (m_head + 1) % m_entries.size();
+        return;
+    }
+
+    m_entries[(m_head + m_count) % m_entries.size()] = std::move(entry);
+    m_count++;
+}
+
+ChangeEntry ChangeJournal::PopLatest()
+{
+    ChangeEntry entry = std::move(m_entries[(m_head + m_count - 1) % m_entries.size()]);
+    m_count--;
+    return entry;
+}
+
+void ChangeJournal::Rewind(const uint64_t& tick)
+{
+    m_tick = tick;
+    m_writtenComponents.clear();
+}
@@ -0,0 +1,85 @@
+#ifndef CHANGEJOURNAL_H
+#define CHANGEJOURNAL_H
+
+#include "EntityIndex.h"
+
+#include <any>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <unordered_set>
+#include <vector>
+
+
+enum class ChangeType : uint8_t
+{
+    CreateEntity,
+    RemoveEntity,
+    SetData,
+    AddComponent,
+    WriteComponent,
+    RemoveComponent
+};
+
+struct ChangeEntry
+{
+    uint64_t tick;
+    ChangeType type;
+    uint32_t entity;
+
+    // Component before and after the change. Written components are copied the first time they are accessed
+    // in a tick: the copy is edited during the rest of the tick and left untouched afterwards.
+    std::shared_ptr<std::any> before;
+    std::shared_ptr<std::any> after;
+    // Components of a removed entity, or the ones replaced by SetData
+    EntityData data;
+    // Scripts of a removed entity, saved by the SceneSerializer to be created again (see Scene::RemoveEntity)
+    std::vector<uint8_t> scripts;
+};
+
+
+// Changes made to an EntityIndex, grouped by simulation tick and kept in a ring buffer: the oldest ticks are
+// dropped once it is full. Every mutable access to a component counts as a write. Polymorphic components
+// (the scripts) are tied to their entity, they are not journaled: only the scripts of the removed entities
+// are saved, rolling back creates them again.
+class ChangeJournal
+{
+public:
+    ChangeJournal(const size_t& capacity);
+    ~ChangeJournal();
+
+    // Called once the simulation step is over
+    void NextTick();
+    inline uint64_t GetCurrentTick() const { return m_tick; }
+    // First tick the journal can still roll back to, its changes have all been kept
+    inline uint64_t GetOldestTick() const { return m_oldestTick; }
+
+    inline size_t GetChangeCount() const { return m_count; }
+    // Changes of the given tick, in the order they were made
+    void ForEachChange(const uint64_t& tick, const std::function<void(const ChangeEntry&)>& callback) const;
+
+private:
+    void Record(ChangeEntry&& entry);
+    // Removes the last change, the caller undoes it
+    ChangeEntry PopLatest();
+    inline const ChangeEntry& GetLatest() const { return m_entries[(m_head + m_count - 1) % m_entries.size()]; }
+
+    // Components copied in the current tick, further writes to them don't need to be journaled
+    inline bool IsWritable(const std::any* component) const { return m_writtenComponents.count(component); }
+
+    // Goes back to the beginning of the given tick, the changes of the later ticks must have been undone
+    void Rewind(const uint64_t& tick);
+
+    std::vector<ChangeEntry> m_entries;
+    size_t m_head = 0;
+    size_t m_count = 0;
+
+    uint64_t m_tick = 0;
+    uint64_t m_oldestTick = 0;
+    std::unordered_set<const std::any*> m_writtenComponents;
+
+    friend class EntityIndex;
+};
+
+
+#endif  // CHANGEJOURNAL_H
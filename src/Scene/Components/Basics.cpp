@@ -13,7 +13,7 @@ glm::mat4 Transform::ComputeWorldMatrix(const Entity& entity)
     Entity parent = entity;
     while (parent)
     {
-        if (auto* transform = parent.FindComponent<Components::Transform>())
+        if (auto* transform = parent.ReadComponent<Components::Transform>())
         {
             result = transform->transform * result;
         }
@@ -23,4 +23,35 @@ glm::mat4 Transform::ComputeWorldMatrix(const Entity& entity)
     return result;
 }
 
+glm::mat4 Transform::ComputeInterpolatedWorldMatrix(const Entity& entity, const float& factor)
+{
+    glm::mat4 result = glm::mat4(1.0f);
+
+    Entity parent = entity;
+    while (parent)
+    {
+        if (auto* transform = parent.ReadComponent<Components::Transform>())
+        {
+            result = transform->GetInterpolated(factor) * result;
+        }
+        parent = parent.GetParent();
+    }
+
+    return result;
+}
+
+void Transform::SavePreviousTransforms(const ScenePtr& scene)
+{
+    scene->ForEachWith<Components::Transform>([](const Entity& entity)
+    {
+        // Only writing the moving transforms, writing the others would unshare the prefab ones
+        auto* transform = entity.ReadComponent<Components::Transform>();
+        if (transform->previousTransform != transform->transform)
+        {
+            auto& mutableTransform = entity.GetComponent<Components::Transform>();
+            mutableTransform.previousTransform = mutableTransform.transform;
+        }
+    });
+}
+
 }  // Namespace Components
\ No newline at end of file
@@ -11,6 +11,8 @@
 
 #include "Renderer/Camera.h"
 
+#include <glm/gtx/matrix_interpolation.hpp>
+
 #include <functional>
 #include <any>
 
@@ -21,16 +23,35 @@ namespace Components {
 struct Transform 
 {
     Transform() = default;
-    Transform(const glm::mat4& transform) : transform(transform) {}
+    Transform(const glm::mat4& transform) : transform(transform), previousTransform(transform) {}
 
     inline glm::vec3 GetSideVector() const  { return transform[0]; }
     inline glm::vec3 GetUpVector() const    { return transform[1]; }
     inline glm::vec3 GetFrontVector() const { return transform[2]; }
     inline glm::vec3 GetPosition() const    { return transform[3]; }   
 
+    // Moves to the given transform without blending from the previous one
+    inline void Teleport(const glm::mat4& matrix)
+    {
+        transform = matrix;
+        previousTransform = matrix;
+    }
+
+    // Transform blended between the last two simulation steps, factor 0 being the previous one
+    inline glm::mat4 GetInterpolated(const float& factor) const
+    {
+        return transform == previousTransform ? transform : glm::interpolate(previousTransform, transform, factor);
+    }
+
     static glm::mat4 ComputeWorldMatrix(const Entity& entity);
+    static glm::mat4 ComputeInterpolatedWorldMatrix(const Entity& entity, const float& factor);
+
+    // Called before every simulation step, the transforms that did not move are left untouched
+    static void SavePreviousTransforms(const ScenePtr& scene);
 
     glm::mat4 transform{1.0f};
+    // State at the end of the previous simulation step
+    glm::mat4 previousTransform{1.0f};
 };
 
 
@@ -4,6 +4,9 @@
 #include <glm/glm.hpp>
 
 
+namespace Components {
+
+
 struct PointLight
 {
     PointLight() = default;
@@ -16,4 +19,7 @@ struct PointLight
 };
 
 
+} // Namespace Components
+
+
 #endif  // LIGHTCOMPONENTS_H
@@ -12,7 +12,7 @@ Entity Entity::GetParent() const
 
 std::vector<Entity> Entity::GetChildren() const 
 {
-    const auto& hierarchy = GetComponent<HierarchyComponent>();
+    const auto& hierarchy = *ReadComponent<HierarchyComponent>();
     if (!hierarchy.firstChild)
     {
         return {};
@@ -24,7 +24,7 @@ std::vector<Entity> Entity::GetChildren() const
     children.push_back(child);
     for (size_t i=0 ; i < hierarchy.childCount - 1 ; i++)
     {
-        child = Entity(child.GetComponent<HierarchyComponent>().nextSibling, m_scene);
+        child = Entity(child.ReadComponent<HierarchyComponent>()->nextSibling, m_scene);
         children.push_back(child);
     }
     
@@ -33,7 +33,7 @@ std::vector<Entity> Entity::GetChildren() const
 
 Entity Entity::FindChild(const std::string& name) const
 {
-    const auto& hierarchy = GetComponent<HierarchyComponent>();
+    const auto& hierarchy = *ReadComponent<HierarchyComponent>();
     if (hierarchy.firstChild)
     {
         Entity child = Entity(hierarchy.firstChild, m_scene);
@@ -44,7 +44,7 @@ Entity Entity::FindChild(const std::string& name) const
 
         for (size_t i=0 ; i < hierarchy.childCount - 1 ; i++)
         {
-            child = Entity(child.GetComponent<HierarchyComponent>().nextSibling, m_scene);
+            child = Entity(child.ReadComponent<HierarchyComponent>()->nextSibling, m_scene);
             if (child.GetName() == name)
             {
                 return child;
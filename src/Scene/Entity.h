@@ -40,6 +40,12 @@ public:
         return m_scene->m_index.FindComponent<ComponentType>(m_id);
     }
 
+    // Unlike the accessors above, never copies a component shared with a prefab (see EntityIndex)
+    template<typename ComponentType>
+    const ComponentType* ReadComponent() const {
+        return m_scene->m_index.ReadComponent<ComponentType>(m_id);
+    }
+
     bool IsValid() const;
     bool IsRoot() const;
     
@@ -59,10 +65,23 @@ private:
 
     friend Scene;
     friend class EntityView;
+    friend class SceneSerializer;
+    friend class SnapshotWriter;
+    friend class SnapshotReader;
     friend std::hash<Entity>;
 };
 
 
+template<typename ComponentType, typename Function>
+void Scene::ForEachWith(const Function& function)
+{
+    for (const uint32_t& id : m_index.GetIdsWith<ComponentType>())
+    {
+        function(Entity(id, this));
+    }
+}
+
+
 // Mandatory to define unordered_maps with Entity as keys
 template <>
 struct std::hash<Entity>
@@ -1,18 +1,20 @@
 #include "EntityIndex.h"
+#include "ChangeJournal.h"
 
 #include "Core/Logging.h"
 
 #include <random>
 
 // Very (very) basic UUID system based on a random seed and a random increment each time an entity is created.
-static std::random_device uuidRandomGenerator;
-static std::uniform_int_distribution<uint32_t> nextUuidDistrib(1, 1024);
+// Every index draws its ids from its own generator, so that scenes built on other threads don't change them.
+static uint32_t s_uuidSeed = std::random_device()();
 
 
-EntityIndex::EntityIndex()
+EntityIndex::EntityIndex() :
+        m_uuidGenerator(s_uuidSeed)
 {
     std::uniform_int_distribution<uint32_t> dist(1, UINT32_MAX);
-    m_last_uuid = dist(uuidRandomGenerator);
+    m_last_uuid = dist(m_uuidGenerator);
 }
 
 EntityIndex::~EntityIndex()
@@ -22,17 +24,39 @@ EntityIndex::~EntityIndex()
 
 uint32_t EntityIndex::CreateId()
 {
-    m_last_uuid += nextUuidDistrib(uuidRandomGenerator);
+    std::uniform_int_distribution<uint32_t> nextUuidDistrib(1, 1024);
+    m_last_uuid += nextUuidDistrib(m_uuidGenerator);
     m_dataMap.insert({m_last_uuid, {}});
+    m_structureVersion++;
+
+    if (m_journal)
+    {
+        m_journal->Record({0, ChangeType::CreateEntity, m_last_uuid});
+    }
 
     return m_last_uuid;
 }
 
-void EntityIndex::RemoveId(const uint32_t& entity)
+void EntityIndex::RemoveId(const uint32_t& entity, const std::vector<uint8_t>& scripts)
 {
     auto it = m_dataMap.find(entity);
     if (it != m_dataMap.end()) {
+        if (m_journal)
+        {
+            // The scripts are destroyed with the entity, only their serialized form is kept
+            ChangeEntry entry{0, ChangeType::RemoveEntity, entity};
+            for (const auto& slot : it->second)
+            {
+                if (slot.isShareable)
+                {
+                    entry.data.push_back(slot);
+                }
+            }
+            entry.scripts = scripts;
+            m_journal->Record(std::move(entry));
+        }
         m_dataMap.erase(it);
+        m_structureVersion++;
     }
 }
 
@@ -44,12 +68,169 @@ bool EntityIndex::ContainsId(const uint32_t& entity) const
 
 void EntityIndex::Clear() {
     m_dataMap.clear();
+    m_structureVersion++;
+    m_journal.reset();
 }
 
 void EntityIndex::SetData(const uint32_t& entity, const EntityData& data)
 {
     auto it = m_dataMap.find(entity);
     if (it != m_dataMap.end()) {
+        if (m_journal)
+        {
+            ChangeEntry entry{0, ChangeType::SetData, entity};
+            entry.data = it->second;
+            m_journal->Record(std::move(entry));
+        }
         it->second = data;
+        m_structureVersion++;
+        for (auto& slot : it->second)
+        {
+            if (!slot.isShareable)
+            {
+                slot.data = std::make_shared<std::any>(*slot.data);
+            }
+        }
+    }
+}
+
+std::any& EntityIndex::Detach(const uint32_t& entity, ComponentSlot& slot)
+{
+    // The journal keeps the previous state of the component, the slot gets the copy that is written
+    if (m_journal && slot.isShareable)
+    {
+        // Copies made during the current tick are only referenced by the slot and by the journal
+        if (!m_journal->IsWritable(slot.data.get()) || slot.data.use_count() > 2)
+        {
+            ChangeEntry entry{0, ChangeType::WriteComponent, entity, slot.data};
+            slot.data = std::make_shared<std::any>(*slot.data);
+            entry.after = slot.data;
+            m_journal->Record(std::move(entry));
+        }
+
+        return *slot.data;
+    }
+
+    if (slot.IsShared())
+    {
+        slot.data = std::make_shared<std::any>(*slot.data);
+    }
+
+    return *slot.data;
+}
+
+void EntityIndex::SetUuidSeed(const uint32_t& seed)
+{
+    s_uuidSeed = seed;
+}
+
+uint32_t EntityIndex::GetUuidSeed()
+{
+    return s_uuidSeed;
+}
+
+void EntityIndex::EnableJournal(const size_t& capacity)
+{
+    m_journal = std::make_unique<ChangeJournal>(capacity);
+}
+
+void EntityIndex::DisableJournal()
+{
+    m_journal.reset();
+}
+
+void EntityIndex::RecordAddComponent(const uint32_t& entity, const ComponentSlot& slot)
+{
+    if (slot.isShareable)
+    {
+        m_journal->Record({0, ChangeType::AddComponent, entity, nullptr, slot.data});
+    }
+}
+
+void EntityIndex::RecordRemoveComponent(const uint32_t& entity, const ComponentSlot& slot)
+{
+    if (slot.isShareable)
+    {
+        m_journal->Record({0, ChangeType::RemoveComponent, entity, slot.data});
+    }
+}
+
+bool EntityIndex::Rollback(const uint64_t& tick, std::vector<std::pair<uint32_t, std::vector<uint8_t>>>& outScripts)
+{
+    if (!m_journal || tick < m_journal->GetOldestTick())
+    {
+        return false;
+    }
+
+    // Undoing the changes in reverse order without journaling them
+    std::unique_ptr<ChangeJournal> journal = std::move(m_journal);
+    while (journal->GetChangeCount() && journal->GetLatest().tick >= tick)
+    {
+        ChangeEntry entry = journal->PopLatest();
+        Undo(entry, outScripts);
+    }
+    journal->Rewind(tick);
+    m_journal = std::move(journal);
+    m_structureVersion++;
+
+    return true;
+}
+
+void EntityIndex::Undo(ChangeEntry& entry, std::vector<std::pair<uint32_t, std::vector<uint8_t>>>& outScripts)
+{
+    auto it = m_dataMap.find(entry.entity);
+    switch (entry.type)
+    {
+        case ChangeType::CreateEntity:
+            if (it != m_dataMap.end())
+            {
+                m_dataMap.erase(it);
+            }
+            break;
+
+        case ChangeType::RemoveEntity:
+            m_dataMap[entry.entity] = entry.data;
+            if (!entry.scripts.empty())
+            {
+                outScripts.push_back({entry.entity, std::move(entry.scripts)});
+            }
+            break;
+
+        case ChangeType::SetData:
+            if (it != m_dataMap.end())
+            {
+                it->second = entry.data;
+            }
+            break;
+
+        case ChangeType::AddComponent:
+        case ChangeType::WriteComponent:
+            if (it == m_dataMap.end())
+            {
+                break;
+            }
+            for (auto slot = it->second.begin() ; slot != it->second.end() ; ++slot)
+            {
+                if (slot->data == entry.after)
+                {
+                    if (entry.type == ChangeType::AddComponent)
+                    {
+                        it->second.erase(slot);
+                    }
+                    else
+                    {
+                        slot->data = entry.before;
+                    }
+                    break;
+                }
+            }
+            break;
+
+        case ChangeType::RemoveComponent:
+            if (it != m_dataMap.end())
+            {
+                it->second.push_back({entry.before, true});
+            }
+            break;
     }
 }
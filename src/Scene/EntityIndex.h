@@ -5,12 +5,38 @@
 #include <unordered_map>
 #include <vector>
 #include <any>
+#include <memory>
+#include <random>
 #include <stdexcept>
+#include <typeindex>
+#include <type_traits>
 
 
-typedef std::vector<std::any> EntityData;
+// Components are stored behind shared pointers so that copying an entity (instancing a prefab) shares
+// them with the source instead of copying them. They are copied on write: any mutable access to a
+// component that is still shared gives the entity its own copy first. Polymorphic components (the
+// scripts) are tied to their entity, they are always copied with it.
+class Entity;
+
+// Moves a component tied to its entity over to a copy of that entity (see Scene::CopyEntity)
+typedef void (*RebindComponentFn)(std::any& component, const Entity& entity);
+
+struct ComponentSlot
+{
+    std::shared_ptr<std::any> data;
+    bool isShareable = true;
+    // Set for the components that have a Rebind(const Entity&) method
+    RebindComponentFn rebind = nullptr;
+
+    inline bool IsShared() const { return data.use_count() > 1; }
+};
+
+typedef std::vector<ComponentSlot> EntityData;
 typedef std::unordered_map<uint32_t, EntityData> EntityDataMap;
 
+class ChangeJournal;
+struct ChangeEntry;
+
 class EntityIndex
 {
 public:
@@ -20,9 +46,14 @@ public:
     // Entity management
 
     uint32_t CreateId();
-    void RemoveId(const uint32_t& entity);
+    // The scripts of the entity can be given in their serialized form, to be restored if the removal is rolled back
+    void RemoveId(const uint32_t& entity, const std::vector<uint8_t>& scripts={});
     bool ContainsId(const uint32_t& entity) const;
     void Clear();
+
+    // Seed of the ids of the indices created from now on, the same seed gives the same ids in the same order
+    static void SetUuidSeed(const uint32_t& seed);
+    static uint32_t GetUuidSeed();
     
     // ComponentType management
 
@@ -35,16 +66,23 @@ public:
             throw std::runtime_error("Access was made to a non-existing entity !");
         }
 
-        for (auto& cmp : it->second) 
+        for (auto& slot : it->second) 
         {
-            if (cmp.type() == typeid(ComponentType)) 
+            if (slot.data->type() == typeid(ComponentType)) 
             {
-                return std::any_cast<ComponentType&>(cmp);
+                return std::any_cast<ComponentType&>(Detach(entity, slot));
             }
         }
 
-        it->second.push_back(std::make_any<ComponentType>(std::forward<Args>(args)...));
-        return std::any_cast<ComponentType&>(it->second.back());
+        it->second.push_back({std::make_shared<std::any>(std::in_place_type<ComponentType>, std::forward<Args>(args)...),
+                              !std::is_polymorphic_v<ComponentType>,
+                              GetRebindFn<ComponentType>()});
+        m_structureVersion++;
+        if (m_journal)
+        {
+            RecordAddComponent(entity, it->second.back());
+        }
+        return std::any_cast<ComponentType&>(*it->second.back().data);
     }
 
     template<typename ComponentType>
@@ -56,11 +94,11 @@ public:
             throw std::runtime_error("Access was made to a non-existing entity !");
         }
 
-        for (auto& cmp : it->second) 
+        for (auto& slot : it->second) 
         {
-            if (cmp.type() == typeid(ComponentType)) 
+            if (slot.data->type() == typeid(ComponentType)) 
             {
-                return std::any_cast<ComponentType&>(cmp);
+                return std::any_cast<ComponentType&>(Detach(entity, slot));
             }
         }
 
@@ -76,11 +114,32 @@ public:
             return nullptr;
         }
 
-        for (auto& cmp : it->second) 
+        for (auto& slot : it->second) 
         {
-            if (cmp.type() == typeid(ComponentType)) 
+            if (slot.data->type() == typeid(ComponentType)) 
             {
-                return &std::any_cast<ComponentType&>(cmp);
+                return &std::any_cast<ComponentType&>(Detach(entity, slot));
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Read only access, never copies a shared component. Safe to call from several threads at once.
+    template<typename ComponentType>
+    const ComponentType* ReadComponent(const uint32_t& entity) const
+    {
+        auto it = m_dataMap.find(entity);
+        if (it == m_dataMap.end()) 
+        {
+            return nullptr;
+        }
+
+        for (const auto& slot : it->second) 
+        {
+            if (slot.data->type() == typeid(ComponentType)) 
+            {
+                return &std::any_cast<const ComponentType&>(*slot.data);
             }
         }
 
@@ -99,9 +158,14 @@ public:
         auto& cmpVector = it->second;
         for (auto cmpIt = cmpVector.begin() ; cmpIt != cmpVector.end() ; )
         {
-            if (cmpIt->type() == typeid(ComponentType)) 
+            if (cmpIt->data->type() == typeid(ComponentType)) 
             {
-                cmpVector.erase(cmpIt);
+                if (m_journal)
+                {
+                    RecordRemoveComponent(entity, *cmpIt);
+                }
+                cmpIt = cmpVector.erase(cmpIt);
+                m_structureVersion++;
             }
             else
             {
@@ -110,15 +174,92 @@ public:
         }
     }
 
+    // Ids of the entities holding a component of the given type, rebuilt only after entities or components
+    // have been added or removed
+    template<typename ComponentType>
+    const std::vector<uint32_t>& GetIdsWith()
+    {
+        IdCache& cache = m_idCaches[typeid(ComponentType)];
+        if (cache.version != m_structureVersion)
+        {
+            cache.ids.clear();
+            for (const auto& [entity, data] : m_dataMap)
+            {
+                for (const auto& slot : data)
+                {
+                    if (slot.data->type() == typeid(ComponentType))
+                    {
+                        cache.ids.push_back(entity);
+                        break;
+                    }
+                }
+            }
+            cache.version = m_structureVersion;
+        }
+
+        return cache.ids;
+    }
+
     bool HasData(const uint32_t& entity) { return m_dataMap.find(entity) != m_dataMap.end(); }
-    EntityData& GetData(const uint32_t& entity) { return m_dataMap.find(entity)->second; }
+    // The data returned can be changed freely, the cached ids are rebuilt
+    EntityData& GetData(const uint32_t& entity) { m_structureVersion++; return m_dataMap.find(entity)->second; }
+    // Reading only, the entities can be copied from a scene read by several threads at once
+    const EntityData& GetData(const uint32_t& entity) const { return m_dataMap.find(entity)->second; }
+    // Shares the components of the given data, the components that can't be shared are copied
     void SetData(const uint32_t& entity, const EntityData& data);
 
-    EntityDataMap& GetDataMap() { return m_dataMap; }
+    EntityDataMap& GetDataMap() { m_structureVersion++; return m_dataMap; }
+
+    // Change journal, disabled by default and by Clear() (see ChangeJournal)
+
+    void EnableJournal(const size_t& capacity);
+    void DisableJournal();
+    inline ChangeJournal* GetJournal() const { return m_journal.get(); }
+    // Undoes the changes made since the beginning of the given tick, fails if the journal does not go back that far.
+    // The scripts given when removing the entities brought back are returned, they have to be created again.
+    bool Rollback(const uint64_t& tick, std::vector<std::pair<uint32_t, std::vector<uint8_t>>>& outScripts);
 
 private:
+    template<typename ComponentType, typename = void>
+    struct HasRebind : std::false_type {};
+    template<typename ComponentType>
+    struct HasRebind<ComponentType, std::void_t<decltype(std::declval<ComponentType&>().Rebind(std::declval<const Entity&>()))>> : std::true_type {};
+
+    template<typename ComponentType>
+    static RebindComponentFn GetRebindFn()
+    {
+        if constexpr (HasRebind<ComponentType>::value)
+        {
+            return [](std::any& component, const Entity& entity) { std::any_cast<ComponentType&>(component).Rebind(entity); };
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+    // Gives the slot its own copy of the component if it is shared, or if its previous state has to be journaled
+    std::any& Detach(const uint32_t& entity, ComponentSlot& slot);
+
+    void RecordAddComponent(const uint32_t& entity, const ComponentSlot& slot);
+    void RecordRemoveComponent(const uint32_t& entity, const ComponentSlot& slot);
+    void Undo(ChangeEntry& entry, std::vector<std::pair<uint32_t, std::vector<uint8_t>>>& outScripts);
+
+    struct IdCache
+    {
+        uint64_t version = 0;
+        std::vector<uint32_t> ids;
+    };
+
+    std::minstd_rand m_uuidGenerator;
     uint32_t m_last_uuid = 0;
     EntityDataMap m_dataMap;
+
+    // Incremented each time entities or components are added or removed
+    uint64_t m_structureVersion = 1;
+    std::unordered_map<std::type_index, IdCache> m_idCaches;
+
+    std::unique_ptr<ChangeJournal> m_journal;
 };
 
 
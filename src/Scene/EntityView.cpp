@@ -11,7 +11,7 @@ EntityView::EntityView(const Entity& entity) :
 {
     if (!entity.IsRoot())  // If being Entity is root
     {
-        m_end = iterator(entity.GetComponent<HierarchyComponent>().nextSibling, entity.m_scene);
+        m_end = iterator(entity.ReadComponent<HierarchyComponent>()->nextSibling, entity.m_scene);
     }
 }
 
@@ -23,7 +23,7 @@ EntityView::EntityView(const uint32_t& beginId, const uint32_t& endId, Scene* sc
     // If being Entity is not the root, set the end point to its next sibling
     if (!entity.IsRoot())
     {
-        m_end = iterator(entity.GetComponent<HierarchyComponent>().nextSibling, scene);
+        m_end = iterator(entity.ReadComponent<HierarchyComponent>()->nextSibling, scene);
     }
 }
 
@@ -40,7 +40,7 @@ Entity EntityView::iterator::operator*() const
 EntityView::iterator& EntityView::iterator::operator++()
 {
     Entity entity(m_id, m_scene);
-    const auto& hierarchy = entity.GetComponent<HierarchyComponent>();
+    const auto& hierarchy = *entity.ReadComponent<HierarchyComponent>();
     if (hierarchy.firstChild)
     {
         m_id = hierarchy.firstChild;
@@ -54,7 +54,7 @@ EntityView::iterator& EntityView::iterator::operator++()
 
     while (entity = entity.GetParent())
     {
-        const auto& parentHierarchy = entity.GetComponent<HierarchyComponent>();
+        const auto& parentHierarchy = *entity.ReadComponent<HierarchyComponent>();
         if (parentHierarchy.nextSibling)
         {
             m_id = parentHierarchy.nextSibling;
@@ -1,10 +1,12 @@
 #include "Scene.h"
 
 #include "Entity.h"
+#include "SceneSerializer.h"
 
 #include "Core/Logging.h"
 
 #include <iostream>
+#include <utility>
 
 
 Scene::Scene()
@@ -75,9 +77,19 @@ Entity Scene::CopyEntity(const Entity& source, const std::string& name, const En
 
 uint32_t Scene::CopyEntity(const Entity& source, const uint32_t& parent, const uint32_t& nextSibling) 
 {
-    // Create new Entity and copy the source data into it
+    // Create new Entity sharing the source components, they are only copied once modified
     uint32_t newEntity = m_index.CreateId();
-    m_index.SetData(newEntity, source.m_scene->m_index.GetData(source.m_id));
+    m_index.SetData(newEntity, std::as_const(source.m_scene->m_index).GetData(source.m_id));
+
+    // The scripts have been copied along with the entity they were attached to, they move to the new one
+    Entity entity(newEntity, this);
+    for (ComponentSlot& slot : m_index.GetData(newEntity))
+    {
+        if (slot.rebind)
+        {
+            slot.rebind(*slot.data, entity);
+        }
+    }
 
     // Reinitialize hierarchy (since the ids will be different)
     auto& hierarchy = m_index.GetComponent<HierarchyComponent>(newEntity);
@@ -123,7 +135,13 @@ void Scene::RemoveEntity(Entity& entity)
 
     for (auto& descendant : descendants)
     {
-        m_index.RemoveId(entity.m_id);
+        // The scripts are not journaled, they are saved to be created again if the removal is rolled back
+        std::vector<uint8_t> scripts;
+        if (m_index.GetJournal())
+        {
+            SceneSerializer::SaveScripts(descendant, scripts);
+        }
+        m_index.RemoveId(descendant.m_id, scripts);
     }
 
     entity.m_id = 0;
@@ -131,7 +149,7 @@ void Scene::RemoveEntity(Entity& entity)
 
 std::string Scene::GetEntityName(const uint32_t& id)
 {
-    return m_index.GetComponent<BaseComponent>(id).name;
+    return m_index.ReadComponent<BaseComponent>(id)->name;
 }
 
 uint32_t Scene::GetEntityParent(const uint32_t& id) 
@@ -139,7 +157,7 @@ uint32_t Scene::GetEntityParent(const uint32_t& id)
     if (id == m_rootId)
         return Entity();
 
-    return m_index.GetComponent<HierarchyComponent>(id).parent;
+    return m_index.ReadComponent<HierarchyComponent>(id)->parent;
 }
 
 Entity Scene::FindByName(const std::string& name)
@@ -171,6 +189,31 @@ Entity Scene::GetMainCamera()
     return Entity(m_mainCamera, this);
 }
 
+void Scene::EnableJournal(const size_t& capacity)
+{
+    m_index.EnableJournal(capacity);
+}
+
+bool Scene::Rollback(const uint64_t& tick)
+{
+    std::vector<std::pair<uint32_t, std::vector<uint8_t>>> scripts;
+    if (!m_index.Rollback(tick, scripts))
+    {
+        return false;
+    }
+
+    // Created once every entity is back, the scripts may refer to other entities
+    for (const auto& [entity, data] : scripts)
+    {
+        if (m_index.ContainsId(entity))
+        {
+            SceneSerializer::LoadScripts(Entity(entity, this), data);
+        }
+    }
+
+    return true;
+}
+
 void Scene::Clear()
 {
     m_index.Clear();
@@ -59,10 +59,20 @@ public:
     void Clear();
 
     EntityView Traverse();
+    // Calls the function on every entity holding a component of the given type, in no particular order
+    template<typename ComponentType, typename Function>
+    void ForEachWith(const Function& function);
 
     void SetMainCamera(const Entity& entity);
     Entity GetMainCamera();
 
+    // Records the changes made to the entities from now on, see ChangeJournal
+    void EnableJournal(const size_t& capacity);
+    inline ChangeJournal* GetJournal() const { return m_index.GetJournal(); }
+    // Restores the entities and their data as they were at the beginning of the given tick.
+    // The data blocks of the scripts are not journaled, only the scripts of the removed entities are recreated.
+    bool Rollback(const uint64_t& tick=0);
+
     static ScenePtr Create();
 
 private:
@@ -82,6 +92,7 @@ private:
 
     friend Entity;
     friend EntityView;
+    friend class SceneSerializer;
 };
 
 #endif  // SCENE_H
\ No newline at end of file
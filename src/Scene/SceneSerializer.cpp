@@ -0,0 +1,441 @@
+#include "SceneSerializer.h"
+
+#include "Components/Basics.h"
+#include "Components/Lights.h"
+
+#include "Utils/FileUtils.h"
+
+
+std::unordered_map<std::type_index, SceneSerializer::ComponentSerializer> SceneSerializer::s_serializers;
+std::unordered_map<std::string, std::type_index> SceneSerializer::s_serializerTypes;
+
+
+// == SnapshotWriter ==
+
+void SnapshotWriter::WriteString(const std::string& string)
+{
+    Write<uint32_t>(string.size());
+    m_data.insert(m_data.end(), string.begin(), string.end());
+}
+
+void SnapshotWriter::WriteEntity(const Entity& entity)
+{
+    uint32_t index = SCENE_SNAPSHOT_NO_ENTITY;
+    if (entity.GetScene() == m_scene && !m_entityIndices)
+    {
+        index = entity.m_id;
+    }
+    else if (entity.GetScene() == m_scene)
+    {
+        auto it = m_entityIndices->find(entity.m_id);
+        if (it != m_entityIndices->end())
+        {
+            index = it->second;
+        }
+    }
+
+    Write(index);
+}
+
+
+// == SnapshotReader ==
+
+bool SnapshotReader::Check(const size_t& size)
+{
+    if (m_failed || size > m_size - m_offset)
+    {
+        m_failed = true;
+    }
+
+    return !m_failed;
+}
+
+std::string SnapshotReader::ReadString()
+{
+    uint32_t size = Read<uint32_t>();
+    if (!Check(size))
+    {
+        return "";
+    }
+
+    std::string string(reinterpret_cast<const char*>(m_data + m_offset), size);
+    m_offset += size;
+    return string;
+}
+
+Entity SnapshotReader::ReadEntity()
+{
+    uint32_t index = Read<uint32_t>();
+    if (!m_entities)
+    {
+        return index && index != SCENE_SNAPSHOT_NO_ENTITY ? Entity(index, m_scene) : Entity();
+    }
+
+    return index < m_entities->size() ? (*m_entities)[index] : Entity();
+}
+
+
+// == SceneSerializer ==
+
+void SceneSerializer::Init()
+{
+    RegisterTrivial<Components::Transform>("Transform");
+    RegisterTrivial<Components::PointLight>("PointLight");
+
+    Register<Components::Camera>("Camera",
+        [](const Components::Camera& component, SnapshotWriter& writer)
+        {
+            writer.Write(component.camera.GetFov());
+            writer.Write(component.camera.GetAspectRatio());
+            writer.Write(component.camera.GetNearClip());
+            writer.Write(component.camera.GetFarClip());
+        },
+        [](const Entity& entity, SnapshotReader& reader)
+        {
+            float fov = reader.Read<float>();
+            float aspectRatio = reader.Read<float>();
+            float nearClip = reader.Read<float>();
+            float farClip = reader.Read<float>();
+            entity.EmplaceComponent<Components::Camera>(::Camera(fov, aspectRatio, nearClip, farClip));
+        });
+
+    Register<Components::Mesh>("Mesh",
+        [](const Components::Mesh& component, SnapshotWriter& writer) { writer.WriteResource(component.mesh); },
+        [](const Entity& entity, SnapshotReader& reader) { entity.EmplaceComponent<Components::Mesh>(reader.ReadResource<::Mesh>()); });
+
+    Register<Components::RenderMesh>("RenderMesh",
+        [](const Components::RenderMesh& component, SnapshotWriter& writer)
+        {
+            writer.WriteResource(component.material);
+            writer.Write(component.doubleSided);
+        },
+        [](const Entity& entity, SnapshotReader& reader)
+        {
+            ResourceHandle<Material> material = reader.ReadResource<Material>();
+            bool doubleSided = reader.Read<bool>();
+            entity.EmplaceComponent<Components::RenderMesh>(material, doubleSided);
+        });
+
+    Register<Components::RenderImage>("RenderImage",
+        [](const Components::RenderImage& component, SnapshotWriter& writer) { writer.WriteResource(component.image); },
+        [](const Entity& entity, SnapshotReader& reader) { entity.EmplaceComponent<Components::RenderImage>(reader.ReadResource<Texture>()); });
+}
+
+bool SceneSerializer::Save(const ScenePtr& scene, SceneSnapshot& outSnapshot)
+{
+    outSnapshot.resources.clear();
+    return Save(scene, outSnapshot.data, &outSnapshot.resources);
+}
+
+bool SceneSerializer::Save(const ScenePtr& scene, const std::string& path)
+{
+    std::vector<uint8_t> data;
+    if (!Save(scene, data, nullptr))
+    {
+        return false;
+    }
+
+    if (!WriteFile(path, data.data(), data.size()))
+    {
+        LOG_ERROR("Could not write the scene snapshot %s", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool SceneSerializer::Save(const ScenePtr& scene, std::vector<uint8_t>& outData, std::vector<std::any>* outResources)
+{
+    if (!scene)
+    {
+        return false;
+    }
+
+    std::vector<Entity> entities;
+    std::unordered_map<uint32_t, uint32_t> entityIndices;
+    for (Entity entity : scene->Traverse())
+    {
+        entityIndices[entity.m_id] = entities.size();
+        entities.push_back(entity);
+    }
+
+    // The components are written first, the type table only holds the types that have been met
+    std::vector<uint8_t> records;
+    std::vector<const ComponentSerializer*> types;
+    std::unordered_map<std::type_index, uint32_t> typeIndices;
+    std::unordered_map<const std::any*, uint32_t> sharedRecords;
+    uint32_t recordCount = 0;
+
+    auto patch = [&records](const size_t& offset, const uint32_t& value)
+    {
+        std::memcpy(records.data() + offset, &value, sizeof(uint32_t));
+    };
+
+    SnapshotWriter writer(records, &entityIndices, scene.get(), outResources);
+    for (const Entity& entity : entities)
+    {
+        size_t countOffset = records.size();
+        uint32_t count = 0;
+        writer.Write(count);
+
+        for (const ComponentSlot& slot : scene->m_index.GetData(entity.m_id))
+        {
+            std::type_index type(slot.data->type());
+            auto serializer = s_serializers.find(type);
+            if (serializer == s_serializers.end())
+            {
+                continue;
+            }
+
+            auto typeIndex = typeIndices.emplace(type, (uint32_t)types.size());
+            if (typeIndex.second)
+            {
+                types.push_back(&serializer->second);
+            }
+            count++;
+
+            auto shared = sharedRecords.find(slot.data.get());
+            if (shared != sharedRecords.end())
+            {
+                writer.Write<uint32_t>(SCENE_SNAPSHOT_SHARED);
+                writer.Write<uint32_t>(sizeof(uint32_t));
+                writer.Write(shared->second);
+                continue;
+            }
+
+            if (slot.isShareable && slot.IsShared())
+            {
+                sharedRecords[slot.data.get()] = recordCount;
+            }
+            recordCount++;
+
+            writer.Write(typeIndex.first->second);
+            size_t sizeOffset = records.size();
+            writer.Write<uint32_t>(0);
+
+            serializer->second.write(*slot.data, writer);
+            patch(sizeOffset, records.size() - sizeOffset - sizeof(uint32_t));
+        }
+
+        patch(countOffset, count);
+    }
+
+    SceneSnapshotHeader header = {};
+    header.magic = SCENE_SNAPSHOT_MAGIC;
+    header.version = SCENE_SNAPSHOT_VERSION;
+    header.typeCount = types.size();
+    header.entityCount = entities.size();
+    header.mainCamera = SCENE_SNAPSHOT_NO_ENTITY;
+
+    auto mainCamera = entityIndices.find(scene->m_mainCamera);
+    if (mainCamera != entityIndices.end())
+    {
+        header.mainCamera = mainCamera->second;
+    }
+
+    outData.clear();
+    outData.reserve(sizeof(SceneSnapshotHeader) + entities.size() * 16 + records.size());
+
+    SnapshotWriter headerWriter(outData, &entityIndices, scene.get(), nullptr);
+    headerWriter.Write(header);
+    for (const ComponentSerializer* type : types)
+    {
+        headerWriter.WriteString(type->name);
+    }
+
+    for (const Entity& entity : entities)
+    {
+        uint32_t parent = SCENE_SNAPSHOT_NO_ENTITY;
+        if (!entity.IsRoot())
+        {
+            parent = entityIndices[scene->m_index.ReadComponent<HierarchyComponent>(entity.m_id)->parent];
+        }
+
+        headerWriter.Write(parent);
+        headerWriter.WriteString(scene->m_index.ReadComponent<BaseComponent>(entity.m_id)->name);
+    }
+
+    outData.insert(outData.end(), records.begin(), records.end());
+
+    return true;
+}
+
+ScenePtr SceneSerializer::Load(const SceneSnapshot& snapshot)
+{
+    return Load(snapshot.data.data(), snapshot.data.size());
+}
+
+ScenePtr SceneSerializer::Load(const std::string& path)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        LOG_ERROR("Could not open the scene snapshot %s", path.c_str());
+        return nullptr;
+    }
+
+    return Load(file.GetData(), file.GetSize());
+}
+
+ScenePtr SceneSerializer::Load(const uint8_t* data, const size_t& size)
+{
+    std::vector<Entity> entities;
+    SnapshotReader reader(data, size, entities);
+
+    SceneSnapshotHeader header = reader.Read<SceneSnapshotHeader>();
+    if (reader.HasFailed() || header.magic != SCENE_SNAPSHOT_MAGIC || header.version != SCENE_SNAPSHOT_VERSION)
+    {
+        LOG_ERROR("Invalid scene snapshot.");
+        return nullptr;
+    }
+
+    // Types missing from this build are skipped
+    std::vector<const ComponentSerializer*> types;
+    for (uint32_t i = 0 ; i < header.typeCount && !reader.HasFailed() ; ++i)
+    {
+        std::string name = reader.ReadString();
+        auto type = s_serializerTypes.find(name);
+        if (type == s_serializerTypes.end())
+        {
+            LOG_WARNING("Unknown component type %s in scene snapshot.", name.c_str());
+            types.push_back(nullptr);
+            continue;
+        }
+
+        types.push_back(&s_serializers[type->second]);
+    }
+
+    // Every entity takes at least 8 bytes, this also rejects corrupted counts before reserving them
+    if (header.entityCount == 0 || header.entityCount > (size - reader.m_offset) / 8)
+    {
+        LOG_ERROR("Invalid scene snapshot.");
+        return nullptr;
+    }
+
+    ScenePtr scene = Scene::Create();
+    entities.reserve(header.entityCount);
+    entities.push_back(scene->GetRootEntity());
+    reader.Read<uint32_t>();
+    reader.ReadString();
+
+    for (uint32_t i = 1 ; i < header.entityCount && !reader.HasFailed() ; ++i)
+    {
+        uint32_t parent = reader.Read<uint32_t>();
+        std::string name = reader.ReadString();
+        if (parent >= i)
+        {
+            reader.m_failed = true;
+            break;
+        }
+
+        entities.push_back(scene->CreateEntity(name, entities[parent]));
+    }
+
+    // Components read first, shared with the entities refering to them
+    std::vector<std::shared_ptr<std::any>> records;
+    for (const Entity& entity : entities)
+    {
+        uint32_t count = reader.Read<uint32_t>();
+        for (uint32_t i = 0 ; i < count && !reader.HasFailed() ; ++i)
+        {
+            uint32_t type = reader.Read<uint32_t>();
+            uint32_t recordSize = reader.Read<uint32_t>();
+            if (!reader.Check(recordSize))
+            {
+                break;
+            }
+
+            SnapshotReader record(data + reader.m_offset, recordSize, entities);
+            reader.m_offset += recordSize;
+
+            if (type == SCENE_SNAPSHOT_SHARED)
+            {
+                uint32_t index = record.Read<uint32_t>();
+                if (index < records.size() && records[index])
+                {
+                    scene->m_index.GetData(entity.m_id).push_back({records[index], true});
+                }
+                continue;
+            }
+
+            if (type >= types.size() || !types[type])
+            {
+                records.push_back(nullptr);
+                continue;
+            }
+
+            size_t componentCount = scene->m_index.GetData(entity.m_id).size();
+            types[type]->read(entity, record);
+            if (record.HasFailed())
+            {
+                LOG_WARNING("Truncated %s component in scene snapshot.", types[type]->name.c_str());
+            }
+
+            const EntityData& components = scene->m_index.GetData(entity.m_id);
+            records.push_back(components.size() > componentCount ? components.back().data : nullptr);
+        }
+    }
+
+    if (reader.HasFailed() || entities.size() != header.entityCount)
+    {
+        LOG_ERROR("Invalid scene snapshot.");
+        return nullptr;
+    }
+
+    if (header.mainCamera < entities.size())
+    {
+        scene->SetMainCamera(entities[header.mainCamera]);
+    }
+
+    return scene;
+}
+
+void SceneSerializer::SaveScripts(const Entity& entity, std::vector<uint8_t>& outData)
+{
+    outData.clear();
+
+    // Each record is the name of its type followed by its size, the way the snapshots store them
+    SnapshotWriter writer(outData, nullptr, entity.m_scene, nullptr);
+    for (const ComponentSlot& slot : entity.m_scene->m_index.GetData(entity.m_id))
+    {
+        auto serializer = s_serializers.find(std::type_index(slot.data->type()));
+        if (slot.isShareable || serializer == s_serializers.end())
+        {
+            continue;
+        }
+
+        writer.WriteString(serializer->second.name);
+        size_t sizeOffset = outData.size();
+        writer.Write<uint32_t>(0);
+
+        serializer->second.write(*slot.data, writer);
+        uint32_t size = outData.size() - sizeOffset - sizeof(uint32_t);
+        std::memcpy(outData.data() + sizeOffset, &size, sizeof(uint32_t));
+    }
+}
+
+void SceneSerializer::LoadScripts(const Entity& entity, const std::vector<uint8_t>& data)
+{
+    SnapshotReader reader(data.data(), data.size(), entity.m_scene);
+    while (reader.m_offset < data.size() && !reader.HasFailed())
+    {
+        std::string name = reader.ReadString();
+        uint32_t recordSize = reader.Read<uint32_t>();
+        if (!reader.Check(recordSize))
+        {
+            break;
+        }
+
+        SnapshotReader record(data.data() + reader.m_offset, recordSize, entity.m_scene);
+        reader.m_offset += recordSize;
+
+        auto type = s_serializerTypes.find(name);
+        if (type == s_serializerTypes.end())
+        {
+            LOG_WARNING("Unknown script %s, it could not be restored.", name.c_str());
+            continue;
+        }
+
+        s_serializers[type->second].read(entity, record);
+    }
+}
@@ -0,0 +1,237 @@
+#ifndef SCENESERIALIZER_H
+#define SCENESERIALIZER_H
+
+#include "Scene.h"
+#include "Entity.h"
+
+#include "Core/Logging.h"
+
+#include "Resources/Manager.h"
+
+#include <any>
+#include <cstring>
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+
+// Layout of the scene snapshots. Entities are stored in traversal order, parents before their children,
+// so that the hierarchy is rebuilt by creating them in the same order. Their components follow, each record
+// starting with the index of its type in the type table and its size so that the types unknown to the
+// loader can be skipped. Components shared between entities (prefab instances) are stored once, the next
+// entities only refer to the first record. Entities are referenced by index and resources by identifier.
+
+#define SCENE_SNAPSHOT_MAGIC 0x43534d44  // "DMSC"
+#define SCENE_SNAPSHOT_VERSION 1
+
+// Entity index of the null entity, and parent of the root
+#define SCENE_SNAPSHOT_NO_ENTITY 0xffffffff
+// Type of the records refering to a component stored earlier
+#define SCENE_SNAPSHOT_SHARED 0xffffffff
+
+
+struct SceneSnapshotHeader
+{
+    uint32_t magic;
+    uint32_t version;
+
+    uint32_t typeCount;
+    uint32_t entityCount;
+    uint32_t mainCamera;
+    uint32_t padding;
+};
+
+
+// Snapshot kept in memory
+struct SceneSnapshot
+{
+    std::vector<uint8_t> data;
+    // Handles on the resources referenced by the snapshot, so that they are not evicted while it is kept
+    std::vector<std::any> resources;
+
+    inline bool IsEmpty() const { return data.empty(); }
+};
+
+
+class SnapshotWriter
+{
+public:
+    template <typename T>
+    void Write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain data can be written as is");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void WriteString(const std::string& string);
+    void WriteEntity(const Entity& entity);
+
+    template <typename T>
+    void WriteResource(const ResourceHandle<T>& handle)
+    {
+        WriteString(handle.GetIdentifier());
+        if (m_resources && (handle || handle.IsPending()))
+        {
+            m_resources->push_back(handle);
+        }
+    }
+
+private:
+    // Without entity indices, the entities are written by id
+    SnapshotWriter(std::vector<uint8_t>& data,
+                   const std::unordered_map<uint32_t, uint32_t>* entityIndices,
+                   const Scene* scene,
+                   std::vector<std::any>* resources) :
+            m_data(data),
+            m_entityIndices(entityIndices),
+            m_scene(scene),
+            m_resources(resources) {}
+
+    std::vector<uint8_t>& m_data;
+    const std::unordered_map<uint32_t, uint32_t>* m_entityIndices;
+    const Scene* m_scene;
+    std::vector<std::any>* m_resources;
+
+    friend class SceneSerializer;
+};
+
+
+// Reads in place from the snapshot bytes. Reading past the end of a record marks the reader as failed
+// and returns default values from then on.
+class SnapshotReader
+{
+public:
+    template <typename T>
+    T Read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain data can be read as is");
+        T value{};
+        if (Check(sizeof(T)))
+        {
+            std::memcpy(&value, m_data + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+        }
+
+        return value;
+    }
+
+    std::string ReadString();
+    Entity ReadEntity();
+
+    template <typename T>
+    ResourceHandle<T> ReadResource()
+    {
+        std::string identifier = ReadString();
+        if (identifier.empty())
+        {
+            return ResourceHandle<T>();
+        }
+
+        ResourceHandle<T> handle = ResourceManager::GetResource<T>(identifier);
+        if (!handle && !handle.IsPending())
+        {
+            LOG_WARNING("Snapshot resource %s is not loaded.", identifier.c_str());
+        }
+
+        return handle;
+    }
+
+    inline bool HasFailed() const { return m_failed; }
+
+private:
+    SnapshotReader(const uint8_t* data, const size_t& size, const std::vector<Entity>& entities) :
+            m_data(data),
+            m_size(size),
+            m_entities(&entities) {}
+    // Reads the entities written by id, from the given scene
+    SnapshotReader(const uint8_t* data, const size_t& size, Scene* scene) :
+            m_data(data),
+            m_size(size),
+            m_scene(scene) {}
+
+    bool Check(const size_t& size);
+
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+    bool m_failed = false;
+    const std::vector<Entity>* m_entities = nullptr;
+    Scene* m_scene = nullptr;
+
+    friend class SceneSerializer;
+};
+
+
+// Writes scenes to binary snapshots and builds new scenes from them. Components are only saved if their type
+// has been registered, the others are left out. The hierarchy and the names of the entities are always saved.
+class SceneSerializer
+{
+public:
+    // Registers the components of the engine
+    static void Init();
+
+    // The read function emplaces the component on the entity, scripts need it to be created first
+    template <typename ComponentType>
+    static void Register(const std::string& name,
+                         const std::function<void(const ComponentType&, SnapshotWriter&)>& write,
+                         const std::function<void(const Entity&, SnapshotReader&)>& read)
+    {
+        ComponentSerializer serializer;
+        serializer.name = name;
+        serializer.write = [write](const std::any& component, SnapshotWriter& writer)
+        {
+            write(std::any_cast<const ComponentType&>(component), writer);
+        };
+        serializer.read = read;
+
+        s_serializers[std::type_index(typeid(ComponentType))] = serializer;
+        s_serializerTypes.insert_or_assign(name, std::type_index(typeid(ComponentType)));
+    }
+
+    // Components made of plain data, saved as they are in memory
+    template <typename ComponentType>
+    static void RegisterTrivial(const std::string& name)
+    {
+        Register<ComponentType>(name,
+            [](const ComponentType& component, SnapshotWriter& writer) { writer.Write(component); },
+            [](const Entity& entity, SnapshotReader& reader) { entity.EmplaceComponent<ComponentType>(reader.Read<ComponentType>()); });
+    }
+
+    static bool Save(const ScenePtr& scene, SceneSnapshot& outSnapshot);
+    static bool Save(const ScenePtr& scene, const std::string& path);
+
+    // Returns nullptr if the snapshot is invalid. Resources are looked up by identifier, they must be loaded.
+    static ScenePtr Load(const SceneSnapshot& snapshot);
+    // Large snapshots are memory mapped, they are read without being copied
+    static ScenePtr Load(const std::string& path);
+    static ScenePtr Load(const uint8_t* data, const size_t& size);
+
+    // Scripts of a single entity, the components that can't be shared. The other entities are referred to by id,
+    // the scripts can only be loaded back on the same entity of the same scene (see Scene::RemoveEntity).
+    static void SaveScripts(const Entity& entity, std::vector<uint8_t>& outData);
+    static void LoadScripts(const Entity& entity, const std::vector<uint8_t>& data);
+
+private:
+    typedef std::function<void(const std::any&, SnapshotWriter&)> WriteFn;
+    typedef std::function<void(const Entity&, SnapshotReader&)> ReadFn;
+
+    struct ComponentSerializer
+    {
+        std::string name;
+        WriteFn write;
+        ReadFn read;
+    };
+
+    static bool Save(const ScenePtr& scene, std::vector<uint8_t>& outData, std::vector<std::any>* outResources);
+
+    static std::unordered_map<std::type_index, ComponentSerializer> s_serializers;
+    static std::unordered_map<std::string, std::type_index> s_serializerTypes;
+};
+
+
+#endif // SCENESERIALIZER_H
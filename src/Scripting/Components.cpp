@@ -29,6 +29,14 @@ Scripted::~Scripted()
     Scripting::Engine::Get().Deregister(this);
 }
 
+void Scripted::Rebind(const Entity& entity)
+{
+    Scripting::Engine& engine = Scripting::Engine::Get();
+    engine.Deregister(this);
+    m_entity = entity;
+    engine.Register(this);
+}
+
 
 // == Scriptable ==
 
@@ -35,6 +35,8 @@ public:
 
     inline Entity GetEntity() const { return m_entity; };
     inline void SetEntity(const Entity& entity) { m_entity = entity; };
+    // Attaches a copied script to the entity it has been copied to, registering it again
+    virtual void Rebind(const Entity& entity);
 
 private:
     std::string m_name;
@@ -66,6 +68,12 @@ public:
         return std::any_cast<DataType&>(m_dataBlock);
     }
 
+    template <typename DataType>
+    const DataType& GetDataBlock() const
+    {
+        return std::any_cast<const DataType&>(m_dataBlock);
+    }
+
 private:
     std::any m_dataBlock;
 
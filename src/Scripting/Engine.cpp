@@ -3,7 +3,6 @@
 #include "Trigger.h"
 #include "Scene/Components/Basics.h"
 
-#include "Core/Application.h"
 #include "Core/Logging.h"
 
 #include <algorithm>
@@ -23,7 +22,7 @@ Engine& Engine::Init()
 void Engine::Register(Components::Scripted* script)
 {
     Entity entity = script->GetEntity();
-    if (entity.GetScene() != Application::Get().GetMainScene().get())
+    if (entity.GetScene() != m_activeScene)
     {
         return;
     }
@@ -43,6 +42,11 @@ void Engine::Register(Components::Scripted* script)
 void Engine::Deregister(Components::Scripted* script)
 {
     Entity entity = script->GetEntity();
+    if (entity.GetScene() != m_activeScene)
+    {
+        return;
+    }
+
     auto it = m_scripts.find(entity);
     if (it == m_scripts.end())
     {
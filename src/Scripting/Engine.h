@@ -5,6 +5,7 @@
 
 #include "Game/GameEvents.h"
 
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 
@@ -18,7 +19,11 @@ public:
     static Engine& Init();
     inline static Engine& Get() { return *s_instance; }
 
-    // TODO: Prevent Scripts that do not belong to the active scene from beeing added to the Engine
+    // Scene being played, the scripts of the other scenes (floors built in the background, on the job system)
+    // are neither registered nor deregistered
+    inline void SetActiveScene(const Scene* scene) { m_activeScene = scene; }
+    inline const Scene* GetActiveScene() const { return m_activeScene; }
+
     void Register(Components::Scripted* script);
     void Deregister(Components::Scripted* script);
 
@@ -32,6 +37,7 @@ private:
     ~Engine() = default;
 
     std::unordered_map<Entity, std::vector<Components::Scripted*>> m_scripts;
+    std::atomic<const Scene*> m_activeScene{nullptr};
 
     static Engine* s_instance;
 };
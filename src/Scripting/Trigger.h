@@ -18,8 +18,9 @@ public:
 
     void OnUpdate() override;
 
-    inline Entity GetTarget() { return m_target; }
+    inline Entity GetTarget() const { return m_target; }
     inline void SetTarget(const Entity& target) { m_target = target; }
+    inline float GetRadius() const { return m_radius; }
 
 private:
     Entity m_target;
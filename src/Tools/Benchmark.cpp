@@ -0,0 +1,329 @@
+#include "Benchmark.h"
+
+#include "Core/Logging.h"
+#include "Core/Time.h"
+
+#include "Utils/FileUtils.h"
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+
+namespace Benchmark {
+
+
+// Runs are stopped growing past this count, whatever their duration
+static const uint64_t s_maxIterations = 1000000000;
+
+
+// == State ==
+
+State::State(const std::vector<int64_t>& args, const uint64_t& maxIterations) :
+        m_args(args),
+        m_maxIterations(maxIterations)
+{
+
+}
+
+bool State::KeepRunning()
+{
+    if (!m_started)
+    {
+        m_started = true;
+        if (m_error.empty())
+        {
+            ResumeTiming();
+        }
+    }
+
+    if (!m_error.empty())
+    {
+        return false;
+    }
+
+    if (m_iterations < m_maxIterations)
+    {
+        m_iterations++;
+        return true;
+    }
+
+    PauseTiming();
+    return false;
+}
+
+void State::PauseTiming()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    m_realTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_realStart).count();
+    m_cpuTime += (double)(std::clock() - m_cpuStart) / CLOCKS_PER_SEC;
+    m_running = false;
+}
+
+void State::ResumeTiming()
+{
+    if (m_running)
+    {
+        return;
+    }
+
+    m_running = true;
+    m_cpuStart = std::clock();
+    m_realStart = std::chrono::steady_clock::now();
+}
+
+void State::SkipWithError(const std::string& error)
+{
+    PauseTiming();
+    m_error = error;
+}
+
+void State::SkipWithMessage(const std::string& message)
+{
+    SkipWithError(message);
+    m_skipped = true;
+}
+
+void State::SetDeltaTime(const double& deltaTime)
+{
+    Time::SetDeltaTime(deltaTime);
+}
+
+
+// == Runner ==
+
+std::vector<Runner::Entry> Runner::s_entries;
+
+
+void Runner::Register(const std::string& name, const BenchmarkFn& function, const std::vector<std::vector<int64_t>>& argSets)
+{
+    for (const auto& args : argSets)
+    {
+        std::string fullName = name;
+        for (const int64_t& arg : args)
+        {
+            fullName += "/" + std::to_string(arg);
+        }
+
+        s_entries.push_back({fullName, function, args});
+    }
+}
+
+Runner::Result Runner::RunEntry(const Entry& entry, const double& minTime)
+{
+    Result result;
+    result.name = entry.name;
+
+    // The whole benchmark, setup included, is run again with more iterations until it lasts long enough
+    uint64_t iterations = 1;
+    while (true)
+    {
+        State state(entry.args, iterations);
+        entry.function(state);
+
+        if (state.m_error.empty() && state.m_iterations != iterations)
+        {
+            state.m_error = "The benchmark did not run its timed loop until the end.";
+        }
+
+        if (!state.m_error.empty())
+        {
+            result.error = state.m_error;
+            result.skipped = state.m_skipped;
+            return result;
+        }
+
+        if (state.m_realTime >= minTime || iterations >= s_maxIterations)
+        {
+            result.iterations = iterations;
+            result.realTime = state.m_realTime * 1e9 / iterations;
+            result.cpuTime = state.m_cpuTime * 1e9 / iterations;
+            if (state.m_realTime > 0.0)
+            {
+                result.itemsPerSecond = state.m_itemsPerIteration * iterations / state.m_realTime;
+                result.bytesPerSecond = state.m_bytesPerIteration * iterations / state.m_realTime;
+            }
+            return result;
+        }
+
+        // Aiming a bit above the minimum time, growing at most tenfold from one run to the next
+        double factor = state.m_realTime > 0.0 ? minTime * 1.4 / state.m_realTime : 10.0;
+        factor = std::clamp(factor, 2.0, 10.0);
+        iterations = std::min(s_maxIterations, (uint64_t)(iterations * factor));
+    }
+}
+
+bool Runner::WriteJson(const std::vector<Result>& results, const std::string& executable, const std::string& path)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+    char date[64] = {};
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+
+    writer.StartObject();
+    writer.Key("context");
+    writer.StartObject();
+    writer.Key("date");
+    writer.String(date);
+    writer.Key("executable");
+    writer.String(executable.c_str());
+    writer.Key("num_cpus");
+    writer.Uint(std::thread::hardware_concurrency());
+    writer.Key("library_build_type");
+#ifdef NDEBUG
+    writer.String("release");
+#else
+    writer.String("debug");
+#endif
+    writer.EndObject();
+
+    writer.Key("benchmarks");
+    writer.StartArray();
+    for (const Result& result : results)
+    {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(result.name.c_str());
+        writer.Key("run_name");
+        writer.String(result.name.c_str());
+        writer.Key("run_type");
+        writer.String("iteration");
+
+        if (!result.error.empty())
+        {
+            writer.Key("error_occurred");
+            writer.Bool(!result.skipped);
+            writer.Key("error_message");
+            writer.String(result.error.c_str());
+            writer.EndObject();
+            continue;
+        }
+
+        writer.Key("iterations");
+        writer.Uint64(result.iterations);
+        writer.Key("real_time");
+        writer.Double(result.realTime);
+        writer.Key("cpu_time");
+        writer.Double(result.cpuTime);
+        writer.Key("time_unit");
+        writer.String("ns");
+        if (result.itemsPerSecond > 0.0)
+        {
+            writer.Key("items_per_second");
+            writer.Double(result.itemsPerSecond);
+        }
+        if (result.bytesPerSecond > 0.0)
+        {
+            writer.Key("bytes_per_second");
+            writer.Double(result.bytesPerSecond);
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    if (!WriteFile(path, buffer.GetString(), buffer.GetSize()))
+    {
+        LOG_ERROR("Could not write the benchmark results to %s", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+int Runner::Run(int argc, char* argv[])
+{
+    std::string filter;
+    std::string outPath;
+    double minTime = 0.5;
+    bool list = false;
+
+    for (int i = 1 ; i < argc ; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "--list")
+        {
+            list = true;
+        }
+        else if ((option == "--filter" || option == "--min-time" || option == "--out") && i + 1 < argc)
+        {
+            std::string value = argv[++i];
+            if (option == "--filter")
+                filter = value;
+            else if (option == "--out")
+                outPath = value;
+            else
+                minTime = std::strtod(value.c_str(), nullptr);
+        }
+        else
+        {
+            LOG_ERROR("Unknown argument %s, usage: %s [--filter <substring>] [--min-time <seconds>] [--out <file.json>] [--list]",
+                      argv[i], argv[0]);
+            return 1;
+        }
+    }
+
+    if (!list)
+    {
+        printf("%-48s %17s %17s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+    }
+
+    std::vector<Result> results;
+    int failures = 0;
+    for (const Entry& entry : s_entries)
+    {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        if (list)
+        {
+            printf("%s\n", entry.name.c_str());
+            continue;
+        }
+
+        Result result = RunEntry(entry, minTime);
+        if (result.skipped)
+        {
+            printf("%-48s SKIPPED: %s\n", result.name.c_str(), result.error.c_str());
+        }
+        else if (!result.error.empty())
+        {
+            printf("%-48s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+            failures++;
+        }
+        else
+        {
+            printf("%-48s %14.0f ns %14.0f ns %12llu", result.name.c_str(), result.realTime, result.cpuTime,
+                   (unsigned long long)result.iterations);
+            if (result.itemsPerSecond > 0.0)
+            {
+                printf("  %10.4g items/s", result.itemsPerSecond);
+            }
+            printf("\n");
+        }
+        fflush(stdout);
+
+        results.push_back(result);
+    }
+
+    if (!outPath.empty() && !list && !WriteJson(results, argv[0], outPath))
+    {
+        return 1;
+    }
+
+    return failures ? 1 : 0;
+}
+
+
+} // Namespace Benchmark
@@ -0,0 +1,112 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace Benchmark {
+
+
+// Timed loop of a benchmark. Everything before the loop is setup and is not measured, neither is what runs
+// between PauseTiming() and ResumeTiming().
+//     while (state.KeepRunning()) { ... }
+class State
+{
+public:
+    // Returns true until the iteration count of the run has been reached
+    bool KeepRunning();
+
+    void PauseTiming();
+    void ResumeTiming();
+
+    inline int64_t GetArg(const size_t& index=0) const { return m_args[index]; }
+    inline uint64_t GetIterations() const { return m_iterations; }
+
+    // Elements or bytes handled by each iteration, reported as rates
+    inline void SetItemsProcessed(const uint64_t& items) { m_itemsPerIteration = items; }
+    inline void SetBytesProcessed(const uint64_t& bytes) { m_bytesPerIteration = bytes; }
+
+    // Stops the benchmark and reports it as failed, KeepRunning() returns false afterwards
+    void SkipWithError(const std::string& error);
+    // Stops the benchmark without failing it, when something it needs is not available
+    void SkipWithMessage(const std::string& message);
+
+    // Duration of the simulation steps run by the benchmark (see Time)
+    static void SetDeltaTime(const double& deltaTime);
+
+private:
+    State(const std::vector<int64_t>& args, const uint64_t& maxIterations);
+
+    std::vector<int64_t> m_args;
+    uint64_t m_maxIterations;
+    uint64_t m_iterations = 0;
+    bool m_started = false;
+    bool m_running = false;
+
+    std::chrono::steady_clock::time_point m_realStart;
+    std::clock_t m_cpuStart = 0;
+    double m_realTime = 0.0;
+    double m_cpuTime = 0.0;
+
+    uint64_t m_itemsPerIteration = 0;
+    uint64_t m_bytesPerIteration = 0;
+    std::string m_error;
+    bool m_skipped = false;
+
+    friend class Runner;
+};
+
+typedef std::function<void(State& state)> BenchmarkFn;
+
+
+// Runs the registered benchmarks, each one as many times as needed for its timed loop to last at least the
+// minimum time, and reports the time per iteration. The results can be written as JSON in the layout of
+// Google Benchmark so that the usual comparison scripts can read them.
+// Options: [--filter <substring>] [--min-time <seconds>] [--out <file.json>] [--list]
+class Runner
+{
+public:
+    // Registers the benchmark once per set of arguments, named "name/arg0/arg1..."
+    static void Register(const std::string& name, const BenchmarkFn& function, const std::vector<std::vector<int64_t>>& argSets={{}});
+
+    // Returns the exit code of the program
+    static int Run(int argc, char* argv[]);
+
+private:
+    struct Entry
+    {
+        std::string name;
+        BenchmarkFn function;
+        std::vector<int64_t> args;
+    };
+
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations = 0;
+        // Per iteration, in nanoseconds
+        double realTime = 0.0;
+        double cpuTime = 0.0;
+        double itemsPerSecond = 0.0;
+        double bytesPerSecond = 0.0;
+        std::string error;
+        // The error is only a message, the benchmark did not fail
+        bool skipped = false;
+    };
+
+    static Result RunEntry(const Entry& entry, const double& minTime);
+    static bool WriteJson(const std::vector<Result>& results, const std::string& executable, const std::string& path);
+
+    static std::vector<Entry> s_entries;
+};
+
+
+} // Namespace Benchmark
+
+
+#endif // BENCHMARK_H
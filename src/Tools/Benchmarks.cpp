@@ -0,0 +1,766 @@
+#include "Benchmark.h"
+
+#include "Core/Image.h"
+#include "Core/JobSystem.h"
+#include "Core/Logging.h"
+#include "Core/Memory.h"
+
+#include "Navigation/CellGrid.h"
+#include "Game/Components.h"
+#include "Game/GameManager.h"
+
+#include "Navigation/Components.h"
+#include "Navigation/Engine.h"
+
+#include "Renderer/GpuResourcePool.h"
+
+#include "Resources/Cookers/LevelCooker.h"
+
+#include "Scene/ChangeJournal.h"
+#include "Scene/Entity.h"
+#include "Scene/Scene.h"
+#include "Scene/SceneSerializer.h"
+#include "Scene/Components/Basics.h"
+
+#include "Scripting/Engine.h"
+#include "Scripting/Trigger.h"
+
+#include "Utils/FileUtils.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// Benchmarks of the engine systems on generated content: scenes of N entities, maze maps and levels with
+// a given amount of monsters and rewards. Nothing is rendered, the benchmarks run without window nor GL context,
+// except for the renderer ones which open a hidden window and are skipped when no GL context can be created.
+// Usage: DungeonMasterBenchmarks [--filter <substring>] [--min-time <seconds>] [--out <file.json>] [--list]
+
+// Generated content is the same from a run to another
+static const uint32_t s_seed = 42;
+// Duration of the simulation steps of the level benchmarks
+static const double s_fixedTimestep = 1.0 / 60.0;
+
+static const uint8_t s_wallColor[] = {0, 0, 0};
+static const uint8_t s_floorColor[] = {255, 255, 255};
+
+
+// == Generators ==
+
+static std::string GetTemporaryPath(const std::string& fileName)
+{
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::temp_directory_path(error) / "DungeonMasterBenchmarks";
+    std::filesystem::create_directories(directory, error);
+
+    return (directory / fileName).string();
+}
+
+// Scene of entityCount entities holding a Transform, a quarter of them being children of the others
+static ScenePtr GenerateScene(const uint32_t& entityCount)
+{
+    ScenePtr scene = Scene::Create();
+
+    std::vector<Entity> parents;
+    parents.reserve(entityCount);
+    for (uint32_t i = 0 ; i < entityCount ; ++i)
+    {
+        Entity entity = (i % 4 == 3) ? parents[i / 2].AddChild("Child") : scene->CreateEntity("Entity");
+        entity.EmplaceComponent<Components::Transform>(glm::translate(glm::mat4(1.0f), glm::vec3(i, 0.0f, 0.0f)));
+        parents.push_back(entity);
+    }
+
+    return scene;
+}
+
+// Maze of size x size pixels carved by a randomized depth first search, size should be odd. Some walls are
+// knocked down afterwards so that there are several paths between two cells.
+static ImagePtr GenerateMaze(const uint32_t& size, const uint32_t& seed)
+{
+    ImagePtr image = Image::Create(size, size, 3, ImageComponentType::UInt8);
+    uint8_t* pixels = static_cast<uint8_t*>(image->GetData());
+
+    std::vector<bool> floor((size_t)size * size, false);
+    std::minstd_rand generator(seed);
+
+    std::vector<glm::ivec2> stack = {{1, 1}};
+    floor[(size_t)size + 1] = true;
+    while (!stack.empty())
+    {
+        glm::ivec2 cell = stack.back();
+
+        glm::ivec2 candidates[4];
+        uint32_t candidateCount = 0;
+        for (const glm::ivec2& direction : {glm::ivec2(2, 0), glm::ivec2(-2, 0), glm::ivec2(0, 2), glm::ivec2(0, -2)})
+        {
+            glm::ivec2 next = cell + direction;
+            if (next.x > 0 && next.y > 0 && next.x < (int)size - 1 && next.y < (int)size - 1 &&
+                !floor[(size_t)next.y * size + next.x])
+            {
+                candidates[candidateCount++] = next;
+            }
+        }
+
+        if (!candidateCount)
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        glm::ivec2 next = candidates[generator() % candidateCount];
+        glm::ivec2 wall = (cell + next) / 2;
+        floor[(size_t)wall.y * size + wall.x] = true;
+        floor[(size_t)next.y * size + next.x] = true;
+        stack.push_back(next);
+    }
+
+    for (uint32_t i = 0 ; i < size * size / 32 ; ++i)
+    {
+        uint32_t x = 1 + generator() % (size - 2);
+        uint32_t y = 1 + generator() % (size - 2);
+        floor[(size_t)y * size + x] = true;
+    }
+
+    for (size_t i = 0 ; i < floor.size() ; ++i)
+    {
+        std::copy_n(floor[i] ? s_floorColor : s_wallColor, 3, pixels + i * 3);
+    }
+
+    return image;
+}
+
+static bool WriteMaze(const Image& maze, const std::string& path)
+{
+    std::string header = "P6\n" + std::to_string(maze.GetWidth()) + " " + std::to_string(maze.GetHeight()) + "\n255\n";
+
+    std::vector<uint8_t> data(header.begin(), header.end());
+    const uint8_t* pixels = static_cast<const uint8_t*>(maze.GetData());
+    data.insert(data.end(), pixels, pixels + maze.GetDataSize());
+
+    return WriteFile(path, data.data(), data.size());
+}
+
+// Level description of a single floor, in the JSON layout read by LevelCooker
+static std::string GenerateLevelJson(const uint32_t& monsterCount, const uint32_t& rewardCount, const uint32_t& mapSize)
+{
+    std::minstd_rand generator(s_seed);
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    auto writeOrigin = [&]()
+    {
+        writer.Key("origin");
+        writer.StartArray();
+        writer.Uint(generator() % mapSize);
+        writer.Uint(generator() % mapSize);
+        writer.EndArray();
+    };
+
+    writer.StartObject();
+    writer.Key("name");
+    writer.String("Benchmark");
+    writer.Key("floors");
+    writer.StartArray();
+    writer.StartObject();
+    writer.Key("name");
+    writer.String("Floor");
+    writer.Key("map");
+    writer.String("Benchmark.ppm");
+
+    writer.Key("monsters");
+    writer.StartArray();
+    for (uint32_t i = 0 ; i < monsterCount ; ++i)
+    {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(("Monster " + std::to_string(i)).c_str());
+        writeOrigin();
+        writer.Key("model");
+        writer.String("Models/Slime.fbx");
+        writer.Key("health");
+        writer.Int(3);
+        writer.Key("strength");
+        writer.Double(1.0);
+        writer.Key("attackSpeed");
+        writer.Double(1.0);
+        writer.Key("speed");
+        writer.Double(1.5);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.Key("rewards");
+    writer.StartArray();
+    for (uint32_t i = 0 ; i < rewardCount ; ++i)
+    {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(("Reward " + std::to_string(i)).c_str());
+        writeOrigin();
+        writer.Key("model");
+        writer.String("Models/Potion.fbx");
+        writer.Key("type");
+        writer.String("heal");
+        writer.Key("healing");
+        writer.Double(5.0);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+    writer.EndArray();
+    writer.EndObject();
+
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+
+// Level played by the benchmarks: a maze with the player, monsters hunting it and heals to pick up.
+// Built the way LevelLoader does it, without the models.
+class SyntheticLevel
+{
+public:
+    SyntheticLevel(const uint32_t& mazeSize, const uint32_t& monsterCount, const uint32_t& rewardCount)
+    {
+        ImagePtr maze = GenerateMaze(mazeSize, s_seed);
+        m_grid = CellGrid::Create(*maze);
+        m_scene = Scene::Create();
+
+        Navigation::Engine& navEngine = Navigation::Engine::Get();
+        navEngine.SetNavMap(m_grid);
+        navEngine.SetActiveScene(m_scene.get());
+        Scripting::Engine::Get().SetActiveScene(m_scene.get());
+
+        std::vector<glm::vec2> floorCells;
+        for (uint32_t y = 0 ; y < m_grid->GetHeight() ; ++y)
+        {
+            for (uint32_t x = 0 ; x < m_grid->GetWidth() ; ++x)
+            {
+                if (m_grid->GetCell(x, y) == CellType::Floor)
+                {
+                    floorCells.push_back(glm::vec2(x, y));
+                }
+            }
+        }
+
+        std::minstd_rand generator(s_seed);
+        auto randomPosition = [&](const float& height)
+        {
+            glm::vec2 cell = floorCells[generator() % floorCells.size()];
+            return glm::translate(glm::mat4(1.0f), glm::vec3(cell.x, height, -cell.y));
+        };
+
+        // The player does not move, it can't die either
+        m_player = m_scene->CreateEntity("Player");
+        m_player.EmplaceComponent<Components::Transform>(randomPosition(0.5f));
+        m_player.EmplaceComponent<Components::CharacterData>(1e9f);
+        GameManager::Get().SetPlayer(m_player);
+
+        for (uint32_t i = 0 ; i < monsterCount ; ++i)
+        {
+            Entity monster = m_scene->CreateEntity("Monster");
+            monster.EmplaceComponent<Components::Transform>(randomPosition(0.0f));
+            monster.EmplaceComponent<Components::MonsterData>(m_player, 1.0f, 1.0f);
+            auto& navAgent = monster.EmplaceComponent<Components::NavAgent>(monster);
+            navAgent.GetAgent()->SetSpeed(1.5f);
+            monster.EmplaceComponent<Components::Scriptable>(Components::CreateMonsterLogic(monster));
+            monster.EmplaceComponent<Components::CharacterData>(3.0f);
+        }
+
+        for (uint32_t i = 0 ; i < rewardCount ; ++i)
+        {
+            Entity reward = m_scene->CreateEntity("Heal");
+            reward.EmplaceComponent<Components::Transform>(randomPosition(0.5f));
+            reward.EmplaceComponent<Components::Trigger>(reward, m_player, 0.2f);
+            reward.EmplaceComponent<Components::Scriptable>(Components::CreateHealLogic(reward));
+        }
+    }
+
+    ~SyntheticLevel()
+    {
+        Scripting::Engine& scriptEngine = Scripting::Engine::Get();
+        scriptEngine.Clear();
+        GameManager::Get().Clear();
+        m_scene.reset();
+        scriptEngine.SetActiveScene(nullptr);
+
+        Navigation::Engine& navEngine = Navigation::Engine::Get();
+        navEngine.SetActiveScene(nullptr);
+        navEngine.ClearNavMap();
+        Memory::GetLevelArena().Reset();
+    }
+
+    inline const ScenePtr& GetScene() const { return m_scene; }
+
+private:
+    CellGridPtr m_grid;
+    ScenePtr m_scene;
+    Entity m_player;
+};
+
+
+// == Scenes ==
+
+static void CreateEntities(Benchmark::State& state)
+{
+    const uint32_t entityCount = state.GetArg();
+    while (state.KeepRunning())
+    {
+        ScenePtr scene = GenerateScene(entityCount);
+
+        state.PauseTiming();
+        scene.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(entityCount);
+}
+
+static void TraverseEntities(Benchmark::State& state)
+{
+    const uint32_t entityCount = state.GetArg();
+    ScenePtr scene = GenerateScene(entityCount);
+
+    float sum = 0.0f;
+    while (state.KeepRunning())
+    {
+        for (Entity entity : scene->Traverse())
+        {
+            const Components::Transform* transform = entity.ReadComponent<Components::Transform>();
+            if (transform)
+            {
+                sum += transform->transform[3].x;
+            }
+        }
+    }
+    state.SetItemsProcessed(entityCount);
+
+    if (sum < 0.0f)
+    {
+        state.SkipWithError("Unexpected transforms.");
+    }
+}
+
+static void WriteComponents(Benchmark::State& state)
+{
+    const uint32_t entityCount = state.GetArg();
+    const bool journaled = state.GetArg(1);
+    ScenePtr scene = GenerateScene(entityCount);
+    if (journaled)
+    {
+        scene->EnableJournal(1 << 16);
+    }
+
+    while (state.KeepRunning())
+    {
+        for (Entity entity : scene->Traverse())
+        {
+            Components::Transform* transform = entity.FindComponent<Components::Transform>();
+            if (transform)
+            {
+                transform->transform[3].y += 1.0f;
+            }
+        }
+
+        if (journaled)
+        {
+            scene->GetJournal()->NextTick();
+        }
+    }
+    state.SetItemsProcessed(entityCount);
+}
+
+static void RollbackScene(Benchmark::State& state)
+{
+    const uint32_t entityCount = state.GetArg();
+    ScenePtr scene = GenerateScene(entityCount);
+    scene->EnableJournal(entityCount * 2);
+
+    while (state.KeepRunning())
+    {
+        state.PauseTiming();
+        uint64_t tick = scene->GetJournal()->GetCurrentTick();
+        for (Entity entity : scene->Traverse())
+        {
+            Components::Transform* transform = entity.FindComponent<Components::Transform>();
+            if (transform)
+            {
+                transform->transform[3].y += 1.0f;
+            }
+        }
+        scene->CreateEntity("Spawned").EmplaceComponent<Components::Transform>();
+        scene->GetJournal()->NextTick();
+        state.ResumeTiming();
+
+        if (!scene->Rollback(tick))
+        {
+            state.SkipWithError("Could not roll the scene back.");
+        }
+    }
+    state.SetItemsProcessed(entityCount);
+}
+
+static void CopyEntities(Benchmark::State& state)
+{
+    const uint32_t entityCount = state.GetArg();
+
+    // Prefab made of one root and its descendants, copied into another scene
+    ScenePtr prefab = Scene::Create();
+    Entity root = prefab->CreateEntity("Prefab");
+    root.EmplaceComponent<Components::Transform>();
+    std::vector<Entity> entities = {root};
+    for (uint32_t i = 1 ; i < entityCount ; ++i)
+    {
+        Entity entity = entities[i / 2].AddChild("Node");
+        entity.EmplaceComponent<Components::Transform>();
+        entities.push_back(entity);
+    }
+
+    ScenePtr scene = Scene::Create();
+    while (state.KeepRunning())
+    {
+        Entity copy = scene->CopyEntity(root, "Copy");
+
+        state.PauseTiming();
+        copy.Remove();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(entityCount);
+}
+
+static void SaveSnapshot(Benchmark::State& state)
+{
+    ScenePtr scene = GenerateScene(state.GetArg());
+
+    SceneSnapshot snapshot;
+    while (state.KeepRunning())
+    {
+        if (!SceneSerializer::Save(scene, snapshot))
+        {
+            state.SkipWithError("Could not save the scene.");
+        }
+    }
+    state.SetItemsProcessed(state.GetArg());
+    state.SetBytesProcessed(snapshot.data.size());
+}
+
+static void LoadSnapshot(Benchmark::State& state)
+{
+    SceneSnapshot snapshot;
+    SceneSerializer::Save(GenerateScene(state.GetArg()), snapshot);
+
+    while (state.KeepRunning())
+    {
+        ScenePtr scene = SceneSerializer::Load(snapshot);
+        if (!scene)
+        {
+            state.SkipWithError("Could not load the scene.");
+        }
+
+        state.PauseTiming();
+        scene.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.GetArg());
+    state.SetBytesProcessed(snapshot.data.size());
+}
+
+
+// == Navigation ==
+
+static void ClassifyMap(Benchmark::State& state)
+{
+    ImagePtr maze = GenerateMaze(state.GetArg(), s_seed);
+
+    while (state.KeepRunning())
+    {
+        CellGridPtr grid = CellGrid::Create(*maze);
+    }
+    state.SetItemsProcessed((uint64_t)maze->GetWidth() * maze->GetHeight());
+    state.SetBytesProcessed(maze->GetDataSize());
+}
+
+static void FindPath(Benchmark::State& state)
+{
+    const int size = state.GetArg();
+    ImagePtr maze = GenerateMaze(size, s_seed);
+    CellGridPtr grid = CellGrid::Create(*maze);
+
+    Navigation::Engine& navEngine = Navigation::Engine::Get();
+    navEngine.SetNavMap(grid);
+
+    // Across the whole maze, the nav map rows go towards -y
+    glm::vec2 start(1, -1);
+    glm::vec2 end(size - 2, -(size - 2));
+    while (state.KeepRunning())
+    {
+        std::vector<glm::vec2> path = navEngine.FindPath(start, end);
+        if (path.empty())
+        {
+            state.SkipWithError("No path found across the maze.");
+        }
+        Memory::EndFrame();
+    }
+
+    navEngine.ClearNavMap();
+    Memory::GetLevelArena().Reset();
+}
+
+
+// == Levels ==
+
+static void SimulateLevel(Benchmark::State& state)
+{
+    SyntheticLevel level(state.GetArg(0), state.GetArg(1), state.GetArg(2));
+    Benchmark::State::SetDeltaTime(s_fixedTimestep);
+
+    Navigation::Engine& navEngine = Navigation::Engine::Get();
+    Scripting::Engine& scriptEngine = Scripting::Engine::Get();
+    while (state.KeepRunning())
+    {
+        navEngine.OnUpdate();
+        scriptEngine.OnUpdate();
+        Memory::EndFrame();
+    }
+    state.SetItemsProcessed(state.GetArg(1) + state.GetArg(2));
+}
+
+static void BuildLevel(Benchmark::State& state)
+{
+    while (state.KeepRunning())
+    {
+        auto level = std::make_unique<SyntheticLevel>(state.GetArg(0), state.GetArg(1), state.GetArg(2));
+
+        state.PauseTiming();
+        level.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.GetArg(1) + state.GetArg(2));
+}
+
+
+// == Resources ==
+
+static void ParseLevel(Benchmark::State& state)
+{
+    std::string json = GenerateLevelJson(state.GetArg(0), state.GetArg(1), 256);
+
+    while (state.KeepRunning())
+    {
+        LevelDescription description;
+        std::string error;
+        if (!LevelCooker::Parse(json, description, error))
+        {
+            state.SkipWithError(error);
+        }
+    }
+    state.SetBytesProcessed(json.size());
+}
+
+static void LoadCookedLevel(Benchmark::State& state)
+{
+    LevelDescription description;
+    std::string error;
+    std::string path = GetTemporaryPath("Benchmark.dmlvl");
+    if (!LevelCooker::Parse(GenerateLevelJson(state.GetArg(0), state.GetArg(1), 256), description, error) ||
+        !LevelCooker::Write(description, path))
+    {
+        state.SkipWithError("Could not cook the level.");
+    }
+
+    while (state.KeepRunning())
+    {
+        LevelDescription loaded;
+        if (!LevelCooker::Load(path, loaded))
+        {
+            state.SkipWithError("Could not load the cooked level.");
+        }
+    }
+    state.SetItemsProcessed(state.GetArg(0) + state.GetArg(1));
+}
+
+static void LoadMap(Benchmark::State& state)
+{
+    ImagePtr maze = GenerateMaze(state.GetArg(), s_seed);
+    std::string path = GetTemporaryPath("Benchmark.ppm");
+    if (!WriteMaze(*maze, path))
+    {
+        state.SkipWithError("Could not write the map.");
+    }
+
+    while (state.KeepRunning())
+    {
+        ImagePtr map = Image::Read(path);
+        if (!map)
+        {
+            state.SkipWithError("Could not read the map.");
+            break;
+        }
+        CellGridPtr grid = CellGrid::Create(*map);
+    }
+    state.SetBytesProcessed(maze->GetDataSize());
+}
+
+static void LoadSnapshotFile(Benchmark::State& state)
+{
+    std::string path = GetTemporaryPath("Benchmark.dmscene");
+    if (!SceneSerializer::Save(GenerateScene(state.GetArg()), path))
+    {
+        state.SkipWithError("Could not save the scene.");
+    }
+
+    while (state.KeepRunning())
+    {
+        ScenePtr scene = SceneSerializer::Load(path);
+        if (!scene)
+        {
+            state.SkipWithError("Could not load the scene.");
+        }
+
+        state.PauseTiming();
+        scene.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.GetArg());
+}
+
+
+// == Renderer ==
+
+// Hidden window holding the GL context of the renderer benchmarks, null if none can be created
+static GLFWwindow* GetContextWindow()
+{
+    static GLFWwindow* s_window = nullptr;
+    static bool s_initialized = false;
+    if (s_initialized)
+    {
+        return s_window;
+    }
+    s_initialized = true;
+
+    if (!glfwInit())
+    {
+        return nullptr;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    s_window = glfwCreateWindow(64, 64, "DungeonMasterBenchmarks", nullptr, nullptr);
+    if (!s_window)
+    {
+        return nullptr;
+    }
+
+    glfwMakeContextCurrent(s_window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        glfwDestroyWindow(s_window);
+        s_window = nullptr;
+    }
+
+    return s_window;
+}
+
+// Frames acquiring the transient objects of the renderer, once warmed up the pool must not allocate any GL object
+static void RecycleGpuResources(Benchmark::State& state)
+{
+    if (!GetContextWindow())
+    {
+        state.SkipWithMessage("No OpenGL context could be created, the GPU resource pool counters were not checked.");
+        return;
+    }
+
+    const uint32_t objectCount = state.GetArg();
+    GpuResourcePool pool;
+    FrameBufferSpecs specs;
+    specs.width = 256;
+    specs.height = 256;
+
+    // The objects of a frame are all held at once, as the passes of the render graph do
+    std::vector<VertexArrayPtr> vertexArrays;
+    std::vector<FrameBufferPtr> frameBuffers;
+    std::vector<TexturePtr> textures;
+    auto renderFrame = [&]()
+    {
+        pool.NextFrame();
+        for (uint32_t i = 0 ; i < objectCount ; ++i)
+        {
+            vertexArrays.push_back(pool.AcquireVertexArray());
+            frameBuffers.push_back(pool.AcquireFrameBuffer(specs));
+            textures.push_back(pool.AcquireTexture(specs.width, specs.height, GL_RGBA8));
+        }
+        vertexArrays.clear();
+        frameBuffers.clear();
+        textures.clear();
+    };
+
+    renderFrame();
+    if (pool.GetAllocationCount() != 3 * objectCount || pool.GetPooledCount() != 3 * objectCount)
+    {
+        state.SkipWithError("The first frame did not allocate one GL object per acquisition.");
+        return;
+    }
+
+    uint64_t steadyFrames = 0;
+    while (state.KeepRunning())
+    {
+        renderFrame();
+        steadyFrames += pool.GetFrameAllocationCount() == 0;
+    }
+
+    if (steadyFrames != state.GetIterations() || pool.GetAllocationCount() != 3 * objectCount)
+    {
+        state.SkipWithError("The GPU resource pool allocated GL objects once warmed up.");
+    }
+    state.SetItemsProcessed(3 * objectCount);
+}
+
+
+int main(int argc, char* argv[])
+{
+    // The engine systems the game runs on, without the Application: no window and no renderer
+    JobSystem::Init();
+    Scripting::Engine::Init();
+    Navigation::Engine::Init();
+    SceneSerializer::Init();
+    GameManager::Init();
+
+    using Benchmark::Runner;
+    Runner::Register("Scene/CreateEntities", CreateEntities, {{1000}, {10000}, {100000}});
+    Runner::Register("Scene/TraverseEntities", TraverseEntities, {{1000}, {10000}, {100000}});
+    Runner::Register("Scene/WriteComponents", WriteComponents, {{10000, 0}, {10000, 1}, {100000, 0}, {100000, 1}});
+    Runner::Register("Scene/Rollback", RollbackScene, {{1000}, {10000}});
+    Runner::Register("Scene/CopyEntity", CopyEntities, {{100}, {1000}, {10000}});
+    Runner::Register("Scene/SaveSnapshot", SaveSnapshot, {{1000}, {10000}, {100000}});
+    Runner::Register("Scene/LoadSnapshot", LoadSnapshot, {{1000}, {10000}, {100000}});
+
+    Runner::Register("Navigation/ClassifyMap", ClassifyMap, {{65}, {257}, {1025}, {4097}});
+    Runner::Register("Navigation/FindPath", FindPath, {{33}, {65}, {257}, {1025}});
+
+    // Maze size, monster count, reward count
+    Runner::Register("Level/Build", BuildLevel, {{65, 16, 16}, {257, 256, 256}});
+    Runner::Register("Level/Simulate", SimulateLevel, {{65, 16, 16}, {129, 64, 64}, {257, 256, 256}, {257, 1024, 256}});
+
+    // Monster count, reward count
+    Runner::Register("Resources/ParseLevel", ParseLevel, {{16, 16}, {1000, 1000}, {10000, 10000}});
+    Runner::Register("Resources/LoadCookedLevel", LoadCookedLevel, {{16, 16}, {1000, 1000}, {10000, 10000}});
+    Runner::Register("Resources/LoadMap", LoadMap, {{65}, {257}, {1025}});
+    Runner::Register("Resources/LoadSnapshotFile", LoadSnapshotFile, {{1000}, {10000}});
+
+    // Objects of each type acquired per frame
+    Runner::Register("Renderer/RecycleGpuResources", RecycleGpuResources, {{1}, {8}});
+
+    return Runner::Run(argc, argv);
+}
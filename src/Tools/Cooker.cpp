@@ -0,0 +1,77 @@
+#include "Core/Resolver.h"
+#include "Core/Logging.h"
+
+#include "Resources/Cookers/LevelCooker.h"
+#include "Resources/Cookers/ModelCooker.h"
+#include "Resources/Cookers/TextureCooker.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+// Cooks every texture, model and level of the resources ahead of time so that the game never has to do it on first use.
+// Usage: DungeonMasterCooker <root directory> [--no-compress] [--no-mips]
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        LOG_ERROR("Invalid arg count, usage: %s <root directory> [--no-compress] [--no-mips]", argv[0]);
+        return 1;
+    }
+
+    TextureCookSettings settings;
+    for (int i = 2 ; i < argc ; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--no-compress")
+            settings.compress = false;
+        else if (arg == "--no-mips")
+            settings.generateMips = false;
+        else
+        {
+            LOG_ERROR("Unknown argument %s", argv[i]);
+            return 1;
+        }
+    }
+
+    Resolver& resolver = Resolver::Init(std::filesystem::canonical(argv[1]));
+    std::string cachePath = resolver.GetCachePath();
+
+    int failures = 0;
+    auto cookDirectory = [&](const std::string& directory, const std::vector<std::string>& extensions, auto cook) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(resolver.Resolve(directory), error))
+        {
+            std::string extension = entry.path().extension().string();
+            if (!entry.is_regular_file() || std::find(extensions.begin(), extensions.end(), extension) == extensions.end())
+            {
+                continue;
+            }
+
+            if (cook(entry.path().string()).empty())
+            {
+                failures++;
+            }
+        }
+
+        if (error)
+        {
+            LOG_ERROR("Could not list the content of %s: %s", directory.c_str(), error.message().c_str());
+            failures++;
+        }
+    };
+
+    cookDirectory("Textures", {".png", ".jpg", ".jpeg", ".tga", ".bmp", ".hdr"}, [&](const std::string& path) {
+        return TextureCooker::Cook(path, cachePath, settings);
+    });
+    cookDirectory("Models", {".fbx", ".obj", ".gltf", ".glb"}, [&](const std::string& path) {
+        return ModelCooker::Cook(path, cachePath);
+    });
+    cookDirectory("Levels", {".json"}, [&](const std::string& path) {
+        return LevelCooker::Cook(path, cachePath);
+    });
+
+    return failures ? 1 : 0;
+}
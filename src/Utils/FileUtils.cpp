@@ -2,9 +2,13 @@
 
 #include <unistd.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <filesystem>
 
 
 bool ReadFile(const std::string& filePath, std::string& outContent)
@@ -26,3 +30,105 @@ bool ReadFile(const std::string& filePath, std::string& outContent)
     
     return true;
 }
+
+bool WriteFile(const std::string& filePath, const void* data, const size_t& size)
+{
+    std::error_code error;
+    std::filesystem::path path(filePath);
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    std::string tempPath = filePath + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(static_cast<const char*>(data), size))
+        {
+            fprintf(stderr, "ERROR: Could not write file %s\n", filePath.c_str());
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, filePath, error);
+    if (error)
+    {
+        fprintf(stderr, "ERROR: %s\nCould not write file %s\n", error.message().c_str(), filePath.c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+
+// MappedFile
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) :
+        m_data(other.m_data),
+        m_size(other.m_size)
+{
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this != &other)
+    {
+        Close();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    return *this;
+}
+
+bool MappedFile::Open(const std::string& filePath)
+{
+    Close();
+
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid once the file descriptor is closed
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = fileStat.st_size;
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
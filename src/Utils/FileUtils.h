@@ -1,10 +1,38 @@
 #ifndef FILEUTILS_H
 #define FILEUTILS_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
 
 
 bool ReadFile(const std::string& filePath, std::string& outContent);
 
+// Writes into a temporary file that is then renamed, so that readers never see a partially written file
+bool WriteFile(const std::string& filePath, const void* data, const size_t& size);
 
-#endif // FILEUTILS_H
\ No newline at end of file
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+
+    bool Open(const std::string& filePath);
+    void Close();
+
+    inline bool IsOpen() const { return m_data; }
+    inline const uint8_t* GetData() const { return m_data; }
+    inline size_t GetSize() const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+
+#endif // FILEUTILS_H
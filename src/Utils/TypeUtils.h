@@ -1,6 +1,8 @@
 #ifndef TYPEUTILS_H
 #define TYPEUTILS_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
 
 // From boost::hash_combine
@@ -11,5 +13,18 @@ void HashCombine(size_t& seed, const T& value)
   seed ^= hash(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
+// FNV-1a, used to key cached data by the content it was generated from
+inline uint64_t HashBytes(const void* data, const size_t& size, uint64_t seed=0xcbf29ce484222325ull)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0 ; i < size ; ++i)
+    {
+        seed ^= bytes[i];
+        seed *= 0x100000001b3ull;
+    }
+
+    return seed;
+}
+
 
 #endif // TYPEUTILS_H